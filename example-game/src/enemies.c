@@ -4,6 +4,8 @@
 #include <GFraMe/GFraMe.h>
 #include <GFraMe/GFraMe_animation.h>
 #include <GFraMe/GFraMe_audio.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_pool.h>
 #include <GFraMe/GFraMe_sprite.h>
 #include <GFraMe/GFraMe_util.h>
 #include <stdio.h>
@@ -21,18 +23,24 @@ static int bug03_anim_data[2] = {21, 22};
 static int beetle01_anim_data[2] = {24, 25};
 static int beetle02_anim_data[2] = {32, 33};
 
+struct enemy {
+	GFraMe_sprite spr;
+	/**
+	 * The enemy's animation (pointed by its sprite)
+	 */
+	GFraMe_animation anim;
+	/**
+	 * Count for how many frames an enemy should be stunned after hit
+	 */
+	int stop_frames;
+};
+
 /**
- * Array for every enemy (possibly) on the screen
- */
-GFraMe_sprite enemies[MAX_ENEMIES];
-/**
- * Array with on animation for each enemy
- */
-GFraMe_animation en_animation[MAX_ENEMIES];
-/**
- * Count for how many frames an enemy should be stunned after hit
+ * Pool with every enemy (possibly) on the screen; indexes used by the
+ * functions bellow are positions on its live list
  */
-int stop_frames[MAX_ENEMIES];
+GFraMe_pool enemies;
+static int enemies_did_init = 0;
 
 static void enemies_kill(int i);
 
@@ -59,46 +67,54 @@ void enemies_beetle_norm_init(GFraMe_sprite *en, GFraMe_animation *anim);
 	GFraMe_sprite_set_animation(spr, an)
 
 void enemies_init() {
-	int i = 0;
-	while (i < MAX_ENEMIES) {
-		enemies_kill(i);
-		i++;
+	GFraMe_ret rv;
+	
+	if (!enemies_did_init) {
+		// On failure, the pool is left empty (so no enemy ever spawns) and
+		// it's initialized again on the next call
+		rv = GFraMe_pool_init(&enemies, sizeof(struct enemy), MAX_ENEMIES);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init enemies", _ret);
+		enemies_did_init = 1;
 	}
+	else
+		GFraMe_pool_reset(&enemies);
+_ret:
+	return;
 }
 
 void enemies_update(int ms) {
 	int i;
 	i = 0;
-	while (i < MAX_ENEMIES) {
-		if (enemies[i].id == 0 && enemies[i].is_active) {
-			GFraMe_sprite *en = enemies + i;
-			GFraMe_sprite_update(en, ms);
+	while (i < enemies.len) {
+		struct enemy *en = (struct enemy*)GFraMe_pool_at(&enemies, i);
+		if (en->spr.id == 0 && en->spr.is_active) {
+			GFraMe_sprite_update(&en->spr, ms);
 			// just died, should fall for a few frames
-			if (stop_frames[i] != 0) {
-				float tmp =  1.0f - (float)stop_frames[i] / 30.0f;
-				enemies[i].alpha = tmp;
-				enemies[i].scale_y = tmp;
+			if (en->stop_frames != 0) {
+				float tmp =  1.0f - (float)en->stop_frames / 30.0f;
+				en->spr.alpha = tmp;
+				en->spr.scale_y = tmp;
 			}
-			if (stop_frames[i]++ > 30) {
+			if (en->stop_frames++ > 30) {
+				// The last enemy is moved here, so check this position again
 				enemies_kill(i);
+				continue;
 			}
 		}
-		else if (enemies[i].is_active) {
-			GFraMe_sprite *en = enemies + i;
-			GFraMe_sprite_update(en, ms);
-			if (en->obj.x > 320) {
-				en->id = 0;
-				en->is_active = 0;
-				en->is_visible = 0;
+		else if (en->spr.is_active) {
+			GFraMe_sprite_update(&en->spr, ms);
+			if (en->spr.obj.x > 320) {
+				GFraMe_pool_release_at(&enemies, i);
+				continue;
 			}
 		}
-		else if (stop_frames[i] > 0) {
-			stop_frames[i]--;
-			if (stop_frames[i] == 0) {
+		else if (en->stop_frames > 0) {
+			en->stop_frames--;
+			if (en->stop_frames == 0) {
 				if (!GFraMe_gl)
-					enemies[i].offset_y -= 4;
-				enemies[i].is_active = 1;
-				enemies[i].scale_y = 1.0f;
+					en->spr.offset_y -= 4;
+				en->spr.is_active = 1;
+				en->spr.scale_y = 1.0f;
 			}
 		}
 		i++;
@@ -108,83 +124,78 @@ void enemies_update(int ms) {
 void enemies_draw() {
 	int i;
 	i = 0;
-	while (i < MAX_ENEMIES) {
-		if (enemies[i].is_visible)
-			GFraMe_sprite_draw(enemies + i);
+	while (i < enemies.len) {
+		struct enemy *en = (struct enemy*)GFraMe_pool_at(&enemies, i);
+		if (en->spr.is_visible)
+			GFraMe_sprite_draw(&en->spr);
 		i++;
 	}
 }
 
 GFraMe_object *enemies_get_object(int i) {
-	if (i >= MAX_ENEMIES)
+	if (i >= enemies.len)
 		return NULL;
-	return &enemies[i].obj;
+	return &((struct enemy*)GFraMe_pool_at(&enemies, i))->spr.obj;
 }
 
 int enemies_is_alive(int i) {
-	return enemies[i].id != 0 && enemies[i].is_active;
+	GFraMe_sprite *spr = &((struct enemy*)GFraMe_pool_at(&enemies, i))->spr;
+	return spr->id != 0 && spr->is_active;
 }
 
 void enemies_on_hit(int i) {
-	enemies[i].hp--;
-	switch (enemies[i].id) {
-		case 1: enemies[i].cur_tile = 17; break;
-		case 2: enemies[i].cur_tile = 20; break;
-		case 3: enemies[i].cur_tile = 23; break;
-		case 4: enemies[i].cur_tile = 31; break;
-		case 5: enemies[i].cur_tile = 39; break;
+	struct enemy *en = (struct enemy*)GFraMe_pool_at(&enemies, i);
+	en->spr.hp--;
+	switch (en->spr.id) {
+		case 1: en->spr.cur_tile = 17; break;
+		case 2: en->spr.cur_tile = 20; break;
+		case 3: en->spr.cur_tile = 23; break;
+		case 4: en->spr.cur_tile = 31; break;
+		case 5: en->spr.cur_tile = 39; break;
 	}
-	if (enemies[i].hp <= 0) {
+	if (en->spr.hp <= 0) {
 		GFraMe_audio_play(&gl_death, 0.5);
-		stop_frames[i] = 0;
-		enemies[i].offset_y += 4;
-		enemies[i].obj.vy = 50;
-		enemies[i].obj.vx = 0;
-		enemies[i].anim = NULL;
+		en->stop_frames = 0;
+		en->spr.offset_y += 4;
+		en->spr.obj.vy = 50;
+		en->spr.obj.vx = 0;
+		en->spr.anim = NULL;
 		//enemies_kill(i);
-		if (enemies[i].id <= 3)
-			score_inc((int)(35 * enemies[i].id * multi_get()));
-		else if (enemies[i].id <= 5)
-			score_inc((int)(50 * enemies[i].id * multi_get()));
-		enemies[i].id = 0;
+		if (en->spr.id <= 3)
+			score_inc((int)(35 * en->spr.id * multi_get()));
+		else if (en->spr.id <= 5)
+			score_inc((int)(50 * en->spr.id * multi_get()));
+		en->spr.id = 0;
 	}
 	else {
 		GFraMe_audio_play(&gl_hit, 0.5);
-		stop_frames[i] = 4;
+		en->stop_frames = 4;
 		if (!GFraMe_gl)
-			enemies[i].offset_y += 4;
-		enemies[i].is_active = 0;
-		enemies[i].scale_y = 0.8f;
+			en->spr.offset_y += 4;
+		en->spr.is_active = 0;
+		en->spr.scale_y = 0.8f;
 	}
 }
 
 static void enemies_kill(int i) {
-	enemies[i].id = 0;
-	enemies[i].is_active = 0;
-	enemies[i].is_visible = 0;
-	enemies[i].obj.x = 640;
-	stop_frames[i] = 0;
+	GFraMe_pool_release_at(&enemies, i);
 	multi_inc();
 }
 
 int enemies_do_spawn() {
-	int i;
+	struct enemy *en;
 	int time = 1000;
-	i = 0;
-	while (i < MAX_ENEMIES) {
-		if (enemies[i].id == 0 && !enemies[i].is_active) {
-			enemies_spawn_random(enemies+i, en_animation+i);
-			enemies[i].obj.vy = 0;
-			break;
-		}
-		i++;
-	}
+	void *item;
 	// Sets a new spawn time, depending on what was spawned
-	if (i < MAX_ENEMIES) {
+	if (GFraMe_pool_acquire(&enemies, NULL, &item) == GFraMe_ret_ok) {
+		en = (struct enemy*)item;
+		enemies_spawn_random(&en->spr, &en->anim);
+		en->spr.obj.vy = 0;
+		en->stop_frames = 0;
 		// r = [-500, 500], with a step of 100
 		time = (GFraMe_util_randomi() % 11 - 5) * 100;
 		// easier enemies spawn faster! (also, 1s + r)
-		time = (1000 + time) / (3 - (enemies[i].id - 1) % 3);
+		time = (1000 + time) / (3 - (en->spr.id - 1) % 3);
 	}
 	return time;
 }
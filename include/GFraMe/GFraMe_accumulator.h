@@ -79,5 +79,13 @@ void GFraMe_accumulator_update(GFraMe_accumulator *acc, int dt);
  */
 GFraMe_ret GFraMe_accumulator_loop(GFraMe_accumulator *acc);
 
+/**
+ * Get how much of a frame was accumulated (i.e., how far into the next frame
+ * it is); used to interpolate drawing between two updates
+ * @param	*acc	Accumulator to be checked
+ * @return	The fraction of a frame, from 0.0 to 1.0
+ */
+float GFraMe_accumulator_alpha(GFraMe_accumulator *acc);
+
 #endif
 
@@ -0,0 +1,96 @@
+/**
+ * @include/GFraMe/GFraMe_adpcm.h
+ *
+ * IMA-ADPCM codec, used to keep audios compressed (4 bits per sample) in
+ *memory and decode them as they are mixed.
+ *
+ * Samples are split into independent blocks (of GFraMe_adpcm_block_frames
+ *frames), each starting with its first sample stored verbatim; so seeking
+ *(e.g., looping) only has to decode from the start of a block. Each channel
+ *of a block takes GFraMe_adpcm_block_size bytes: a 4 bytes header (16 bits
+ *sample, step index and a padding byte) followed by the nibbles (low nibble
+ *first).
+ */
+#ifndef __GFRAME_ADPCM_H_
+#define __GFRAME_ADPCM_H_
+
+#include <SDL2/SDL_stdinc.h>
+
+/**
+ * How many frames are encoded in a block
+ */
+#define GFraMe_adpcm_block_frames	505
+/**
+ * How many bytes each channel takes in a block
+ */
+#define GFraMe_adpcm_block_size	256
+
+/**
+ * Decoder state; positioned at the start of the audio by
+ *GFraMe_adpcm_init_state
+ */
+struct stGFraMe_adpcm_state {
+	/**
+	 * Last decoded sample, for each channel
+	 */
+	int predictor[2];
+	/**
+	 * Current step index, for each channel
+	 */
+	int index[2];
+	/**
+	 * Next frame to be decoded
+	 */
+	int frame;
+};
+typedef struct stGFraMe_adpcm_state GFraMe_adpcm_state;
+
+/**
+ * Get how many bytes are needed to encode some samples
+ * @param	frames	How many frames there are
+ * @param	stereo	Whether there are two channels or only one
+ * @return	The encoded size, in bytes
+ */
+int GFraMe_adpcm_get_size(int frames, int stereo);
+
+/**
+ * Encode signed 16 bits samples
+ * @param	*dst	The output (GFraMe_adpcm_get_size bytes)
+ * @param	*src	The (interleaved) samples
+ * @param	frames	How many frames there are
+ * @param	stereo	Whether there are two channels or only one
+ * @return	How many bytes were written
+ */
+int GFraMe_adpcm_encode(char *dst, const Sint16 *src, int frames, int stereo);
+
+/**
+ * Position a decoder at the start of the audio
+ * @param	*st	The decoder
+ */
+void GFraMe_adpcm_init_state(GFraMe_adpcm_state *st);
+
+/**
+ * Position a decoder at any frame (decoding from the start of its block)
+ * @param	*st	The decoder
+ * @param	*src	The encoded audio
+ * @param	frame	Frame that should be decoded next
+ * @param	stereo	Whether there are two channels or only one
+ */
+void GFraMe_adpcm_seek(GFraMe_adpcm_state *st, const char *src, int frame,
+	int stereo);
+
+/**
+ * Decode the next frames
+ * @param	*dst	The output (interleaved), or NULL to skip the frames
+ * @param	*st	The decoder
+ * @param	*src	The encoded audio
+ * @param	frames	How many frames should be decoded
+ * @param	total	How many frames there are in the audio
+ * @param	stereo	Whether there are two channels or only one
+ * @return	How many frames were decoded
+ */
+int GFraMe_adpcm_decode(Sint16 *dst, GFraMe_adpcm_state *st, const char *src,
+	int frames, int total, int stereo);
+
+#endif
+
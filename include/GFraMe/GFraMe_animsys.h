@@ -0,0 +1,198 @@
+/**
+ * @include/GFraMe/GFraMe_animsys.h
+ *
+ * Batched animations: clips are immutable and may be shared by any number of
+ *instances, while each instance's state (clip, accumulator, frame and tile)
+ *is packed into arrays, so a single call updates every instance.
+ *
+ * Timing matches GFraMe_animation (a frame lasts 1000/fps ms), except that a
+ *long step advances as many frames as needed, instead of only one. Only
+ *instances whose tile actually changed are listed after an update, and their
+ *new tile is written to their target (e.g., a sprite's cur_tile).
+ */
+#ifndef __GFRAME_ANIMSYS_H_
+#define __GFRAME_ANIMSYS_H_
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_pool.h>
+
+/**
+ * Handle to an animation instance
+ */
+typedef GFraMe_pool_handle GFraMe_animsys_handle;
+
+/**
+ * Immutable animation data
+ */
+struct stGFraMe_anim_clip {
+	/**
+	 * Frames indexes in the spriteset
+	 */
+	int const *frames;
+	/**
+	 * How many frames there are
+	 */
+	int num_frames;
+	/**
+	 * How long, in milliseconds, a frame should last (0 for a still frame)
+	 */
+	int frame_duration;
+	/**
+	 * Whether the animation should loop
+	 */
+	int do_loop;
+};
+typedef struct stGFraMe_anim_clip GFraMe_anim_clip;
+
+/**
+ * Flags of an instance
+ */
+enum enGFraMe_animsys_flags {
+	/**
+	 * The tile changed on the last update
+	 */
+	GFraMe_animsys_changed  = 0x01,
+	/**
+	 * A non-looping clip reached its end
+	 */
+	GFraMe_animsys_finished = 0x02
+};
+typedef enum enGFraMe_animsys_flags GFraMe_animsys_flags;
+
+struct stGFraMe_animsys {
+	/**
+	 * Instances' handles
+	 */
+	GFraMe_pool handles;
+	/**
+	 * Clip played by each instance
+	 */
+	const GFraMe_anim_clip **clips;
+	/**
+	 * Decreasing accumulator of each instance (a new frame is issued when
+	 *it's less or equal to zero)
+	 */
+	int *acc;
+	/**
+	 * Current frame of each instance
+	 */
+	int *index;
+	/**
+	 * Current tile of each instance
+	 */
+	int *tile;
+	/**
+	 * Where each instance's tile is written to, when it changes (or NULL)
+	 */
+	int **targets;
+	/**
+	 * GFraMe_animsys_flags of each instance
+	 */
+	unsigned char *flags;
+	/**
+	 * Handle's slot of each instance
+	 */
+	int *owner;
+	/**
+	 * Position of each handle's slot on the instance arrays
+	 */
+	int *pos;
+	/**
+	 * How many instances there are
+	 */
+	int len;
+	/**
+	 * Handles of the instances whose tile changed on the last update
+	 */
+	GFraMe_animsys_handle *changed;
+	/**
+	 * How many instances changed on the last update
+	 */
+	int num_changed;
+};
+typedef struct stGFraMe_animsys GFraMe_animsys;
+
+/**
+ * Initialize a clip
+ * @param	*clip	The clip
+ * @param	fps	At how many frames per second it should run
+ * @param	*frames	Array of frames (it isn't copied)
+ * @param	num_frames	How many frames there are in the animation
+ * @param	do_loop	Whether it should loop (1) or not (0)
+ */
+void GFraMe_anim_clip_init(GFraMe_anim_clip *clip, int fps,
+						   int const *frames, int num_frames, int do_loop);
+
+/**
+ * Initialize the system
+ * @param	*sys	The system
+ * @param	max	How many instances there may be
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_animsys_init(GFraMe_animsys *sys, int max);
+
+/**
+ * Release every memory alloc'ed by the system
+ * @param	*sys	The system
+ */
+void GFraMe_animsys_clear(GFraMe_animsys *sys);
+
+/**
+ * Add a new instance, starting on the clip's first frame (which is written
+ *to the target right away)
+ * @param	*sys	The system
+ * @param	*handle	Returns the instance's handle
+ * @param	*clip	The clip (must outlive the instance)
+ * @param	*target	Where the tile is written to, when it changes (may be
+ *					NULL)
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - The system is full
+ */
+GFraMe_ret GFraMe_animsys_add(GFraMe_animsys *sys,
+							  GFraMe_animsys_handle *handle,
+							  const GFraMe_anim_clip *clip, int *target);
+
+/**
+ * Remove an instance
+ * @param	*sys	The system
+ * @param	handle	The instance
+ */
+void GFraMe_animsys_remove(GFraMe_animsys *sys, GFraMe_animsys_handle handle);
+
+/**
+ * Play a clip from its start; nothing is done if the instance is already
+ *playing that clip (and it hasn't finished)
+ * @param	*sys	The system
+ * @param	handle	The instance
+ * @param	*clip	The clip
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Stale handle
+ */
+GFraMe_ret GFraMe_animsys_play(GFraMe_animsys *sys,
+							   GFraMe_animsys_handle handle,
+							   const GFraMe_anim_clip *clip);
+
+/**
+ * Update every instance, listing the ones whose tile changed
+ * @param	*sys	The system
+ * @param	ms	Time elapsed, in milliseconds
+ */
+void GFraMe_animsys_update(GFraMe_animsys *sys, int ms);
+
+/**
+ * Get an instance's current tile
+ * @param	*sys	The system
+ * @param	handle	The instance
+ * @return	The tile or -1, if the handle is stale
+ */
+int GFraMe_animsys_get_tile(GFraMe_animsys *sys, GFraMe_animsys_handle handle);
+
+/**
+ * Get an instance's flags
+ * @param	*sys	The system
+ * @param	handle	The instance
+ * @return	Bitfield of GFraMe_animsys_flags (0 if the handle is stale)
+ */
+int GFraMe_animsys_get_flags(GFraMe_animsys *sys,
+							 GFraMe_animsys_handle handle);
+
+#endif
+
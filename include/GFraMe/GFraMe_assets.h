@@ -5,6 +5,7 @@
 #define __GFRAME_ASSETS_H_
 
 #include <GFraMe/GFraMe_error.h>
+#include <SDL2/SDL_rwops.h>
 
 /**
  * Check whether a file exists
@@ -24,8 +25,50 @@ GFraMe_ret GFraMe_assets_check_file(char *fileName);
 GFraMe_ret GFraMe_assets_buffer_image(char *filename, int width, int height,
 	char **buf);
 
+/**
+ * Opens an audio's raw samples (creating them from a WAVE file, if needed)
+ * @param	*filename	Audio's filename (without extension)
+ * @param	**fp	The opened file, at its first sample (caller closed!!)
+ * @param	*len	The samples' length, in bytes
+ * @param	*freq	The audio's sample rate
+ * @param	*stereo	Whether the audio has two channels; only overwritten if
+ *the file says so (older files don't)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_assets_open_audio(char *filename, SDL_RWops **fp,
+	int *len, int *freq, int *stereo);
+
 GFraMe_ret GFraMe_assets_buffer_audio(char *filename, char **buf, int *len);
 
+/**
+ * Loads an audio's raw samples into a buffer, along with its format
+ * @param	*filename	Audio's filename (without extension)
+ * @param	**buf	Allocated buffer (caller freed!!)
+ * @param	*len	The samples' length, in bytes
+ * @param	*freq	The audio's sample rate
+ * @param	*stereo	Whether the audio has two channels; only overwritten if
+ *the file says so (older files don't)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_assets_buffer_audio_fmt(char *filename, char **buf,
+	int *len, int *freq, int *stereo);
+
+/**
+ * Loads an audio, compressed as IMA-ADPCM, into a buffer. The '.adp' file
+ *should be created offline (see wavtoadpcm or 'make tools'), since assets may
+ *be read-only (e.g., inside an APK); if there's none, it's encoded from the raw
+ *samples (and saved, if possible)
+ * @param	*filename	Audio's filename (without extension)
+ * @param	**buf	Allocated buffer (caller freed!!)
+ * @param	*frames	How many frames were encoded
+ * @param	*freq	The audio's sample rate
+ * @param	*stereo	Whether the audio has two channels; only overwritten if
+ *the file says so
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_assets_buffer_audio_adpcm(char *filename, char **buf,
+	int *frames, int *freq, int *stereo);
+
 /**
  * Someday I'll properly comment this, but it reads a 24 bits R8 G8 B8
  * bitmap and convert it into a data file.
@@ -4,8 +4,35 @@
 #ifndef __GFRAME_AUDIO_H_
 #define __GFRAME_AUDIO_H_
 
+#include <GFraMe/GFraMe_audio_stream.h>
 #include <GFraMe/GFraMe_error.h>
 
+/**
+ * Mix buses; every bus but the master is mixed into the master
+ */
+enum enGFraMe_audio_bus {
+	GFraMe_audio_bus_master = 0,
+	GFraMe_audio_bus_music,
+	GFraMe_audio_bus_sfx,
+	GFraMe_audio_bus_ui,
+	GFraMe_audio_bus_max
+};
+typedef enum enGFraMe_audio_bus GFraMe_audio_bus;
+
+/**
+ * What happens when an audio is played while it already has as many
+ *instances playing as it may
+ */
+enum enGFraMe_audio_replace {
+	/** Restart the oldest instance */
+	GFraMe_audio_replace_oldest = 0,
+	/** Restart the quietest instance */
+	GFraMe_audio_replace_quietest,
+	/** Don't play it */
+	GFraMe_audio_replace_none
+};
+typedef enum enGFraMe_audio_replace GFraMe_audio_replace;
+
 /**
  * Container for a loaded audio.
  */
@@ -30,6 +57,35 @@ struct stGFraMe_audio {
 	 * Whether the audio has two channels or only one
 	 */
 	int stereo;
+	/**
+	 * Sample rate, in Hz (resampled to the device's while mixing)
+	 */
+	int freq;
+	/**
+	 * Samples streamed from disk (if not NULL, buf isn't used)
+	 */
+	GFraMe_audio_stream *stream;
+	/**
+	 * Whether buf holds IMA-ADPCM blocks (len is still the decoded length)
+	 */
+	int adpcm;
+	/**
+	 * When every voice is in use, only audios of lower (or the same)
+	 *priority are stolen to play this one
+	 */
+	int priority;
+	/**
+	 * How many instances of this audio may play at once (0 for no limit)
+	 */
+	int max_instances;
+	/**
+	 * What to do when max_instances are already playing
+	 */
+	GFraMe_audio_replace replace;
+	/**
+	 * Bus where the audio is mixed (the BGM is always on the music bus)
+	 */
+	GFraMe_audio_bus bus;
 };
 typedef struct stGFraMe_audio GFraMe_audio;
 
@@ -43,12 +99,55 @@ typedef struct stGFraMe_audio GFraMe_audio;
  */
 GFraMe_ret GFraMe_audio_init(GFraMe_audio *aud, char *filename, int loop,
 	int loop_pos, int stereo);
+/**
+ * Loads an audio compressed as IMA-ADPCM, which is decoded as it's mixed
+ * @param	*aud	Struct where the audio will be stored
+ * @param	*filename	Filename of the audio source
+ * @param	loop	Whether the audio should loop or not
+ * @param	loop_pos	Sample that should be jumped to on loop
+ * @return	GFraMe_ok if the audio loaded correctly
+ */
+GFraMe_ret GFraMe_audio_init_adpcm(GFraMe_audio *aud, char *filename,
+	int loop, int loop_pos, int stereo);
+/**
+ * Opens an audio to be streamed from disk, instead of buffering it; it may
+ *only be played as the BGM
+ * @param	*aud	Struct where the audio will be stored
+ * @param	*filename	Filename of the audio source
+ * @param	loop	Whether the audio should loop or not
+ * @param	loop_pos	Sample that should be jumped to on loop
+ * @return	GFraMe_ok if the audio opened correctly
+ */
+GFraMe_ret GFraMe_audio_init_stream(GFraMe_audio *aud, char *filename,
+	int loop, int loop_pos, int stereo);
 /**
  * Clear up memory allocated by the audio
  * @param	*aud	Struct which should be cleared
  */
 void GFraMe_audio_clear(GFraMe_audio *aud);
 void GFraMe_audio_play(GFraMe_audio *aud, double volume);
+/**
+ * Set an audio's priority; it mustn't be changed while the audio is playing
+ * @param	*aud	The audio
+ * @param	priority	Higher priorities may steal voices from lower ones
+ */
+void GFraMe_audio_set_priority(GFraMe_audio *aud, int priority);
+/**
+ * Limit how many instances of an audio may play at once; it mustn't be
+ *changed while the audio is playing
+ * @param	*aud	The audio
+ * @param	num	Maximum number of instances (0 for no limit)
+ * @param	replace	What to do when the limit is reached
+ */
+void GFraMe_audio_set_max_instances(GFraMe_audio *aud, int num,
+	GFraMe_audio_replace replace);
+/**
+ * Set the bus where an audio is mixed (GFraMe_audio_bus_sfx, by default); it
+ *mustn't be changed while the audio is playing
+ * @param	*aud	The audio
+ * @param	bus	The bus
+ */
+void GFraMe_audio_set_bus(GFraMe_audio *aud, GFraMe_audio_bus bus);
 
 #endif
 
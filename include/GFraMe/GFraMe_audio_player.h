@@ -8,12 +8,260 @@
 #include <GFraMe/GFraMe_error.h>
 #include <SDL2/SDL_audio.h>
 
+/**
+ * How many audios may play at once (besides the BGM)
+ */
+#define GFraMe_audio_player_max_voices	64
+/**
+ * Voices quieter than this aren't mixed (they only keep advancing)
+ */
+#define GFraMe_audio_player_cull_volume	0.004
+/**
+ * Default horizontal distance (in world units) where a positional audio is
+ *only heard on one side
+ */
+#define GFraMe_audio_player_pan_dist	160.0
+/**
+ * Default distance up to which positional audios play at their full volume
+ */
+#define GFraMe_audio_player_min_dist	64.0
+/**
+ * Default distance from which positional audios are no longer heard
+ */
+#define GFraMe_audio_player_max_dist	480.0
+/**
+ * How many commands may be queued between two callbacks
+ */
+#define GFraMe_audio_player_max_cmds	256
+/**
+ * How many audios may wait for their time at once (more start right away)
+ */
+#define GFraMe_audio_player_max_scheduled	64
+/**
+ * Size of the device's buffer, in frames, unless configured otherwise (~23ms
+ *at 44100 Hz)
+ */
+#define GFraMe_audio_player_default_samples	1024
+#define GFraMe_audio_player_min_samples	64
+#define GFraMe_audio_player_max_samples	8192
+/**
+ * Auto-tune doubles the buffer once this many underruns happen within
+ *GFraMe_audio_player_tune_ms
+ */
+#define GFraMe_audio_player_tune_underruns	3
+#define GFraMe_audio_player_tune_ms	2000
+
+/**
+ * Handle to a playing audio; 0 is never a valid handle
+ */
+typedef unsigned int GFraMe_audio_voice;
+
+/**
+ * What the callback measured since the stats were last reset
+ */
+struct stGFraMe_audio_stats {
+	/**
+	 * Size of the device's buffer, in frames
+	 */
+	int samples;
+	/**
+	 * How long the buffer lasts, in milliseconds
+	 */
+	double latency_ms;
+	/**
+	 * How many buffers were mixed
+	 */
+	int callbacks;
+	/**
+	 * How many times the callback was called too late (i.e., the device
+	 *probably ran out of samples)
+	 */
+	int underruns;
+	/**
+	 * Time spent mixing the last buffer, in milliseconds
+	 */
+	double last_ms;
+	/**
+	 * Longest and average time spent mixing, relative to the buffer's duration
+	 *(over 1.0, the callback can't keep up)
+	 */
+	double peak_load;
+	double avg_load;
+	/**
+	 * Voices mixed (i.e., not culled) on the last buffer, and the most ever
+	 */
+	int voices;
+	int peak_voices;
+};
+typedef struct stGFraMe_audio_stats GFraMe_audio_stats;
+
+/**
+ * Most functions only queue a command for the audio callback (which owns
+ *every playing audio), so they must all be called from the same (game) thread
+ */
 GFraMe_ret GFraMe_audio_player_init();
 void GFraMe_audio_player_clear();
 SDL_AudioSpec* GFraMe_audio_player_get_spec();
 void GFraMe_audio_player_play_bgm(GFraMe_audio *aud, double volume);
 void GFraMe_audio_player_set_bgm_volume(double volume);
 void GFraMe_audio_player_push(GFraMe_audio *aud, double volume);
+/**
+ * Play an audio, keeping a handle to stop or modify it later
+ * @param	*aud	The audio
+ * @param	volume	The audio's volume
+ * @return	The voice's handle (or 0, if the command ring was full and it
+ *			won't be played)
+ */
+GFraMe_audio_voice GFraMe_audio_player_push_voice(GFraMe_audio *aud,
+												  double volume);
+/**
+ * Play an audio at a position in the world; it's attenuated by its distance to
+ *the listener and panned to its side, and it isn't mixed while it's too far to
+ *be heard
+ * @param	*aud	The audio
+ * @param	volume	The audio's volume (before being attenuated)
+ * @param	x	Horizontal position, in world space
+ * @param	y	Vertical position, in world space
+ * @return	The voice's handle (or 0, if the command ring was full and it
+ *			won't be played)
+ */
+GFraMe_audio_voice GFraMe_audio_player_push_at(GFraMe_audio *aud,
+											   double volume, double x,
+											   double y);
+/**
+ * Move a positional audio (e.g., to follow its source)
+ * @param	voice	The audio's handle
+ * @param	x	Horizontal position, in world space
+ * @param	y	Vertical position, in world space
+ */
+void GFraMe_audio_player_set_position(GFraMe_audio_voice voice, double x,
+									  double y);
+/**
+ * Move the listener of positional audios
+ * @param	x	Horizontal position, in world space
+ * @param	y	Vertical position, in world space
+ */
+void GFraMe_audio_player_set_listener(double x, double y);
+/**
+ * Place the listener at the camera's center; audios on the edges of the
+ *camera are panned the most
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ */
+void GFraMe_audio_player_set_listener_camera(int cam_x, int cam_y, int cam_w,
+											 int cam_h);
+/**
+ * Set how positional audios are attenuated (linearly, between both distances)
+ * @param	min_dist	Up to which distance they play at their full volume
+ * @param	max_dist	From which distance they are no longer heard
+ */
+void GFraMe_audio_player_set_attenuation(double min_dist, double max_dist);
+/**
+ * Play an audio starting exactly at a frame of the audio clock (see
+ *GFraMe_audio_player_get_clock); if it's already past, it starts as soon as
+ *possible. Until it starts, its voice may be stopped or modified as usual
+ * @param	*aud	The audio
+ * @param	volume	The audio's volume
+ * @param	time	Audio clock's frame when it starts
+ * @return	The voice's handle (or 0, if the command ring was full and it
+ *			won't be played)
+ */
+GFraMe_audio_voice GFraMe_audio_player_push_scheduled(GFraMe_audio *aud,
+													  double volume,
+													  Uint64 time);
+/**
+ * Play an audio some time after the current audio clock, with sample accuracy
+ * @param	*aud	The audio
+ * @param	volume	The audio's volume
+ * @param	ms	How long until it starts, in milliseconds
+ * @return	The voice's handle (or 0, if the command ring was full and it
+ *			won't be played)
+ */
+GFraMe_audio_voice GFraMe_audio_player_push_delayed(GFraMe_audio *aud,
+													double volume, int ms);
+/**
+ * Get the audio clock: how many frames (at the device's rate) were mixed
+ *since the player was initialized, advancing smoothly between callbacks. As
+ *the mixer runs a buffer ahead of the device, an audio scheduled at the
+ *current clock is heard after a constant delay (the buffer's duration), instead
+ *of whenever the next callback happens to run. It stops while the device is
+ *paused (including while nothing is playing)
+ * @return	The current frame
+ */
+Uint64 GFraMe_audio_player_get_clock();
+void GFraMe_audio_player_stop(GFraMe_audio_voice voice);
+void GFraMe_audio_player_set_volume(GFraMe_audio_voice voice, double volume);
+/**
+ * Limit how many audios may play at once (besides the BGM); once every voice
+ *is in use, a new audio steals the voice with the lowest priority (then the
+ *quietest, then the oldest), if it's not more important than the new one
+ * @param	num	Up to GFraMe_audio_player_max_voices
+ */
+void GFraMe_audio_player_set_max_voices(int num);
+/**
+ * Fade a bus' volume
+ * @param	bus	The bus
+ * @param	volume	The new volume (from 0.0 to 1.0)
+ * @param	ms	How long the fade takes (0 to change it immediately)
+ */
+void GFraMe_audio_player_set_bus_volume(GFraMe_audio_bus bus, double volume,
+										int ms);
+/**
+ * Filter a bus through a low-pass (e.g., to muffle the game while paused)
+ * @param	bus	The bus
+ * @param	cutoff	The cutoff frequency, in Hz (0 to disable it)
+ */
+void GFraMe_audio_player_set_bus_lowpass(GFraMe_audio_bus bus, double cutoff);
+/**
+ * Send part of a bus to the reverb (the master bus can't be sent)
+ * @param	bus	The bus
+ * @param	send	How much is sent (from 0.0 to 1.0; 0 to disable it)
+ */
+void GFraMe_audio_player_set_bus_reverb(GFraMe_audio_bus bus, double send);
+/**
+ * Set the reverb's parameters
+ * @param	room	Room size, from 0.0 to 1.0
+ * @param	damp	Damping, from 0.0 to 1.0
+ */
+void GFraMe_audio_player_set_reverb(double room, double damp);
+/**
+ * Set the size of the device's buffer; smaller buffers lower the latency, but
+ *are more likely to underrun. If the device is already open, it's reopened
+ *(which takes a while, but keeps every playing audio)
+ * @param	num	Size in frames (rounded up to a power of two, between
+ *GFraMe_audio_player_min_samples and GFraMe_audio_player_max_samples)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_audio_player_set_samples(int num);
+/**
+ * Retrieve what the callback measured (without locking the device, so it may
+ *be called every frame)
+ * @param	*stats	Where the stats are returned
+ */
+void GFraMe_audio_player_get_stats(GFraMe_audio_stats *stats);
+/**
+ * Clear the measurements; the callback clears them on its next run, but they
+ *are already reported as cleared
+ */
+void GFraMe_audio_player_reset_stats();
+/**
+ * Grow the buffer whenever underruns keep happening; the buffer is only
+ *resized by GFraMe_audio_player_update
+ * @param	enable	Whether auto-tune is enabled
+ */
+void GFraMe_audio_player_set_auto_tune(int enable);
+/**
+ * Apply whatever the callback requested (i.e., auto-tune); should be called
+ *once in a while (e.g., every frame) from the game thread
+ */
+void GFraMe_audio_player_update();
+/**
+ * Pause the device (e.g., while the game is in the background); it stays
+ *paused until GFraMe_audio_player_play, even if audios are played or the
+ *buffer is resized meanwhile
+ */
 void GFraMe_audio_player_pause();
 void GFraMe_audio_player_play();
 
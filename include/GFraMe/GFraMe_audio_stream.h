@@ -0,0 +1,156 @@
+/**
+ * @include/GFraMe/GFraMe_audio_stream.h
+ *
+ * Audio streamed from disk, instead of being fully buffered. A background I/O
+ *thread keeps a small ring filled with the audio's next samples (going back to
+ *its loop position, when it reaches the end), so only a few hundred KB are
+ *ever in memory, no matter how long the audio is.
+ *
+ * The I/O thread is only running while there's any stream. Each stream may
+ *only be consumed by a single thread (i.e., the audio callback) at a time.
+ */
+#ifndef __GFRAME_AUDIO_STREAM_H_
+#define __GFRAME_AUDIO_STREAM_H_
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_ringbuf.h>
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_rwops.h>
+
+/**
+ * How many bytes are buffered for each stream (~1.5s of 44100 Hz stereo)
+ */
+#define GFraMe_audio_stream_ring_size	(256 * 1024)
+/**
+ * Most bytes read from disk at once
+ */
+#define GFraMe_audio_stream_chunk_size	(16 * 1024)
+/**
+ * How often the I/O thread checks whether any ring should be refilled
+ */
+#define GFraMe_audio_stream_poll_ms	10
+
+struct stGFraMe_audio_stream {
+	/**
+	 * The raw samples' file
+	 */
+	SDL_RWops *fp;
+	/**
+	 * Length of the file, in bytes
+	 */
+	int len;
+	/**
+	 * To which sample it should go back, when looping
+	 */
+	int loop_pos;
+	/**
+	 * Whether it's a looping audio or not
+	 */
+	int loop;
+	/**
+	 * Whether the audio has two channels or only one
+	 */
+	int stereo;
+	/**
+	 * Sample rate, in Hz
+	 */
+	int freq;
+	/**
+	 * Where the samples start, in the file
+	 */
+	int offset;
+	/**
+	 * Next byte to be read from the file (only used by the I/O thread)
+	 */
+	int pos;
+	/**
+	 * Samples read ahead of the consumer
+	 */
+	GFraMe_ringbuf ring;
+	/**
+	 * Set by the consumer to go back to the start of the audio; cleared by the
+	 *I/O thread once it did
+	 */
+	SDL_atomic_t rewind;
+	/**
+	 * Position on the ring where the rewound audio starts
+	 */
+	SDL_atomic_t start;
+	/**
+	 * Whether the I/O thread reached the end of a non-looping audio
+	 */
+	SDL_atomic_t ended;
+	/**
+	 * Set by the consumer whenever the ring has room (polled by the I/O
+	 *thread every GFraMe_audio_stream_poll_ms)
+	 */
+	SDL_atomic_t refill;
+	/**
+	 * Whether the consumer is waiting for a rewind (only used by the consumer)
+	 */
+	int restarting;
+	/**
+	 * Whether anything was consumed since the start (only used by the
+	 *consumer)
+	 */
+	int consumed;
+	/**
+	 * Next stream serviced by the I/O thread
+	 */
+	struct stGFraMe_audio_stream *next;
+};
+typedef struct stGFraMe_audio_stream GFraMe_audio_stream;
+
+/**
+ * Open an audio for streaming and start filling its ring
+ * @param	*st	The stream
+ * @param	*filename	Filename of the audio source
+ * @param	loop	Whether the audio should loop or not
+ * @param	loop_pos	Sample that should be jumped to on loop
+ * @param	stereo	Whether the audio has two channels (unless the file says
+ *otherwise)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_audio_stream_init(GFraMe_audio_stream *st, char *filename,
+	int loop, int loop_pos, int stereo);
+
+/**
+ * Stop servicing a stream and close it; it mustn't be playing
+ * @param	*st	The stream
+ */
+void GFraMe_audio_stream_clear(GFraMe_audio_stream *st);
+
+/**
+ * Read whole frames from the stream; only the consumer may call this
+ * @param	*st	The stream
+ * @param	*data	Where it should be read into
+ * @param	len	How many bytes should be read
+ * @return	How many bytes were read (less than requested on underrun)
+ */
+int GFraMe_audio_stream_read(GFraMe_audio_stream *st, void *data, int len);
+
+/**
+ * Request the stream to go back to its start; only the consumer may call this.
+ *Reads return nothing until the I/O thread handles it
+ * @param	*st	The stream
+ */
+void GFraMe_audio_stream_restart(GFraMe_audio_stream *st);
+
+/**
+ * Check whether the stream should be restarted before being played again;
+ *only the consumer may call this
+ * @param	*st	The stream
+ * @return	1 - It was already (partially) consumed; 0 - Otherwise
+ */
+int GFraMe_audio_stream_was_consumed(GFraMe_audio_stream *st);
+
+/**
+ * Check whether a non-looping stream was completely consumed; only the
+ *consumer may call this
+ * @param	*st	The stream
+ * @return	1 - It's over; 0 - Otherwise
+ */
+int GFraMe_audio_stream_did_end(GFraMe_audio_stream *st);
+
+#endif
+
@@ -0,0 +1,127 @@
+/**
+ * @include/GFraMe/GFraMe_clock.h
+ *
+ * High resolution frame clock, replacing the SDL timer (and its user events)
+ *as the main loop's driver. Time is read from SDL_GetPerformanceCounter and
+ *accumulated as "counter ticks times fps", so a step happens once a whole
+ *second's worth of ticks was accumulated and nothing is ever truncated (60 fps
+ *are really 60 steps per second, not 62.5).
+ *
+ * Waiting sleeps until close to the next deadline and spins through the rest,
+ *since SDL_Delay may oversleep by a few milliseconds. As no event is pushed,
+ *nothing piles up on the event queue when the game falls behind; the
+ *accumulated time is simply capped.
+ */
+#ifndef __GFRAME_CLOCK_H_
+#define __GFRAME_CLOCK_H_
+
+#include <SDL2/SDL.h>
+
+/**
+ * How long before a deadline, in microseconds, the clock stops sleeping and
+ *starts spinning
+ */
+#define GFraMe_clock_default_spin_us	2000
+
+struct stGFraMe_clock {
+	/**
+	 * Performance counter's frequency (ticks per second)
+	 */
+	Uint64 freq;
+	/**
+	 * Counter on the last GFraMe_clock_tick
+	 */
+	Uint64 last;
+	/**
+	 * Update steps per second
+	 */
+	int update_fps;
+	/**
+	 * Draws per second
+	 */
+	int draw_fps;
+	/**
+	 * Accumulated time for updates, in ticks times update_fps (a step is
+	 *issued for each freq accumulated)
+	 */
+	Uint64 update_acc;
+	/**
+	 * Accumulated time for draws, in ticks times draw_fps
+	 */
+	Uint64 draw_acc;
+	/**
+	 * At most, how much may be accumulated for updates
+	 */
+	Uint64 update_cap;
+	/**
+	 * How long before a deadline, in ticks, waiting starts spinning
+	 */
+	Uint64 spin;
+	/**
+	 * How many steps were issued, modulo update_fps
+	 */
+	int steps;
+	/**
+	 * Duration of the last step, in milliseconds; it alternates (e.g.,
+	 *between 16 and 17 ms, at 60 fps) so that the steps add up to exactly one
+	 *second every update_fps steps
+	 */
+	int elapsed;
+};
+typedef struct stGFraMe_clock GFraMe_clock;
+
+/**
+ * Start a clock
+ * @param	*clk	The clock
+ * @param	update_fps	How many update steps per second
+ * @param	draw_fps	How many draws per second
+ * @param	max_frames	At most, how many update steps may be accumulated
+ */
+void GFraMe_clock_init(GFraMe_clock *clk, int update_fps, int draw_fps,
+					   int max_frames);
+
+/**
+ * Set how long before a deadline waiting stops sleeping and starts spinning
+ *(more spinning is more precise, but uses more CPU)
+ * @param	*clk	The clock
+ * @param	us	The time, in microseconds
+ */
+void GFraMe_clock_set_spin(GFraMe_clock *clk, int us);
+
+/**
+ * Accumulate the time elapsed since the last tick
+ * @param	*clk	The clock
+ */
+void GFraMe_clock_tick(GFraMe_clock *clk);
+
+/**
+ * Sleep (and then spin) until an update step or a draw is due
+ * @param	*clk	The clock
+ */
+void GFraMe_clock_wait(GFraMe_clock *clk);
+
+/**
+ * Check if an update step is due, consuming it; call this in a loop
+ * @param	*clk	The clock
+ * @return	1 - A step was issued (its duration is on clk->elapsed); 0 -
+ *			Otherwise
+ */
+int GFraMe_clock_update(GFraMe_clock *clk);
+
+/**
+ * Check if a draw is due, consuming it (and dropping any other late draw)
+ * @param	*clk	The clock
+ * @return	1 - Should draw; 0 - Otherwise
+ */
+int GFraMe_clock_draw(GFraMe_clock *clk);
+
+/**
+ * Get how far into the next update step the clock is, for interpolating
+ *between the last two steps when drawing
+ * @param	*clk	The clock
+ * @return	The fraction of a step, from 0.0 to 1.0
+ */
+float GFraMe_clock_alpha(GFraMe_clock *clk);
+
+#endif
+
@@ -0,0 +1,177 @@
+/**
+ * @include/GFraMe/GFraMe_drawlist.h
+ *
+ * List of compact (16 bytes) render records. Sprites are pushed at the end
+ *of the simulation (which only reads their render fields once) and the draw
+ *phase then walks the packed records, instead of whole GFraMe_sprites (which
+ *are mostly physics and gameplay data).
+ */
+#ifndef __GFRAME_DRAWLIST_H_
+#define __GFRAME_DRAWLIST_H_
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_sprite.h>
+#include <GFraMe/GFraMe_spriteset.h>
+
+/**
+ * How many spritesets a list may reference
+ */
+#define GFraMe_drawlist_max_ssets	256
+/**
+ * Fixed point scale of a record's scale (i.e., 1.0 is stored as 256)
+ */
+#define GFraMe_drawlist_scale_one	256
+/**
+ * Fixed point scale of a record's angle
+ */
+#define GFraMe_drawlist_angle_one	64
+
+/**
+ * Flags of a record
+ */
+enum enGFraMe_drawlist_flags {
+	GFraMe_drawlist_flipped   = 0x01,
+	/**
+	 * Whether scale, angle or alpha aren't the default ones
+	 */
+	GFraMe_drawlist_transform = 0x02
+};
+typedef enum enGFraMe_drawlist_flags GFraMe_drawlist_flags;
+
+/**
+ * Everything needed to draw a sprite
+ */
+struct stGFraMe_drawlist_record {
+	/**
+	 * Screen position (offset and flipping already applied)
+	 */
+	short x;
+	short y;
+	/**
+	 * Tile to be drawn
+	 */
+	unsigned short tile;
+	/**
+	 * Index of the spriteset on the list
+	 */
+	unsigned char sset;
+	/**
+	 * Bitfield of GFraMe_drawlist_flags
+	 */
+	unsigned char flags;
+	/**
+	 * Scale, in 8.8 fixed point
+	 */
+	short scale_x;
+	short scale_y;
+	/**
+	 * Angle, in fixed point (see GFraMe_drawlist_angle_one)
+	 */
+	short angle;
+	/**
+	 * Alpha, from 0 to 255
+	 */
+	unsigned char alpha;
+	unsigned char pad;
+};
+typedef struct stGFraMe_drawlist_record GFraMe_drawlist_record;
+
+struct stGFraMe_drawlist {
+	/**
+	 * Every record, in drawing order
+	 */
+	GFraMe_drawlist_record *records;
+	/**
+	 * How many records there are
+	 */
+	int len;
+	/**
+	 * How many records fit on the buffer
+	 */
+	int max;
+	/**
+	 * Spritesets referenced by the records
+	 */
+	GFraMe_spriteset *ssets[GFraMe_drawlist_max_ssets];
+	/**
+	 * How many spritesets are referenced
+	 */
+	int num_ssets;
+	/**
+	 * Last spriteset looked up (to skip the search on runs of the same one)
+	 */
+	int last_sset;
+};
+typedef struct stGFraMe_drawlist GFraMe_drawlist;
+
+/**
+ * Initialize a draw list
+ * @param	*list	The list
+ * @param	max	Initial capacity (it grows as needed)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_drawlist_init(GFraMe_drawlist *list, int max);
+
+/**
+ * Release every memory alloc'ed by the list
+ * @param	*list	The list
+ */
+void GFraMe_drawlist_clear(GFraMe_drawlist *list);
+
+/**
+ * Remove every record, so a new frame may be pushed
+ * @param	*list	The list
+ */
+void GFraMe_drawlist_reset(GFraMe_drawlist *list);
+
+/**
+ * Push a sprite's render record (invisible sprites are skipped)
+ * @param	*list	The list
+ * @param	*spr	The sprite
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_drawlist_push_sprite(GFraMe_drawlist *list,
+									   GFraMe_sprite *spr);
+
+/**
+ * Push a sprite's render record, from world space into screen space (sprites
+ *outside the camera are skipped)
+ * @param	*list	The list
+ * @param	*spr	The sprite
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_drawlist_push_sprite_camera(GFraMe_drawlist *list,
+											  GFraMe_sprite *spr, int cam_x,
+											  int cam_y, int cam_w,
+											  int cam_h);
+
+/**
+ * Push a sprite's render record, interpolated between its last and current
+ *update, from world space into screen space (the camera should be
+ *interpolated by the caller)
+ * @param	*list	The list
+ * @param	*spr	The sprite
+ * @param	alpha	How far into the next update it is
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_drawlist_push_sprite_lerp(GFraMe_drawlist *list,
+											GFraMe_sprite *spr, float alpha,
+											int cam_x, int cam_y, int cam_w,
+											int cam_h);
+
+/**
+ * Draw every record, in the order they were pushed
+ * @param	*list	The list
+ */
+void GFraMe_drawlist_draw(GFraMe_drawlist *list);
+
+#endif
+
@@ -0,0 +1,280 @@
+/**
+ * @include/GFraMe/GFraMe_ecs.h
+ *
+ * Entity-component store: the data that a GFraMe_sprite keeps in a single
+ *struct (transform, physics, hitbox, animation, render and tween) is split
+ *into separate components, each stored packed on its own sparse set. Systems
+ *then only walk the components they actually need (e.g., drawing never
+ *touches velocities or tweens).
+ *
+ * Entities are handles from a GFraMe_pool, so a destroyed entity's handle is
+ *detected as stale. Components may be moved whenever a component of the same
+ *type is removed, so pointers to them shouldn't be kept across frames.
+ *
+ * GFraMe_sprite is left as is (so every GFraMe_sprite_* call keeps working);
+ *GFraMe_ecs_add_sprite and GFraMe_ecs_get_sprite convert between both.
+ * Collision is still done on GFraMe_object (or a GFraMe_world).
+ */
+#ifndef __GFRAME_ECS_H_
+#define __GFRAME_ECS_H_
+
+#include <GFraMe/GFraMe_animation.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_hitbox.h>
+#include <GFraMe/GFraMe_pool.h>
+#include <GFraMe/GFraMe_sprite.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_tween.h>
+
+/**
+ * Handle to an entity
+ */
+typedef GFraMe_pool_handle GFraMe_ecs_entity;
+
+/**
+ * Every component type
+ */
+enum enGFraMe_ecs_component {
+	/**
+	 * GFraMe_ecs_transform
+	 */
+	GFraMe_ecs_transform_comp = 0,
+	/**
+	 * GFraMe_ecs_physics
+	 */
+	GFraMe_ecs_physics_comp,
+	/**
+	 * GFraMe_hitbox
+	 */
+	GFraMe_ecs_hitbox_comp,
+	/**
+	 * GFraMe_animation
+	 */
+	GFraMe_ecs_animation_comp,
+	/**
+	 * GFraMe_ecs_render
+	 */
+	GFraMe_ecs_render_comp,
+	/**
+	 * GFraMe_tween
+	 */
+	GFraMe_ecs_tween_comp,
+	GFraMe_ecs_num_components
+};
+typedef enum enGFraMe_ecs_component GFraMe_ecs_component;
+
+/**
+ * Entity's position
+ */
+struct stGFraMe_ecs_transform {
+	/**
+	 * Horizontal position
+	 */
+	double x;
+	/**
+	 * Vertical position
+	 */
+	double y;
+	/**
+	 * Horizontal position on the previous update
+	 */
+	double last_x;
+	/**
+	 * Vertical position on the previous update
+	 */
+	double last_y;
+};
+typedef struct stGFraMe_ecs_transform GFraMe_ecs_transform;
+
+/**
+ * Entity's movement; requires a transform
+ */
+struct stGFraMe_ecs_physics {
+	double vx;
+	double vy;
+	double ax;
+	double ay;
+};
+typedef struct stGFraMe_ecs_physics GFraMe_ecs_physics;
+
+/**
+ * How an entity is drawn; requires a transform
+ */
+struct stGFraMe_ecs_render {
+	/**
+	 * Spriteset used by this entity
+	 */
+	GFraMe_spriteset *sset;
+	/**
+	 * Current displaying tile (set by the animation, if any)
+	 */
+	int tile;
+	/**
+	 * Graphic's horizontal offset (from physical position)
+	 */
+	int offset_x;
+	/**
+	 * Graphic's vertical offset (from physical position)
+	 */
+	int offset_y;
+	float scale_x;
+	float scale_y;
+	float angle;
+	float alpha;
+	/**
+	 * Whether it should be drawn flipped (uses the hitbox, if any, just like
+	 *a sprite)
+	 */
+	int flipped;
+	/**
+	 * Whether it should be drawn
+	 */
+	int is_visible;
+};
+typedef struct stGFraMe_ecs_render GFraMe_ecs_render;
+
+/**
+ * Packed storage for a component type
+ */
+struct stGFraMe_ecs_set {
+	/**
+	 * Every component, packed
+	 */
+	char *data;
+	/**
+	 * Size of each component
+	 */
+	int size;
+	/**
+	 * Entity (slot) of each component
+	 */
+	int *dense;
+	/**
+	 * Index of each entity's (slot) component, or -1
+	 */
+	int *sparse;
+	/**
+	 * How many components there are
+	 */
+	int len;
+};
+typedef struct stGFraMe_ecs_set GFraMe_ecs_set;
+
+struct stGFraMe_ecs {
+	/**
+	 * Every live entity
+	 */
+	GFraMe_pool entities;
+	/**
+	 * Storage of each component type
+	 */
+	GFraMe_ecs_set sets[GFraMe_ecs_num_components];
+};
+typedef struct stGFraMe_ecs GFraMe_ecs;
+
+/**
+ * Initialize the store
+ * @param	*ecs	The store
+ * @param	max_entities	How many entities may exist at once
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_ecs_init(GFraMe_ecs *ecs, int max_entities);
+
+/**
+ * Release every memory alloc'ed by the store
+ * @param	*ecs	The store
+ */
+void GFraMe_ecs_clear(GFraMe_ecs *ecs);
+
+/**
+ * Create a new entity, without any component
+ * @param	*ecs	The store
+ * @param	*ent	Returns the entity
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - The store is full
+ */
+GFraMe_ret GFraMe_ecs_create(GFraMe_ecs *ecs, GFraMe_ecs_entity *ent);
+
+/**
+ * Destroy an entity and all of its components
+ * @param	*ecs	The store
+ * @param	ent	The entity
+ */
+void GFraMe_ecs_destroy(GFraMe_ecs *ecs, GFraMe_ecs_entity ent);
+
+/**
+ * Add a component to an entity; new components are zeroed
+ * @param	*ecs	The store
+ * @param	ent	The entity
+ * @param	comp	The component type
+ * @return	The component (the existing one, if the entity already had it) or
+ *			NULL, if the entity is stale
+ */
+void *GFraMe_ecs_add(GFraMe_ecs *ecs, GFraMe_ecs_entity ent,
+					 GFraMe_ecs_component comp);
+
+/**
+ * Remove a component from an entity
+ * @param	*ecs	The store
+ * @param	ent	The entity
+ * @param	comp	The component type
+ */
+void GFraMe_ecs_remove(GFraMe_ecs *ecs, GFraMe_ecs_entity ent,
+					   GFraMe_ecs_component comp);
+
+/**
+ * Get an entity's component
+ * @param	*ecs	The store
+ * @param	ent	The entity
+ * @param	comp	The component type
+ * @return	The component or NULL, if the entity doesn't have it (or is stale)
+ */
+void *GFraMe_ecs_get(GFraMe_ecs *ecs, GFraMe_ecs_entity ent,
+					 GFraMe_ecs_component comp);
+
+/**
+ * Move every entity, either by its tween or by its physics (tweens take
+ *precedence, just like on GFraMe_object_update)
+ * @param	*ecs	The store
+ * @param	ms	Time elapsed, in milliseconds
+ */
+void GFraMe_ecs_update(GFraMe_ecs *ecs, int ms);
+
+/**
+ * Update every animation, setting the new tile on the entity's render
+ *component; finished animations are removed
+ * @param	*ecs	The store
+ * @param	ms	Time elapsed, in milliseconds
+ */
+void GFraMe_ecs_animate(GFraMe_ecs *ecs, int ms);
+
+/**
+ * Draw every visible entity
+ * @param	*ecs	The store
+ */
+void GFraMe_ecs_draw(GFraMe_ecs *ecs);
+
+/**
+ * Create an entity from a sprite, copying its object, hitbox, tween, render
+ *data and current animation (if any) into components
+ * @param	*ecs	The store
+ * @param	*ent	Returns the entity
+ * @param	*spr	The sprite
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - The store is full
+ */
+GFraMe_ret GFraMe_ecs_add_sprite(GFraMe_ecs *ecs, GFraMe_ecs_entity *ent,
+								 GFraMe_sprite *spr);
+
+/**
+ * Copy an entity's components back into a sprite; the sprite's animation is
+ *only updated if it already had one (since the entity's animation can't be
+ *pointed to)
+ * @param	*ecs	The store
+ * @param	ent	The entity
+ * @param	*spr	The sprite
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Stale entity
+ */
+GFraMe_ret GFraMe_ecs_get_sprite(GFraMe_ecs *ecs, GFraMe_ecs_entity ent,
+								 GFraMe_sprite *spr);
+
+#endif
+
@@ -5,6 +5,7 @@
 #define __GFRAME_EVENT_H_
 
 #include <GFraMe/GFraMe_accumulator.h>
+#include <GFraMe/GFraMe_clock.h>
 #include <GFraMe/GFraMe_controller.h>
 #include <GFraMe/GFraMe_error.h>
 #include <GFraMe/GFraMe_pointer.h>
@@ -18,19 +19,37 @@
 #define	__updacc__		__FILE__##__gframe_upd_acc
 #define __drawacc__		__FILE__##__gframe_draw_acc
 #define GFraMe_event_elapsed	__FILE__##__gframe_elapsed_time
+#define __clock__		__FILE__##__gframe_clock
+#define GFraMe_event_alpha	__FILE__##__gframe_draw_alpha
 
 #define GFraMe_event_setup() \
 	static Uint32 __dt__; \
 	static Uint32 __lasttime__; \
 	static GFraMe_accumulator __updacc__; \
 	static GFraMe_accumulator __drawacc__; \
-	static int GFraMe_event_elapsed
+	static int GFraMe_event_elapsed; \
+	static float GFraMe_event_alpha
 
 #define GFraMe_event_init(update_fps, draw_fps) \
 	__lasttime__ = SDL_GetTicks(); \
 	GFraMe_accumulator_init_fps(&__updacc__, update_fps, 6); \
 	GFraMe_accumulator_init_fps(&__drawacc__, draw_fps, 1); \
 
+/**
+ * Alternative setup, driven by a GFraMe_clock instead of the timer's events
+ *(GFraMe_init should be called with fps 0, so no timer is created); use it
+ *with GFraMe_event_clock_init, GFraMe_event_clock_begin,
+ *GFraMe_event_clock_update_begin and GFraMe_event_clock_draw_begin (every
+ *other macro, but GFraMe_event_on_timer, is shared)
+ */
+#define GFraMe_event_clock_setup() \
+	static GFraMe_clock __clock__; \
+	static int GFraMe_event_elapsed; \
+	static float GFraMe_event_alpha
+
+#define GFraMe_event_clock_init(update_fps, draw_fps) \
+	GFraMe_clock_init(&__clock__, update_fps, draw_fps, 6)
+
 #define GFraMe_event_begin() \
 	SDL_Event event; \
 	GFraMe_SDLassertRet(SDL_WaitEvent(&event) == 1, "Failed while waiting for events", __gframe_event_err_); \
@@ -39,6 +58,20 @@
 			/* 'Null' case*/ \
 			case 0:
 
+/**
+ * Wait until an update or a draw is due, then poll every pending event
+ */
+#define GFraMe_event_clock_begin() \
+	SDL_Event event; \
+	GFraMe_clock_wait(&__clock__); \
+	GFraMe_clock_tick(&__clock__); \
+	if (SDL_PollEvent(&event) == 0) \
+		goto __gframe_event_err_; \
+	while (1) { \
+		switch (event.type) { \
+			/* 'Null' case*/ \
+			case 0:
+
 #define GFraMe_event_on_timer() \
 			/* Close previous case */ \
 			break; \
@@ -139,11 +172,25 @@ __gframe_event_err_: \
 	while (GFraMe_accumulator_loop(&__updacc__)) { \
 		GFraMe_event_elapsed = __updacc__.timeout
 
+#define GFraMe_event_clock_update_begin() \
+	while (GFraMe_clock_update(&__clock__)) { \
+		GFraMe_event_elapsed = __clock__.elapsed
+
 #define GFraMe_event_update_end() \
 	}
 
+/**
+ * Begin drawing; GFraMe_event_alpha is set to how far into the next update
+ * it is (e.g., for GFraMe_sprite_draw_lerp)
+ */
 #define GFraMe_event_draw_begin() \
 	if (GFraMe_accumulator_loop(&__drawacc__)) { \
+		GFraMe_event_alpha = GFraMe_accumulator_alpha(&__updacc__); \
+		GFraMe_init_render()
+
+#define GFraMe_event_clock_draw_begin() \
+	if (GFraMe_clock_draw(&__clock__)) { \
+		GFraMe_event_alpha = GFraMe_clock_alpha(&__clock__); \
 		GFraMe_init_render()
 
 #define GFraMe_event_draw_end() \
@@ -0,0 +1,170 @@
+/**
+ * @include/GFraMe/GFraMe_mixer.h
+ *
+ * Mixing kernels used by the audio player. Every voice is accumulated into an
+ *int32 buffer (so any number of voices may overlap without wrapping around)
+ *and the result is saturated into signed 16 bits only once, at the end.
+ *
+ * Gains are Q15 fixed point (GFraMe_mixer_unity is 1.0), so the kernels run
+ *on SSE2 or NEON, when available (define GFRAME_NO_SIMD to disable them).
+ *Samples are signed 16 bits, in the machine's byte order.
+ */
+#ifndef __GFRAME_MIXER_H_
+#define __GFRAME_MIXER_H_
+
+#include <SDL2/SDL_stdinc.h>
+
+/**
+ * Q15 gain of 1.0 (saturated to fit a Sint16)
+ */
+#define GFraMe_mixer_unity	32767
+
+/**
+ * State of an audio being resampled, kept between calls so it may be
+ *resampled in parts of any length (and give the same output as in one pass)
+ */
+struct stGFraMe_mixer_resampler {
+	/**
+	 * Position between the last frame and the next one, in 16.16 fixed point
+	 */
+	Uint32 frac;
+	/**
+	 * Frames read but not yet passed, starting at the one just before the
+	 *current position
+	 */
+	Sint16 carry[4];
+	/**
+	 * How many frames were carried over
+	 */
+	int num_carry;
+};
+typedef struct stGFraMe_mixer_resampler GFraMe_mixer_resampler;
+
+/**
+ * Convert a volume into a Q15 gain
+ * @param	volume	The volume, from 0.0 to 1.0 (it's clamped)
+ * @return	The gain
+ */
+Sint16 GFraMe_mixer_get_gain(double volume);
+
+/**
+ * Add interleaved stereo samples (i.e., same layout as the accumulator),
+ *scaled by each channel's gain, into an accumulator
+ * @param	*acc	The accumulator
+ * @param	*src	The samples (needn't be aligned)
+ * @param	num	How many samples there are (twice the frames)
+ * @param	lgain	Q15 gain of the left channel
+ * @param	rgain	Q15 gain of the right channel
+ */
+void GFraMe_mixer_add(Sint32 *acc, const Sint16 *src, int num, Sint16 lgain,
+					  Sint16 rgain);
+
+/**
+ * Add mono samples into both channels of a stereo accumulator, scaled by
+ *each channel's gain (i.e., panned)
+ * @param	*acc	The accumulator (with 2 * num samples)
+ * @param	*src	The samples (needn't be aligned)
+ * @param	num	How many (mono) samples there are
+ * @param	lgain	Q15 gain of the left channel
+ * @param	rgain	Q15 gain of the right channel
+ */
+void GFraMe_mixer_add_mono(Sint32 *acc, const Sint16 *src, int num,
+						   Sint16 lgain, Sint16 rgain);
+
+/**
+ * Saturate an accumulator into signed 16 bits samples
+ * @param	*dst	The output
+ * @param	*acc	The accumulator
+ * @param	num	How many samples there are
+ */
+void GFraMe_mixer_saturate(Sint16 *dst, const Sint32 *acc, int num);
+
+/**
+ * Scale a stereo accumulator by a gain that may be ramping towards another
+ * @param	*acc	The accumulator
+ * @param	frames	How many (stereo) frames there are
+ * @param	*gain	The current gain; updated to the gain after the last frame
+ * @param	step	How much the gain changes per frame
+ * @param	ramp	For how many frames the gain changes (the rest is constant)
+ */
+void GFraMe_mixer_gain(Sint32 *acc, int frames, float *gain, float step,
+					   int ramp);
+
+/**
+ * Filter a stereo accumulator through a one-pole low-pass
+ * @param	*acc	The accumulator
+ * @param	frames	How many (stereo) frames there are
+ * @param	coef	The filter's coefficient (from 0.0 to 1.0; see
+ *GFraMe_mixer_get_lowpass)
+ * @param	*state	Last output, for each channel
+ */
+void GFraMe_mixer_lowpass(Sint32 *acc, int frames, float coef, float *state);
+
+/**
+ * Get a one-pole low-pass' coefficient
+ * @param	cutoff	The cutoff frequency, in Hz
+ * @param	freq	The sample rate, in Hz
+ * @return	The coefficient
+ */
+float GFraMe_mixer_get_lowpass(double cutoff, int freq);
+
+/**
+ * Get how many source frames are advanced per output frame
+ * @param	src_freq	The source's sample rate, in Hz
+ * @param	dst_freq	The output's sample rate, in Hz
+ * @return	The step, in 16.16 fixed point
+ */
+Uint32 GFraMe_mixer_get_step(int src_freq, int dst_freq);
+
+/**
+ * Start resampling from silence
+ * @param	*rs	The resampler
+ */
+void GFraMe_mixer_init_resampler(GFraMe_mixer_resampler *rs);
+
+/**
+ * Prepare the source of the next part: copy the carried frames into its start
+ *and get how many frames must be read after those (i.e., at
+ *src + rs->num_carry * chans). If the source is shorter, it must be padded
+ *with silence
+ * @param	*rs	The resampler
+ * @param	*src	The source's buffer
+ * @param	*frames	How many (output) frames should be resampled; updated to
+ *how many fit the source's buffer
+ * @param	max	How many frames fit the source's buffer (at least 4)
+ * @param	step	Source frames per output frame (see GFraMe_mixer_get_step)
+ * @param	chans	How many channels there are (1 or 2)
+ * @return	How many frames must be read
+ */
+int GFraMe_mixer_resample_begin(GFraMe_mixer_resampler *rs, Sint16 *src,
+								int *frames, int max, Uint32 step, int chans);
+
+/**
+ * Resample a part (linearly interpolating between its frames) and keep the
+ *frames that weren't passed for the next one
+ * @param	*rs	The resampler
+ * @param	*dst	The output (interleaved, if stereo)
+ * @param	*src	The source, as prepared by GFraMe_mixer_resample_begin
+ * @param	frames	How many (output) frames should be resampled (as updated by
+ *GFraMe_mixer_resample_begin)
+ * @param	step	Source frames per output frame (see GFraMe_mixer_get_step)
+ * @param	chans	How many channels there are (1 or 2)
+ */
+void GFraMe_mixer_resample(GFraMe_mixer_resampler *rs, Sint16 *dst,
+						   const Sint16 *src, int frames, Uint32 step,
+						   int chans);
+
+/**
+ * Advance the resampler without any output
+ * @param	*rs	The resampler
+ * @param	frames	How many (output) frames should be skipped
+ * @param	step	Source frames per output frame (see GFraMe_mixer_get_step)
+ * @param	chans	How many channels there are (1 or 2)
+ * @return	How many source frames must be skipped (the resampler restarts
+ *from silence, if any)
+ */
+int GFraMe_mixer_resample_skip(GFraMe_mixer_resampler *rs, int frames,
+							   Uint32 step, int chans);
+
+#endif
+
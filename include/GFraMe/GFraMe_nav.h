@@ -0,0 +1,216 @@
+/**
+ * @include/GFraMe/GFraMe_nav.h
+ *
+ * Navigation over a tilemap's solid tiles, in tile coordinates. Single
+ *queries use A* with jump point search; many agents chasing the same target
+ *should instead read their next step from a flow field (a Dijkstra map
+ *built from the target outward).
+ *
+ * Diagonal moves are only allowed if both orthogonal tiles are free (i.e.,
+ *corners are never cut). Straight moves cost 10 and diagonal ones cost 14.
+ *
+ * Flow fields are built a few nodes at a time (see GFraMe_nav_step), so
+ *rebuilds may be spread across frames; the previous field is kept readable
+ *until the new one is complete. Freeing a tile only propagates the shorter
+ *distances around it, while blocking one rebuilds the whole field.
+ */
+#ifndef __GFRAME_NAV_H_
+#define __GFRAME_NAV_H_
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_tilemap.h>
+
+/**
+ * Distance of tiles that can't reach the target
+ */
+#define GFraMe_nav_unreachable	0x7fffffff
+
+/**
+ * Binary min-heap of tiles
+ */
+struct stGFraMe_nav_heap {
+	/**
+	 * Each item's priority
+	 */
+	int *keys;
+	/**
+	 * Each item's tile
+	 */
+	int *tiles;
+	/**
+	 * How many items there are
+	 */
+	int len;
+	/**
+	 * How many items fit on the current buffers
+	 */
+	int max;
+};
+typedef struct stGFraMe_nav_heap GFraMe_nav_heap;
+
+/**
+ * What the flow field is currently doing
+ */
+enum enGFraMe_nav_mode {
+	/**
+	 * The field is up to date
+	 */
+	GFraMe_nav_idle = 0,
+	/**
+	 * A new field is being built (the current one is still readable)
+	 */
+	GFraMe_nav_building,
+	/**
+	 * Shorter distances are being propagated on the current field
+	 */
+	GFraMe_nav_repairing
+};
+typedef enum enGFraMe_nav_mode GFraMe_nav_mode;
+
+struct stGFraMe_nav {
+	/**
+	 * How many tiles there are horizontally
+	 */
+	int width;
+	/**
+	 * How many tiles there are vertically
+	 */
+	int height;
+	/**
+	 * Whether each tile is solid (a copy of the tilemap's)
+	 */
+	char *solid;
+	/**
+	 * Cost from the start to each tile (A*)
+	 */
+	int *cost;
+	/**
+	 * Tile from where each tile was reached (A*)
+	 */
+	int *parent;
+	/**
+	 * Search in which each tile was last reached (A*)
+	 */
+	int *visited;
+	/**
+	 * Search in which each tile was last closed (A*)
+	 */
+	int *closed;
+	/**
+	 * Current search (A*)
+	 */
+	int search;
+	/**
+	 * Open tiles (A*)
+	 */
+	GFraMe_nav_heap open;
+	/**
+	 * Distance from each tile to the target (the field being read and the
+	 *one being built)
+	 */
+	int *dist[2];
+	/**
+	 * Direction (0 to 7, clockwise from the right; -1 if none) toward the
+	 *target on each tile
+	 */
+	signed char *dir[2];
+	/**
+	 * Which field is the one being read
+	 */
+	int front;
+	/**
+	 * Flow field's target tile (-1 if none)
+	 */
+	int target;
+	/**
+	 * What the flow field is doing
+	 */
+	GFraMe_nav_mode mode;
+	/**
+	 * Tiles whose neighbours must be updated (flow field)
+	 */
+	GFraMe_nav_heap pending;
+};
+typedef struct stGFraMe_nav GFraMe_nav;
+
+/**
+ * Initialize the navigation over a tilemap; the tilemap must have been
+ *initialized with collideable tiles
+ * @param	*nav	The navigation
+ * @param	*tmap	The tilemap
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_nav_init(GFraMe_nav *nav, GFraMe_tilemap *tmap);
+
+/**
+ * Release every memory alloc'ed by the navigation
+ * @param	*nav	The navigation
+ */
+void GFraMe_nav_clear(GFraMe_nav *nav);
+
+/**
+ * Change whether a tile is solid, updating the flow field accordingly
+ * @param	*nav	The navigation
+ * @param	x	Tile's column
+ * @param	y	Tile's row
+ * @param	solid	Whether it's now solid
+ */
+void GFraMe_nav_set_solid(GFraMe_nav *nav, int x, int y, int solid);
+
+/**
+ * Find the shortest path between two tiles
+ * @param	*nav	The navigation
+ * @param	*path	Returns each tile (index) on the path, excluding the start
+ *					one (may be NULL)
+ * @param	max_len	How many tiles fit on the path
+ * @param	*len	Returns how many tiles the whole path has
+ * @param	sx	Start tile's column
+ * @param	sy	Start tile's row
+ * @param	gx	Goal tile's column
+ * @param	gy	Goal tile's row
+ * @return	GFraMe_ret_ok - Found; GFraMe_ret_failed - Unreachable;
+ *			Anything else - Failure
+ */
+GFraMe_ret GFraMe_nav_find_path(GFraMe_nav *nav, int *path, int max_len,
+								int *len, int sx, int sy, int gx, int gy);
+
+/**
+ * Set the flow field's target; the field is only rebuilt by GFraMe_nav_step
+ * @param	*nav	The navigation
+ * @param	x	Target's column
+ * @param	y	Target's row
+ */
+void GFraMe_nav_set_target(GFraMe_nav *nav, int x, int y);
+
+/**
+ * Update the flow field, processing a limited number of tiles
+ * @param	*nav	The navigation
+ * @param	max_tiles	How many tiles may be processed (0 or less for all)
+ * @return	1 - The field is up to date; 0 - There's still work to do
+ */
+int GFraMe_nav_step(GFraMe_nav *nav, int max_tiles);
+
+/**
+ * Get a tile's distance to the flow field's target
+ * @param	*nav	The navigation
+ * @param	x	Tile's column
+ * @param	y	Tile's row
+ * @return	The distance (10 per tile) or GFraMe_nav_unreachable
+ */
+int GFraMe_nav_get_distance(GFraMe_nav *nav, int x, int y);
+
+/**
+ * Get the next tile toward the flow field's target
+ * @param	*nav	The navigation
+ * @param	*nx	Returns the next tile's column
+ * @param	*ny	Returns the next tile's row
+ * @param	x	Current tile's column
+ * @param	y	Current tile's row
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - Already on the
+ *			target or it's unreachable
+ */
+GFraMe_ret GFraMe_nav_get_next(GFraMe_nav *nav, int *nx, int *ny, int x,
+							   int y);
+
+#endif
+
@@ -113,6 +113,29 @@ struct stGFraMe_object {
 	 * The object's tween
 	 */
 	GFraMe_tween tween;
+	/**
+	 * Bitfield with the layers this object belongs to (on a collision world)
+	 */
+	unsigned int category;
+	/**
+	 * Bitfield with the layers this object collides against
+	 */
+	unsigned int mask;
+	/**
+	 * Whether the object is sleeping (i.e., a collision world neither updates
+	 * it nor collides it against other sleeping objects); it's cleared
+	 * whenever the object's position is set
+	 */
+	int sleeping;
+	/**
+	 * Whether the object never moves by itself (e.g., walls); it's kept
+	 * asleep, but awake objects still collide against it
+	 */
+	int is_static;
+	/**
+	 * For how long the object has been at rest (in milliseconds)
+	 */
+	int idle_time;
 };
 typedef struct stGFraMe_object GFraMe_object;
 
@@ -144,6 +167,50 @@ void GFraMe_object_set_y(GFraMe_object *obj, int Y);
  */
 void GFraMe_object_set_pos(GFraMe_object *obj, int X, int Y);
 
+/**
+ * Get an object's position interpolated between its last and current update
+ * @param	*obj	The object
+ * @param	alpha	How far into the next update it is (0.0 is the last
+ *				position and 1.0 the current one)
+ * @param	*X	Returns the horizontal position
+ * @param	*Y	Returns the vertical position
+ */
+void GFraMe_object_get_lerp_pos(GFraMe_object *obj, float alpha, int *X,
+								int *Y);
+
+/**
+ * Sets in which layers an object is and against which layers it collides;
+ * two objects only collide, on a collision world, if each one's category
+ * matches the other's mask
+ * @param	*obj	The object
+ * @param	category	Bitfield of layers the object belongs to
+ * @param	mask	Bitfield of layers the object collides against
+ */
+void GFraMe_object_set_layer(GFraMe_object *obj, unsigned int category,
+							 unsigned int mask);
+
+/**
+ * Sets whether an object is static; static objects are never updated by a
+ * collision world, but still collide against awake objects
+ * @param	*obj	The object
+ * @param	is_static	Whether it's static
+ */
+void GFraMe_object_set_static(GFraMe_object *obj, int is_static);
+
+/**
+ * Wakes an object, so a collision world will update it again; changing its
+ * velocity, acceleration, tween or position already wakes it
+ * @param	*obj	The object
+ */
+void GFraMe_object_wake(GFraMe_object *obj);
+
+/**
+ * Check whether an object is at rest (i.e., not moving nor tweening)
+ * @param	*obj	The object
+ * @return	1 - It's at rest; 0 - It's moving
+ */
+int GFraMe_object_is_idle(GFraMe_object *obj);
+
 /**
  * Updates an object's position, velocity and collision state
  * @param	*obj	Object to be update
@@ -161,6 +228,32 @@ void GFraMe_object_update(GFraMe_object *obj, int ms);
 GFraMe_ret GFraMe_object_overlap(GFraMe_object *o1, GFraMe_object *o2,
 						   GFraMe_collision_type mode);
 
+/**
+ * Calculate when, between their last and current positions, two objects
+ * start overlapping; both are considered to move linearly
+ * @param	*o1	One of the objects
+ * @param	*o2	The other object
+ * @param	*toi	Returns the time of impact, in the range [0, 1)
+ * @param	*hcol	Returns whether they touched horizontally
+ * @param	*vcol	Returns whether they touched vertically
+ * @return	GFraMe_ret_ok - if they hit; GFraMe_ret_no_overlap - otherwise
+ */
+GFraMe_ret GFraMe_object_sweep_toi(GFraMe_object *o1, GFraMe_object *o2,
+								   double *toi, int *hcol, int *vcol);
+
+/**
+ * Overlaps two objects, according to the mode passed, but checking the whole
+ * movement since the last frame; this avoids fast objects from tunneling
+ * through thin ones. If the objects were already overlapping on the previous
+ * frame, it works exactly as GFraMe_object_overlap
+ * @param	*o1	One of the objects to be overlaped
+ * @param	*o2	The other object to be overlaped
+ * @param	mode	How collision should be handle
+ * @return	Whether an overlap occured (GFraMe_ret_ok) or not (GFraMe_ret_no_overlap)
+ */
+GFraMe_ret GFraMe_object_sweep(GFraMe_object *o1, GFraMe_object *o2,
+							   GFraMe_collision_type mode);
+
 GFraMe_hitbox *GFraMe_object_get_hitbox(GFraMe_object *obj);
 
 GFraMe_tween *GFraMe_object_get_tween(GFraMe_object *obj);
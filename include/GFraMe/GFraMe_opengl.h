@@ -19,6 +19,9 @@ void GFraMe_opengl_prepareRender();
 void GFraMe_opengl_setRotation(float rotation);
 void GFraMe_opengl_setScale(float sX, float sY);
 void GFraMe_opengl_setAlpha(float alpha);
+void GFraMe_opengl_setTime(float ms);
+void GFraMe_opengl_setAnimation(int first, int num, float fps, float start,
+	int columns);
 
 void GFraMe_opengl_renderSprite(int x, int y, int dx, int dy, int tx, int ty);
 
@@ -0,0 +1,143 @@
+/**
+ * @include/GFraMe/GFraMe_pool.h
+ *
+ * Fixed size pool of items (e.g., GFraMe_sprite or GFraMe_object). Free slots
+ *are kept on an intrusive free list (the next free slot is stored on the slot
+ *itself), so acquiring and releasing are O(1); live items are also listed
+ *densely, so they may be iterated without checking every slot.
+ *
+ * Items never move while they're alive, so pointers to them (and into them,
+ *like a sprite's animation) stay valid until they are released. Handles carry
+ *a generation counter, so a handle to a released (and possibly reused) slot
+ *is detected as stale.
+ */
+#ifndef __GFRAME_POOL_H_
+#define __GFRAME_POOL_H_
+
+#include <GFraMe/GFraMe_error.h>
+
+/**
+ * How many bits of a handle are used by the slot (the rest being used by the
+ *generation)
+ */
+#define GFraMe_pool_slot_bits	20
+/**
+ * Maximum number of items in a pool
+ */
+#define GFraMe_pool_max_items	(1 << GFraMe_pool_slot_bits)
+
+/**
+ * Handle to an item; 0 is never a valid handle
+ */
+typedef unsigned int GFraMe_pool_handle;
+
+struct stGFraMe_pool {
+	/**
+	 * Every slot, live or not
+	 */
+	char *items;
+	/**
+	 * Size of each item (at least sizeof(int))
+	 */
+	int item_size;
+	/**
+	 * How many slots there are
+	 */
+	int max_items;
+	/**
+	 * Current generation of each slot
+	 */
+	unsigned int *gens;
+	/**
+	 * Slot of each live item, packed
+	 */
+	int *live;
+	/**
+	 * Position of each slot on the live list
+	 */
+	int *live_pos;
+	/**
+	 * How many items are alive (i.e., valid positions on the live list)
+	 */
+	int len;
+	/**
+	 * First free slot (-1 if the pool is full)
+	 */
+	int free_slot;
+};
+typedef struct stGFraMe_pool GFraMe_pool;
+
+/**
+ * Initialize a pool, allocating every slot
+ * @param	*pool	The pool
+ * @param	item_size	Size of each item
+ * @param	max_items	How many items the pool may hold
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_pool_init(GFraMe_pool *pool, int item_size, int max_items);
+
+/**
+ * Release every memory alloc'ed by the pool
+ * @param	*pool	The pool
+ */
+void GFraMe_pool_clear(GFraMe_pool *pool);
+
+/**
+ * Release every live item (every handle becomes stale)
+ * @param	*pool	The pool
+ */
+void GFraMe_pool_reset(GFraMe_pool *pool);
+
+/**
+ * Get a new item; its memory is NOT cleared
+ * @param	*pool	The pool
+ * @param	*handle	Returns the item's handle (may be NULL)
+ * @param	**item	Returns the item
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - The pool is full
+ */
+GFraMe_ret GFraMe_pool_acquire(GFraMe_pool *pool, GFraMe_pool_handle *handle,
+							   void **item);
+
+/**
+ * Release an item; the last item on the live list is moved to its position
+ *(so, when releasing while iterating, the current position must be visited
+ *again)
+ * @param	*pool	The pool
+ * @param	handle	The item's handle
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Stale handle
+ */
+GFraMe_ret GFraMe_pool_release(GFraMe_pool *pool, GFraMe_pool_handle handle);
+
+/**
+ * Release the item at a position of the live list
+ * @param	*pool	The pool
+ * @param	i	Position on the live list (from 0 to pool->len - 1)
+ */
+void GFraMe_pool_release_at(GFraMe_pool *pool, int i);
+
+/**
+ * Get an item from its handle
+ * @param	*pool	The pool
+ * @param	handle	The item's handle
+ * @return	The item or NULL, if the handle is stale
+ */
+void *GFraMe_pool_get(GFraMe_pool *pool, GFraMe_pool_handle handle);
+
+/**
+ * Get the item at a position of the live list
+ * @param	*pool	The pool
+ * @param	i	Position on the live list (from 0 to pool->len - 1)
+ * @return	The item
+ */
+void *GFraMe_pool_at(GFraMe_pool *pool, int i);
+
+/**
+ * Get the handle of the item at a position of the live list
+ * @param	*pool	The pool
+ * @param	i	Position on the live list (from 0 to pool->len - 1)
+ * @return	The item's handle
+ */
+GFraMe_pool_handle GFraMe_pool_handle_at(GFraMe_pool *pool, int i);
+
+#endif
+
@@ -0,0 +1,131 @@
+/**
+ * @include/GFraMe/GFraMe_raycast.h
+ *
+ * Helpers for casting segments: a segment-vs-AABB test and a grid walker
+ *(Amanatides & Woo's DDA), which visits every cell crossed by a segment, in
+ *order, without ever skipping a corner.
+ */
+#ifndef __GFRAME_RAYCAST_H_
+#define __GFRAME_RAYCAST_H_
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+
+/**
+ * Result of a raycast
+ */
+struct stGFraMe_raycast_hit {
+	/**
+	 * Whether anything was hit
+	 */
+	int did_hit;
+	/**
+	 * Where, along the segment, it hit ([0, 1], 0 being its start)
+	 */
+	double t;
+	/**
+	 * Horizontal position of the hit
+	 */
+	double x;
+	/**
+	 * Vertical position of the hit
+	 */
+	double y;
+	/**
+	 * Face that was hit (e.g., GFraMe_direction_left is hit by a segment
+	 *going right); GFraMe_direction_none if the segment started inside it
+	 */
+	GFraMe_direction face;
+	/**
+	 * Object that was hit (only set by collision world casts)
+	 */
+	GFraMe_object *obj;
+	/**
+	 * Column of the tile that was hit (only set by tilemap casts)
+	 */
+	int tile_x;
+	/**
+	 * Row of the tile that was hit (only set by tilemap casts)
+	 */
+	int tile_y;
+};
+typedef struct stGFraMe_raycast_hit GFraMe_raycast_hit;
+
+/**
+ * Grid walker; every field is read only
+ */
+struct stGFraMe_raycast_dda {
+	/**
+	 * Current cell's column
+	 */
+	int cx;
+	/**
+	 * Current cell's row
+	 */
+	int cy;
+	/**
+	 * Where, along the segment, the current cell was entered
+	 */
+	double t;
+	/**
+	 * Face through which the current cell was entered
+	 */
+	GFraMe_direction face;
+	int step_x;
+	int step_y;
+	double t_max_x;
+	double t_max_y;
+	double t_delta_x;
+	double t_delta_y;
+	double t_end;
+	int columns;
+	int rows;
+};
+typedef struct stGFraMe_raycast_dda GFraMe_raycast_dda;
+
+/**
+ * Cast a segment against an AABB
+ * @param	*hit	Returns where it was hit (only set on hits)
+ * @param	x0	Segment's horizontal start
+ * @param	y0	Segment's vertical start
+ * @param	x1	Segment's horizontal end
+ * @param	y1	Segment's vertical end
+ * @param	l	Box's left edge
+ * @param	t	Box's top edge
+ * @param	r	Box's right edge
+ * @param	b	Box's bottom edge
+ * @return	GFraMe_ret_ok - Hit; GFraMe_ret_no_overlap - Missed
+ */
+GFraMe_ret GFraMe_raycast_aabb(GFraMe_raycast_hit *hit, double x0, double y0,
+							   double x1, double y1, double l, double t,
+							   double r, double b);
+
+/**
+ * Start walking a grid, placing the walker on the first cell crossed by the
+ *segment; coordinates are relative to the grid's upper left corner
+ * @param	*dda	The walker
+ * @param	x0	Segment's horizontal start
+ * @param	y0	Segment's vertical start
+ * @param	x1	Segment's horizontal end
+ * @param	y1	Segment's vertical end
+ * @param	cell_w	Width of each cell
+ * @param	cell_h	Height of each cell
+ * @param	columns	How many cells there are horizontally
+ * @param	rows	How many cells there are vertically
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_no_overlap - The segment
+ *			doesn't cross the grid
+ */
+GFraMe_ret GFraMe_raycast_dda_init(GFraMe_raycast_dda *dda, double x0,
+								   double y0, double x1, double y1,
+								   double cell_w, double cell_h, int columns,
+								   int rows);
+
+/**
+ * Move the walker to the next cell crossed by the segment
+ * @param	*dda	The walker
+ * @return	1 - Moved; 0 - The segment ended (or left the grid)
+ */
+int GFraMe_raycast_dda_next(GFraMe_raycast_dda *dda);
+
+#endif
+
@@ -0,0 +1,86 @@
+/**
+ * @include/GFraMe/GFraMe_reverb.h
+ *
+ * Small Schroeder reverb (four parallel feedback combs followed by two
+ *all-passes), used as the send effect of the audio buses. Its input is mixed
+ *into mono and its (wet only) output is added to both channels.
+ */
+#ifndef __GFRAME_REVERB_H_
+#define __GFRAME_REVERB_H_
+
+#include <GFraMe/GFraMe_error.h>
+#include <SDL2/SDL_stdinc.h>
+
+#define GFraMe_reverb_num_combs	4
+#define GFraMe_reverb_num_allpass	2
+
+struct stGFraMe_reverb {
+	/**
+	 * Every delay line, one after the other
+	 */
+	float *lines;
+	/**
+	 * Length of each comb's delay line
+	 */
+	int comb_len[GFraMe_reverb_num_combs];
+	/**
+	 * Current position on each comb
+	 */
+	int comb_pos[GFraMe_reverb_num_combs];
+	/**
+	 * Damping filter's state, for each comb
+	 */
+	float comb_lp[GFraMe_reverb_num_combs];
+	/**
+	 * Length of each all-pass' delay line
+	 */
+	int ap_len[GFraMe_reverb_num_allpass];
+	/**
+	 * Current position on each all-pass
+	 */
+	int ap_pos[GFraMe_reverb_num_allpass];
+	/**
+	 * How much of each comb's output is fed back (i.e., the room size)
+	 */
+	float feedback;
+	/**
+	 * How much the high frequencies are damped on each pass
+	 */
+	float damp;
+};
+typedef struct stGFraMe_reverb GFraMe_reverb;
+
+/**
+ * Initialize a reverb
+ * @param	*rev	The reverb
+ * @param	freq	The sample rate, in Hz (the delays are scaled to it)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_reverb_init(GFraMe_reverb *rev, int freq);
+
+/**
+ * Release a reverb's delay lines
+ * @param	*rev	The reverb
+ */
+void GFraMe_reverb_clear(GFraMe_reverb *rev);
+
+/**
+ * Set the reverb's parameters
+ * @param	*rev	The reverb
+ * @param	room	Room size, from 0.0 to 1.0
+ * @param	damp	Damping, from 0.0 to 1.0
+ */
+void GFraMe_reverb_set(GFraMe_reverb *rev, double room, double damp);
+
+/**
+ * Run the reverb over some frames
+ * @param	*rev	The reverb
+ * @param	*dst	Stereo accumulator where the output is added
+ * @param	*src	Stereo input
+ * @param	frames	How many frames there are
+ */
+void GFraMe_reverb_process(GFraMe_reverb *rev, Sint32 *dst, const Sint32 *src,
+						   int frames);
+
+#endif
+
@@ -0,0 +1,100 @@
+/**
+ * @include/GFraMe/GFraMe_ringbuf.h
+ *
+ * Lock-free single-producer/single-consumer ring of bytes. One thread may
+ *write while another reads, without any lock, as long as there's only one of
+ *each (e.g., the game thread sending commands to the audio callback).
+ *
+ * The read and write counters only ever increase (wrapping around), so a full
+ *ring is told apart from an empty one without wasting a byte; the capacity is
+ *always a power of two.
+ */
+#ifndef __GFRAME_RINGBUF_H_
+#define __GFRAME_RINGBUF_H_
+
+#include <GFraMe/GFraMe_error.h>
+#include <SDL2/SDL_atomic.h>
+
+struct stGFraMe_ringbuf {
+	/**
+	 * The ring's memory
+	 */
+	char *buf;
+	/**
+	 * Capacity, in bytes (a power of two)
+	 */
+	int size;
+	/**
+	 * How many bytes were ever read (only written by the consumer)
+	 */
+	SDL_atomic_t head;
+	/**
+	 * How many bytes were ever written (only written by the producer)
+	 */
+	SDL_atomic_t tail;
+};
+typedef struct stGFraMe_ringbuf GFraMe_ringbuf;
+
+/**
+ * Initialize a ring
+ * @param	*rb	The ring
+ * @param	size	Minimum capacity, in bytes (rounded up to a power of two)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_ringbuf_init(GFraMe_ringbuf *rb, int size);
+
+/**
+ * Release the ring's memory
+ * @param	*rb	The ring
+ */
+void GFraMe_ringbuf_clear(GFraMe_ringbuf *rb);
+
+/**
+ * Discard everything on the ring; neither thread may be using it
+ * @param	*rb	The ring
+ */
+void GFraMe_ringbuf_reset(GFraMe_ringbuf *rb);
+
+/**
+ * Get how many bytes may be read
+ * @param	*rb	The ring
+ * @return	How many bytes were written but not yet read
+ */
+int GFraMe_ringbuf_get_used(GFraMe_ringbuf *rb);
+
+/**
+ * Get how many bytes may be written
+ * @param	*rb	The ring
+ * @return	How many bytes are free
+ */
+int GFraMe_ringbuf_get_free(GFraMe_ringbuf *rb);
+
+/**
+ * Write as much as fits into the ring; only the producer may call this
+ * @param	*rb	The ring
+ * @param	*data	What should be written
+ * @param	len	How many bytes should be written
+ * @return	How many bytes were written
+ */
+int GFraMe_ringbuf_write(GFraMe_ringbuf *rb, const void *data, int len);
+
+/**
+ * Read as much as is available from the ring; only the consumer may call this
+ * @param	*rb	The ring
+ * @param	*data	Where it should be read into
+ * @param	len	How many bytes should be read
+ * @return	How many bytes were read
+ */
+int GFraMe_ringbuf_read(GFraMe_ringbuf *rb, void *data, int len);
+
+/**
+ * Discard as much as is available from the ring (up to len bytes); only the
+ *consumer may call this
+ * @param	*rb	The ring
+ * @param	len	How many bytes should be discarded
+ * @return	How many bytes were discarded
+ */
+int GFraMe_ringbuf_skip(GFraMe_ringbuf *rb, int len);
+
+#endif
+
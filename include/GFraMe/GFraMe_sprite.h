@@ -107,6 +107,28 @@ void GFraMe_sprite_draw(GFraMe_sprite *spr);
  */
 void GFraMe_sprite_draw_camera(GFraMe_sprite *spr, int cam_x, int cam_y, int cam_w, int cam_h);
 
+/**
+ * Draw a sprite interpolated between its last and current update
+ * 
+ * @param *spr Sprite to be drawn
+ * @param alpha How far into the next update it is (e.g., GFraMe_event_alpha)
+ */
+void GFraMe_sprite_draw_lerp(GFraMe_sprite *spr, float alpha);
+
+/**
+ * Draw a sprite from world space into screen space, interpolated between its
+ * last and current update; the camera should be interpolated by the caller
+ * (e.g., through GFraMe_util_lerp)
+ * 
+ * @param *spr Sprite to be drawn
+ * @param alpha How far into the next update it is (e.g., GFraMe_event_alpha)
+ * @param cam_x The camera's horizontal position
+ * @param cam_y The camera's vertical position
+ * @param cam_w The camera's width
+ * @param cam_h The camera's height
+ */
+void GFraMe_sprite_draw_camera_lerp(GFraMe_sprite *spr, float alpha, int cam_x, int cam_y, int cam_w, int cam_h);
+
 /**
  * Change the sprite's animation
  * @param	*spr	Sprite to have it's animation changed
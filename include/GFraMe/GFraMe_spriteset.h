@@ -89,5 +89,29 @@ GFraMe_ret GFraMe_spriteset_draw(GFraMe_spriteset *sset, int tile, int x,
 GFraMe_ret GFraMe_spriteset_draw_ex(GFraMe_spriteset *sset, int tile,
 	GFraMe_ssetRenderCtx *ctx);
 
+/**
+ * Set the time used by looping tiles (usually, the time since the game
+ *started); on OpenGL, it's only uploaded once per frame
+ * @param	ms	Current time, in milliseconds
+ */
+void GFraMe_spriteset_set_time(int ms);
+
+/**
+ * Render a looping animation, whose frames are num_frames contiguous tiles.
+ *The current frame is calculated from the time set by
+ *GFraMe_spriteset_set_time (on OpenGL, by the vertex shader), so the
+ *animation never has to be updated
+ * @param	*sset	Spriteset used to render
+ * @param	first_tile	Animation's first tile
+ * @param	num_frames	How many frames there are in the animation
+ * @param	fps	At how many frames per second it should run
+ * @param	start_ms	When the animation started, in milliseconds
+ * @param	*ctx	Position and transformations
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spriteset_draw_looped(GFraMe_spriteset *sset,
+	int first_tile, int num_frames, int fps, int start_ms,
+	GFraMe_ssetRenderCtx *ctx);
+
 #endif
 
@@ -5,6 +5,7 @@
 #define __GFRAME_TILEMAP_H
 
 #include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_raycast.h>
 #include <GFraMe/GFraMe_spriteset.h>
 
 struct stGFraMe_tilemap {
@@ -13,13 +14,36 @@ struct stGFraMe_tilemap {
 	char *data;
 	int width_in_tiles;
 	int height_in_tiles;
+	/**
+	 * Whether each tile is solid (1) or not (0); used by raycasts
+	 */
+	char *solid;
+	/**
+	 * Objects covering every solid tile (on the tilemap's position)
+	 */
 	GFraMe_object *boxes;
+	/**
+	 * How many boxes there are
+	 */
+	int num_boxes;
+	/**
+	 * Position where the boxes were last placed
+	 */
+	int box_x;
+	int box_y;
 	GFraMe_spriteset *sset;
 };
 typedef struct stGFraMe_tilemap GFraMe_tilemap;
 
 /**
- * 
+ * How many times an object may be stopped by a tilemap's boxes on a single
+ * GFraMe_tilemap_sweep
+ */
+#define GFraMe_tilemap_max_sweeps	4
+
+/**
+ * Initialize a tilemap; if a spriteset and collideable tiles are supplied,
+ * solid tiles will be covered by as few boxes as possible
  * @param	*tmap	Tilemap to be initialized
  * @param	width_in_tiles	How many tiles there are horizontally
  * @param	height_in_tiles	How many tiles there are vertically
@@ -37,7 +61,76 @@ void GFraMe_tilemap_clear(GFraMe_tilemap *tmap);
 
 GFraMe_ret GFraMe_tilemap_draw(GFraMe_tilemap *tmap);
 
+/**
+ * Draw only the tiles inside a camera, from world space into screen space; to
+ * scroll smoothly between updates, pass a camera interpolated by the caller
+ * (e.g., through GFraMe_util_lerp)
+ * @param	*tmap	The tilemap
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_draw_camera(GFraMe_tilemap *tmap, int cam_x,
+									  int cam_y, int cam_w, int cam_h);
+
+/**
+ * Collide an object against every box on the tilemap; the tilemap is
+ * considered static
+ * @param	*tmap	The tilemap
+ * @param	*obj	Object to be collided
+ * @return	Whether an overlap occured (GFraMe_ret_ok) or not (GFraMe_ret_no_overlap)
+ */
 GFraMe_ret GFraMe_tilemap_overlap(GFraMe_tilemap *tmap,GFraMe_object *obj);
 
+/**
+ * Collide an object against every box on the tilemap, checking its whole
+ * movement since the last frame (so it won't tunnel through thin walls);
+ * the boxes are handled in the order they were hit
+ * @param	*tmap	The tilemap
+ * @param	*obj	Object to be collided
+ * @return	Whether an overlap occured (GFraMe_ret_ok) or not (GFraMe_ret_no_overlap)
+ */
+GFraMe_ret GFraMe_tilemap_sweep(GFraMe_tilemap *tmap, GFraMe_object *obj);
+
+/**
+ * Cast a segment against the tilemap's solid tiles
+ * @param	*tmap	The tilemap
+ * @param	*hit	Returns the first solid tile hit
+ * @param	x0	Segment's horizontal start (in world space)
+ * @param	y0	Segment's vertical start
+ * @param	x1	Segment's horizontal end
+ * @param	y1	Segment's vertical end
+ * @return	GFraMe_ret_ok - Hit; GFraMe_ret_no_overlap - Missed
+ */
+GFraMe_ret GFraMe_tilemap_raycast(GFraMe_tilemap *tmap,
+								  GFraMe_raycast_hit *hit, double x0,
+								  double y0, double x1, double y1);
+
+/**
+ * Check whether there's no solid tile between two points
+ * @param	*tmap	The tilemap
+ * @param	x0	First point's horizontal position
+ * @param	y0	First point's vertical position
+ * @param	x1	Second point's horizontal position
+ * @param	y1	Second point's vertical position
+ * @return	1 - They can see each other; 0 - Otherwise
+ */
+int GFraMe_tilemap_line_of_sight(GFraMe_tilemap *tmap, double x0, double y0,
+								 double x1, double y1);
+
+/**
+ * Cast many segments against the tilemap's solid tiles (e.g., a vision cone)
+ * @param	*tmap	The tilemap
+ * @param	*hits	Returns each segment's hit (did_hit is 0 on misses)
+ * @param	*segs	Segments, as x0, y0, x1, y1 (4 values per segment)
+ * @param	num	How many segments there are
+ * @return	How many segments hit a solid tile
+ */
+int GFraMe_tilemap_raycast_batch(GFraMe_tilemap *tmap,
+								 GFraMe_raycast_hit *hits, double *segs,
+								 int num);
+
 #endif
 
@@ -0,0 +1,191 @@
+/**
+ * @include/GFraMe/GFraMe_tweener.h
+ *
+ * Standalone tween engine. Tweens live on a pool (instead of inside every
+ *GFraMe_object) and may animate any float or int (e.g., a sprite's scale,
+ *angle or alpha) or an object's position. Every tween is updated in a single
+ *loop, each step being a lookup on a precomputed easing table.
+ *
+ * A tween may be delayed and may be chained to another one, which only
+ *starts after it completes (any time left from that step is carried over).
+ */
+#ifndef __GFRAME_TWEENER_H_
+#define __GFRAME_TWEENER_H_
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_pool.h>
+
+/**
+ * How many samples each easing table has (plus one, for the end)
+ */
+#define GFraMe_tweener_lut_size	256
+
+/**
+ * Handle to a tween
+ */
+typedef GFraMe_pool_handle GFraMe_tweener_handle;
+
+/**
+ * Easing curves
+ */
+enum enGFraMe_tweener_ease {
+	GFraMe_tweener_linear = 0,
+	GFraMe_tweener_quad_in,
+	GFraMe_tweener_quad_out,
+	GFraMe_tweener_quad_inout,
+	GFraMe_tweener_cubic_in,
+	GFraMe_tweener_cubic_out,
+	GFraMe_tweener_cubic_inout,
+	GFraMe_tweener_elastic_in,
+	GFraMe_tweener_elastic_out,
+	GFraMe_tweener_bounce_in,
+	GFraMe_tweener_bounce_out,
+	GFraMe_tweener_num_eases
+};
+typedef enum enGFraMe_tweener_ease GFraMe_tweener_ease;
+
+struct stGFraMe_tweener {
+	/**
+	 * Every tween (see gframe_tweener.c)
+	 */
+	GFraMe_pool tweens;
+	/**
+	 * How many updates were run (so tweens started by a chain aren't updated
+	 *twice on the same step)
+	 */
+	unsigned int step;
+};
+typedef struct stGFraMe_tweener GFraMe_tweener;
+
+/**
+ * Initialize the tweener (the easing tables are built on the first call)
+ * @param	*tw	The tweener
+ * @param	max	How many tweens there may be
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tweener_init(GFraMe_tweener *tw, int max);
+
+/**
+ * Release every memory alloc'ed by the tweener
+ * @param	*tw	The tweener
+ */
+void GFraMe_tweener_clear(GFraMe_tweener *tw);
+
+/**
+ * Remove every tween
+ * @param	*tw	The tweener
+ */
+void GFraMe_tweener_reset(GFraMe_tweener *tw);
+
+/**
+ * Tween a float (e.g., a sprite's alpha)
+ * @param	*tw	The tweener
+ * @param	*handle	Returns the tween's handle (may be NULL)
+ * @param	*target	The value (must outlive the tween)
+ * @param	from	Initial value
+ * @param	to	Final value
+ * @param	duration	How long the tween lasts, in milliseconds
+ * @param	ease	Easing curve
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - The tweener is full
+ */
+GFraMe_ret GFraMe_tweener_add(GFraMe_tweener *tw, GFraMe_tweener_handle *handle,
+							  float *target, float from, float to,
+							  int duration, GFraMe_tweener_ease ease);
+
+/**
+ * Tween an int (the value is rounded)
+ * @param	*tw	The tweener
+ * @param	*handle	Returns the tween's handle (may be NULL)
+ * @param	*target	The value (must outlive the tween)
+ * @param	from	Initial value
+ * @param	to	Final value
+ * @param	duration	How long the tween lasts, in milliseconds
+ * @param	ease	Easing curve
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - The tweener is full
+ */
+GFraMe_ret GFraMe_tweener_add_int(GFraMe_tweener *tw,
+								  GFraMe_tweener_handle *handle, int *target,
+								  int from, int to, int duration,
+								  GFraMe_tweener_ease ease);
+
+/**
+ * Move an object, from wherever it is when the tween starts, through
+ *GFraMe_object_set_pos
+ * @param	*tw	The tweener
+ * @param	*handle	Returns the tween's handle (may be NULL)
+ * @param	*obj	The object (must outlive the tween)
+ * @param	x	Final horizontal position
+ * @param	y	Final vertical position
+ * @param	duration	How long the tween lasts, in milliseconds
+ * @param	ease	Easing curve
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - The tweener is full
+ */
+GFraMe_ret GFraMe_tweener_add_obj(GFraMe_tweener *tw,
+								  GFraMe_tweener_handle *handle,
+								  GFraMe_object *obj, int x, int y,
+								  int duration, GFraMe_tweener_ease ease);
+
+/**
+ * Make a tween start from whatever value its target has when it starts
+ *(instead of its initial value); useful for chained tweens
+ * @param	*tw	The tweener
+ * @param	handle	The tween
+ */
+void GFraMe_tweener_from_current(GFraMe_tweener *tw,
+								 GFraMe_tweener_handle handle);
+
+/**
+ * Delay a tween (it's counted from when the tween is started)
+ * @param	*tw	The tweener
+ * @param	handle	The tween
+ * @param	delay	The delay, in milliseconds
+ */
+void GFraMe_tweener_set_delay(GFraMe_tweener *tw, GFraMe_tweener_handle handle,
+							  int delay);
+
+/**
+ * Make a tween only start after another completes; a tween may only have a
+ *single next one
+ * @param	*tw	The tweener
+ * @param	prev	The tween that runs first
+ * @param	next	The tween that runs after it (and isn't already running)
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_bad_param - Stale handle,
+ *			tween already chained, next tween already started or chaining
+ *			them would make a loop
+ */
+GFraMe_ret GFraMe_tweener_chain(GFraMe_tweener *tw, GFraMe_tweener_handle prev,
+								GFraMe_tweener_handle next);
+
+/**
+ * Remove a tween (its target is left as is) and any tween chained after it
+ * @param	*tw	The tweener
+ * @param	handle	The tween
+ */
+void GFraMe_tweener_stop(GFraMe_tweener *tw, GFraMe_tweener_handle handle);
+
+/**
+ * Update every tween; completed ones are removed
+ * @param	*tw	The tweener
+ * @param	ms	Time elapsed, in milliseconds
+ */
+void GFraMe_tweener_update(GFraMe_tweener *tw, int ms);
+
+/**
+ * Check whether a tween is still running (or waiting to run)
+ * @param	*tw	The tweener
+ * @param	handle	The tween
+ * @return	1 - Running; 0 - Completed or stopped
+ */
+int GFraMe_tweener_is_active(GFraMe_tweener *tw, GFraMe_tweener_handle handle);
+
+/**
+ * Get an easing curve's value
+ * @param	ease	The curve
+ * @param	t	Progress, from 0.0 to 1.0
+ * @return	The eased progress (0.0 at the start, 1.0 at the end)
+ */
+float GFraMe_tweener_ease_at(GFraMe_tweener_ease ease, float t);
+
+#endif
+
@@ -0,0 +1,63 @@
+/**
+ * @include/GFraMe/GFraMe_workers.h
+ *
+ * Pool of worker threads that run parallel-fors; a range of items is split
+ *into contiguous chunks (one per thread, plus one run by the caller), so
+ *results written per chunk can be merged in a deterministic order. If the
+ *pool wasn't initialized, every job runs on the calling thread.
+ */
+#ifndef __GFRAME_WORKERS_H_
+#define __GFRAME_WORKERS_H_
+
+#include <GFraMe/GFraMe_error.h>
+
+/**
+ * Maximum number of worker threads
+ */
+#define GFraMe_workers_max	16
+
+/**
+ * Jobs with fewer items than this (per chunk) run on the calling thread only
+ */
+#define GFraMe_workers_min_items	64
+
+/**
+ * Function run by each worker on its chunk
+ * @param	*ctx	Job's context
+ * @param	first	First item on the chunk
+ * @param	last	Item after the last one on the chunk
+ * @param	chunk	Index of the chunk (in [0, GFraMe_workers_get_num()))
+ */
+typedef void (*GFraMe_workers_func)(void *ctx, int first, int last,
+									int chunk);
+
+/**
+ * Spawn the worker threads
+ * @param	num	How many threads should be spawned (0 or less spawns one
+ *				less than the number of CPUs)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_workers_init(int num);
+
+/**
+ * Stop and release every worker thread
+ */
+void GFraMe_workers_clear();
+
+/**
+ * Get in how many chunks jobs may be split (i.e., workers plus the caller)
+ * @return	The number of chunks
+ */
+int GFraMe_workers_get_num();
+
+/**
+ * Run a job split across every worker and wait for it to finish; chunk 0 is
+ *always run by the calling thread and chunks are contiguous and in order
+ * @param	count	How many items there are
+ * @param	func	Function called for each chunk
+ * @param	*ctx	Context passed to the function
+ */
+void GFraMe_workers_run(int count, GFraMe_workers_func func, void *ctx);
+
+#endif
+
@@ -0,0 +1,405 @@
+/**
+ * @include/GFraMe/GFraMe_world.h
+ *
+ * Collision world; it keeps a list of objects and collides every pair that
+ *may overlap. Objects are spread on a uniform grid (the broadphase), so only
+ *objects on the same cells are tested, and pairs whose categories and masks
+ *don't match are discarded before being overlaped. How each pair is handled
+ *depends on the layers they belong to (see GFraMe_world_set_response).
+ *
+ * Objects that stay at rest for a while are put to sleep: they are neither
+ *updated nor collided against other sleeping objects, and are kept on a
+ *separated grid that is only rebuilt when the set of sleeping objects
+ *changes. Static objects (e.g., walls) are always kept asleep.
+ *
+ * If GFraMe_workers was initialized, integration and the broadphase are split
+ *across its threads. Pairs are still resolved on the calling thread, in the
+ *same order they would be found by a single thread, so the results don't
+ *depend on the number of workers.
+ *
+ * Overlapping pairs are kept between steps, so each step reports whether a
+ *contact just started, persisted or ended (see GFraMe_world_event). Contacts
+ *between sleeping objects are kept without reporting anything.
+ */
+#ifndef __GFRAME_WORLD_H_
+#define __GFRAME_WORLD_H_
+
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_raycast.h>
+
+/**
+ * How many layers there are (i.e., bits on an object's category)
+ */
+#define GFraMe_world_max_layers	32
+
+/**
+ * For how long (in milliseconds) objects must be at rest before sleeping
+ */
+#define GFraMe_world_default_sleep_time	500
+
+/**
+ * Pair of objects that overlapped
+ */
+struct stGFraMe_world_pair {
+	GFraMe_object *o1;
+	GFraMe_object *o2;
+};
+typedef struct stGFraMe_world_pair GFraMe_world_pair;
+
+/**
+ * What happened to a contact on the last step
+ */
+enum enGFraMe_world_event_type {
+	/**
+	 * The objects started overlapping
+	 */
+	GFraMe_world_contact_enter = 0,
+	/**
+	 * The objects were already overlapping
+	 */
+	GFraMe_world_contact_stay,
+	/**
+	 * The objects stopped overlapping
+	 */
+	GFraMe_world_contact_exit
+};
+typedef enum enGFraMe_world_event_type GFraMe_world_event_type;
+
+/**
+ * Contact event; the objects are always in the same order for a given pair
+ */
+struct stGFraMe_world_event {
+	GFraMe_object *o1;
+	GFraMe_object *o2;
+	GFraMe_world_event_type type;
+};
+typedef struct stGFraMe_world_event GFraMe_world_event;
+
+/**
+ * Entry on the contacts' hash set
+ */
+struct stGFraMe_world_contact {
+	/**
+	 * One of the objects (NULL if the entry is empty)
+	 */
+	GFraMe_object *o1;
+	/**
+	 * The other object
+	 */
+	GFraMe_object *o2;
+	/**
+	 * Whether the contact was found on this step (-1 if it was dropped)
+	 */
+	int seen;
+};
+typedef struct stGFraMe_world_contact GFraMe_world_contact;
+
+/**
+ * Hash set of contacts (open addressing, with linear probing)
+ */
+struct stGFraMe_world_contacts {
+	/**
+	 * Every entry (its size is always a power of 2)
+	 */
+	GFraMe_world_contact *entries;
+	/**
+	 * How many entries there are
+	 */
+	int len;
+	/**
+	 * How many entries are being used
+	 */
+	int count;
+};
+typedef struct stGFraMe_world_contacts GFraMe_world_contacts;
+
+/**
+ * Objects spread on the world's cells
+ */
+struct stGFraMe_world_grid {
+	/**
+	 * Index of each cell's first item (with an extra entry at the end)
+	 */
+	int *cell_start;
+	/**
+	 * Objects (indexes) on each cell, one cell after the other
+	 */
+	int *cell_items;
+	/**
+	 * How many items fit on the current buffer
+	 */
+	int max_items;
+};
+typedef struct stGFraMe_world_grid GFraMe_world_grid;
+
+/**
+ * Pairs found by a single worker, later merged into the world's list
+ */
+struct stGFraMe_world_chunk {
+	/**
+	 * Pairs (of indexes) that may overlap
+	 */
+	int *pairs;
+	/**
+	 * How many pairs were found
+	 */
+	int num_pairs;
+	/**
+	 * How many pairs fit on the current buffer
+	 */
+	int max_pairs;
+	/**
+	 * Whether the worker failed
+	 */
+	GFraMe_ret rv;
+};
+typedef struct stGFraMe_world_chunk GFraMe_world_chunk;
+
+struct stGFraMe_world {
+	/**
+	 * Every object on the world; awake ones come first, followed by every
+	 *sleeping (and static) one
+	 */
+	GFraMe_object **objs;
+	/**
+	 * How many objects there are
+	 */
+	int num_objs;
+	/**
+	 * How many objects are awake
+	 */
+	int num_awake;
+	/**
+	 * How many objects fit on the current buffer
+	 */
+	int max_objs;
+	/**
+	 * Grid's horizontal position (objects outside the grid are clamped to
+	 *its border)
+	 */
+	int x;
+	/**
+	 * Grid's vertical position
+	 */
+	int y;
+	/**
+	 * Width of each cell
+	 */
+	int cell_w;
+	/**
+	 * Height of each cell
+	 */
+	int cell_h;
+	/**
+	 * How many cells there are horizontally
+	 */
+	int columns;
+	/**
+	 * How many cells there are vertically
+	 */
+	int rows;
+	/**
+	 * Grid with the awake objects, rebuilt every step
+	 */
+	GFraMe_world_grid awake;
+	/**
+	 * Grid with the sleeping objects, rebuilt only when they change
+	 */
+	GFraMe_world_grid asleep;
+	/**
+	 * Whether the sleeping objects changed since the grid was built
+	 */
+	int asleep_dirty;
+	/**
+	 * Whether the awake objects were moved around since the grid was built
+	 */
+	int awake_dirty;
+	/**
+	 * For how long (in milliseconds) an object must be at rest to sleep
+	 */
+	int sleep_time;
+	/**
+	 * Range of cells each object occupies (first column, first row, last
+	 *column and last row)
+	 */
+	int *obj_cells;
+	/**
+	 * Pairs (of indexes) that may overlap, as found by the broadphase
+	 */
+	int *pairs;
+	/**
+	 * How many pairs were found
+	 */
+	int num_pairs;
+	/**
+	 * How many pairs fit on the current buffer
+	 */
+	int max_pairs;
+	/**
+	 * Pairs found by each worker
+	 */
+	GFraMe_world_chunk *chunks;
+	/**
+	 * How many workers' lists there are
+	 */
+	int num_chunks;
+	/**
+	 * Pairs that overlapped on the last step (read only!)
+	 */
+	GFraMe_world_pair *overlaps;
+	/**
+	 * How many pairs overlapped on the last step (read only!)
+	 */
+	int num_overlaps;
+	/**
+	 * How many overlaps fit on the current buffer
+	 */
+	int max_overlaps;
+	/**
+	 * Contacts found on the last step and the ones being found (they are
+	 *swapped every step)
+	 */
+	GFraMe_world_contacts contacts[2];
+	/**
+	 * Which of the contacts' set is the current one
+	 */
+	int cur_contacts;
+	/**
+	 * Contact events from the last step (read only!); enter and stay events
+	 *come in the order the pairs were collided, followed by exit events
+	 */
+	GFraMe_world_event *events;
+	/**
+	 * How many events there are (read only!)
+	 */
+	int num_events;
+	/**
+	 * How many events fit on the current buffer
+	 */
+	int max_events;
+	/**
+	 * Whether objects should be swept (see GFraMe_object_sweep)
+	 */
+	int use_sweep;
+	/**
+	 * How each pair of layers collide (a GFraMe_collision_type)
+	 */
+	unsigned char responses[GFraMe_world_max_layers*GFraMe_world_max_layers];
+};
+typedef struct stGFraMe_world GFraMe_world;
+
+/**
+ * Initialize a collision world; by default, every pair of layers only set
+ *the objects' flags (i.e., GFraMe_dont_collide) and objects sleep after
+ *GFraMe_world_default_sleep_time ms at rest
+ * @param	*world	World to be initialized
+ * @param	x	Grid's horizontal position
+ * @param	y	Grid's vertical position
+ * @param	w	Grid's width
+ * @param	h	Grid's height
+ * @param	cell_w	Each cell's width
+ * @param	cell_h	Each cell's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_world_init(GFraMe_world *world, int x, int y, int w, int h,
+							 int cell_w, int cell_h);
+
+/**
+ * Clean up memory allocated by the world; the objects aren't touched
+ * @param	*world	The world
+ */
+void GFraMe_world_clear(GFraMe_world *world);
+
+/**
+ * Add an object to the world; it must be kept alive until removed
+ * @param	*world	The world
+ * @param	*obj	The object
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_world_add(GFraMe_world *world, GFraMe_object *obj);
+
+/**
+ * Remove an object from the world; its contacts are dropped without any
+ *event
+ * @param	*world	The world
+ * @param	*obj	The object
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - Object not found
+ */
+GFraMe_ret GFraMe_world_remove(GFraMe_world *world, GFraMe_object *obj);
+
+/**
+ * Set how objects on two layers collide; the response is mirrored for the
+ *inverse pair (e.g., GFraMe_first_fixed becomes GFraMe_second_fixed)
+ * @param	*world	The world
+ * @param	layer1	Index of the first layer (i.e., its bit on the category)
+ * @param	layer2	Index of the second layer
+ * @param	mode	How they should collide
+ */
+void GFraMe_world_set_response(GFraMe_world *world, int layer1, int layer2,
+							   GFraMe_collision_type mode);
+
+/**
+ * Set whether the objects should be swept, avoiding tunneling
+ * @param	*world	The world
+ * @param	use_sweep	Whether GFraMe_object_sweep should be used
+ */
+void GFraMe_world_set_sweep(GFraMe_world *world, int use_sweep);
+
+/**
+ * Set for how long objects must be at rest before sleeping
+ * @param	*world	The world
+ * @param	ms	Time, in milliseconds (0 or less never puts objects to sleep)
+ */
+void GFraMe_world_set_sleep_time(GFraMe_world *world, int ms);
+
+/**
+ * Collide every pair of objects that may overlap; every overlap is stored on
+ *the world's overlaps list. Sleeping objects aren't collided against each
+ *other, but are woken when an awake object overlaps them
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_world_step(GFraMe_world *world);
+
+/**
+ * Update every awake object, collide them (as GFraMe_world_step) and put to
+ *sleep the ones that have been at rest for long enough
+ * @param	*world	The world
+ * @param	ms	How long this frame took
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_world_update(GFraMe_world *world, int ms);
+
+/**
+ * Cast a segment against every object on the world; objects are looked up
+ *on the cells they occupied on the last step (and only the part of the
+ *segment inside the grid is checked)
+ * @param	*world	The world
+ * @param	*hit	Returns the first object hit
+ * @param	x0	Segment's horizontal start
+ * @param	y0	Segment's vertical start
+ * @param	x1	Segment's horizontal end
+ * @param	y1	Segment's vertical end
+ * @param	mask	Bitfield of layers that may be hit
+ * @return	GFraMe_ret_ok - Hit; GFraMe_ret_no_overlap - Missed; Anything
+ *			else - Failure
+ */
+GFraMe_ret GFraMe_world_raycast(GFraMe_world *world, GFraMe_raycast_hit *hit,
+								double x0, double y0, double x1, double y1,
+								unsigned int mask);
+
+/**
+ * Cast many segments against every object on the world (e.g., a vision cone)
+ * @param	*world	The world
+ * @param	*hits	Returns each segment's hit (did_hit is 0 on misses)
+ * @param	*segs	Segments, as x0, y0, x1, y1 (4 values per segment)
+ * @param	num	How many segments there are
+ * @param	mask	Bitfield of layers that may be hit
+ * @return	How many segments hit an object
+ */
+int GFraMe_world_raycast_batch(GFraMe_world *world, GFraMe_raycast_hit *hits,
+							   double *segs, int num, unsigned int mask);
+
+#endif
+
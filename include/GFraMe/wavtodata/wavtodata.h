@@ -1,7 +1,32 @@
 #ifndef __WAVTODATA_H
 #define __WAVTODATA_H
 
+/**
+ * Every converted audio starts with this magic, followed by its sample rate
+ * (32 bits), its number of channels (16 bits) and a padding (16 bits), all
+ * little endian; the samples are always signed 16 bits little endian.
+ * Files without it are raw 44100 Hz stereo samples.
+ */
+#define WAVTODATA_MAGIC "GFAU"
+#define WAVTODATA_HEADER_SIZE 12
+#define WAVTODATA_MIN_RATE 11025
+#define WAVTODATA_MAX_RATE 48000
+
+/**
+ * Audios encoded as IMA-ADPCM (the '.adp' files) start with how many frames
+ * were encoded (32 bits), their sample rate (32 bits), their number of
+ * channels (8 bits) and a padding (24 bits), all little endian; the blocks
+ * (see GFraMe_adpcm.h) follow it.
+ */
+#define WAVTOADPCM_HEADER_SIZE 12
+
 int wavtodata(char *infile, char *outfile, int force);
+/**
+ * Convert a WAVE file straight into an '.adp' file, so it may be shipped
+ * already encoded (e.g., on read-only assets, where it can't be encoded and
+ * kept on the first run)
+ */
+int wavtoadpcm(char *infile, char *outfile, int force);
 
 #endif
 
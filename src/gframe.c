@@ -41,7 +41,8 @@ static GFraMe_timer timer = 0;
  * @param	flags	Window creation flags
  * @param	fps		At how many frames per second the game should run;
  *				  notice that this is independent from update and render
- *				  rate, those should be set on each state
+ *				  rate, those should be set on each state; 0 creates no
+ *				  timer (for states driven by a GFraMe_clock)
  * @param	log_to_file	Whether should log to a file or to the terminal
  * @param	log_append	Whether should overwrite or append to an existing log
  * @return	0 - Success; Anything else - Failure
@@ -96,6 +97,9 @@ GFraMe_ret GFraMe_init(int vw, int vh, int sw, int sh, char *org,
 	GFraMe_assertRV(rv == GFraMe_ret_ok, "Failed to initialize the screen",
 		rv=rv, _ret);
 	
+	// States driven by a GFraMe_clock don't need the timer's events
+	if (fps == 0)
+		goto _ret;
 	// Create a timer
 	ms = GFraMe_timer_get_ms(fps);
 	GFraMe_assertRV(ms > 0, "Requested FPS is too low",
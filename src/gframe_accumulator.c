@@ -91,3 +91,15 @@ GFraMe_ret GFraMe_accumulator_loop(GFraMe_accumulator *acc) {
 	return GFraMe_ret_ok;
 }
 
+/**
+ * Get how much of a frame was accumulated (i.e., how far into the next frame
+ * it is); used to interpolate drawing between two updates
+ * @param	*acc	Accumulator to be checked
+ * @return	The fraction of a frame, from 0.0 to 1.0
+ */
+float GFraMe_accumulator_alpha(GFraMe_accumulator *acc) {
+	if (acc->timeout <= 0 || acc->elapsed >= acc->timeout)
+		return 1.0f;
+	return (float)acc->elapsed / (float)acc->timeout;
+}
+
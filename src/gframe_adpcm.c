@@ -0,0 +1,241 @@
+/**
+ * @src/gframe_adpcm.c
+ */
+#include <GFraMe/GFraMe_adpcm.h>
+#include <SDL2/SDL_stdinc.h>
+#include <string.h>
+
+/**
+ * Size of each step index
+ */
+static const int GFraMe_adpcm_steps[89] = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+	45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209,
+	230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876,
+	963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749,
+	3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+	9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385,
+	24623, 27086, 29794, 32767
+};
+
+/**
+ * How the step index changes after each nibble
+ */
+static const int GFraMe_adpcm_index_delta[16] = {
+	-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static void GFraMe_adpcm_decode_chan(Sint16 *dst, int stride,
+	const Uint8 *blk, int chan, int chans, int first, int num, int *predictor,
+	int *index);
+
+int GFraMe_adpcm_get_size(int frames, int stereo) {
+	int blocks;
+
+	blocks = (frames + GFraMe_adpcm_block_frames - 1)
+		/ GFraMe_adpcm_block_frames;
+	return blocks * GFraMe_adpcm_block_size * (stereo ? 2 : 1);
+}
+
+int GFraMe_adpcm_encode(char *dst, const Sint16 *src, int frames, int stereo) {
+	int chans, size, frame, index[2];
+
+	chans = stereo ? 2 : 1;
+	size = GFraMe_adpcm_get_size(frames, stereo);
+	memset(dst, 0x0, size);
+	index[0] = 0;
+	index[1] = 0;
+	frame = 0;
+	while (frame < frames) {
+		Uint8 *blk = (Uint8*)dst + (frame / GFraMe_adpcm_block_frames)
+			* GFraMe_adpcm_block_size * chans;
+		int num, c;
+
+		num = frames - frame;
+		if (num > GFraMe_adpcm_block_frames)
+			num = GFraMe_adpcm_block_frames;
+		c = 0;
+		while (c < chans) {
+			Uint8 *nibbles = blk + chans * 4 + c * (GFraMe_adpcm_block_size - 4);
+			int predictor, i;
+
+			// The first sample is stored verbatim, so blocks are independent
+			predictor = src[frame * chans + c];
+			blk[c * 4] = (Uint8)(predictor & 0xff);
+			blk[c * 4 + 1] = (Uint8)((predictor >> 8) & 0xff);
+			blk[c * 4 + 2] = (Uint8)index[c];
+			i = 1;
+			while (i < num) {
+				int diff, step, delta, nibble;
+
+				diff = src[(frame + i) * chans + c] - predictor;
+				nibble = 0;
+				if (diff < 0) {
+					nibble = 8;
+					diff = -diff;
+				}
+				// Quantize it exactly as the decoder will reconstruct it
+				step = GFraMe_adpcm_steps[index[c]];
+				delta = step >> 3;
+				if (diff >= step) {
+					nibble |= 4;
+					diff -= step;
+					delta += step;
+				}
+				step >>= 1;
+				if (diff >= step) {
+					nibble |= 2;
+					diff -= step;
+					delta += step;
+				}
+				step >>= 1;
+				if (diff >= step) {
+					nibble |= 1;
+					delta += step;
+				}
+				if (nibble & 8)
+					predictor -= delta;
+				else
+					predictor += delta;
+				if (predictor > 32767)
+					predictor = 32767;
+				else if (predictor < -32768)
+					predictor = -32768;
+				index[c] += GFraMe_adpcm_index_delta[nibble];
+				if (index[c] < 0)
+					index[c] = 0;
+				else if (index[c] > 88)
+					index[c] = 88;
+				if ((i - 1) & 1)
+					nibbles[(i - 1) >> 1] |= (Uint8)(nibble << 4);
+				else
+					nibbles[(i - 1) >> 1] |= (Uint8)nibble;
+				i++;
+			}
+			c++;
+		}
+		frame += num;
+	}
+	return size;
+}
+
+void GFraMe_adpcm_init_state(GFraMe_adpcm_state *st) {
+	st->predictor[0] = 0;
+	st->predictor[1] = 0;
+	st->index[0] = 0;
+	st->index[1] = 0;
+	st->frame = 0;
+}
+
+void GFraMe_adpcm_seek(GFraMe_adpcm_state *st, const char *src, int frame,
+	int stereo) {
+	int start;
+
+	start = frame - frame % GFraMe_adpcm_block_frames;
+	// Resuming from the current position is cheaper, if it's on the same block
+	if (st->frame > frame || st->frame < start)
+		st->frame = start;
+	GFraMe_adpcm_decode(NULL, st, src, frame - st->frame, frame, stereo);
+}
+
+int GFraMe_adpcm_decode(Sint16 *dst, GFraMe_adpcm_state *st, const char *src,
+	int frames, int total, int stereo) {
+	int chans, done;
+
+	chans = stereo ? 2 : 1;
+	if (frames > total - st->frame)
+		frames = total - st->frame;
+	done = 0;
+	while (done < frames) {
+		const Uint8 *blk = (const Uint8*)src + (st->frame
+			/ GFraMe_adpcm_block_frames) * GFraMe_adpcm_block_size * chans;
+		int first, num, c;
+
+		first = st->frame % GFraMe_adpcm_block_frames;
+		num = GFraMe_adpcm_block_frames - first;
+		if (num > frames - done)
+			num = frames - done;
+		c = 0;
+		while (c < chans) {
+			GFraMe_adpcm_decode_chan(dst ? dst + done * chans + c : NULL, chans,
+				blk, c, chans, first, num, st->predictor + c, st->index + c);
+			c++;
+		}
+		done += num;
+		st->frame += num;
+	}
+	return done;
+}
+
+/**
+ * Decode a channel of a block
+ * @param	*dst	Where the first sample is written (or NULL)
+ * @param	stride	Distance between two samples on the output
+ * @param	*blk	The block
+ * @param	chan	Which channel should be decoded
+ * @param	chans	How many channels there are
+ * @param	first	First frame (within the block) to be decoded
+ * @param	num	How many frames should be decoded
+ * @param	*predictor	The channel's last sample
+ * @param	*index	The channel's step index
+ */
+static void GFraMe_adpcm_decode_chan(Sint16 *dst, int stride,
+	const Uint8 *blk, int chan, int chans, int first, int num, int *predictor,
+	int *index) {
+	const Uint8 *nibbles;
+	int i, end, pred, idx;
+
+	nibbles = blk + chans * 4 + chan * (GFraMe_adpcm_block_size - 4);
+	pred = *predictor;
+	idx = *index;
+	i = first;
+	end = first + num;
+	if (i == 0) {
+		pred = (Sint16)(blk[chan * 4] | (blk[chan * 4 + 1] << 8));
+		idx = blk[chan * 4 + 2];
+		if (idx > 88)
+			idx = 88;
+		if (dst) {
+			*dst = (Sint16)pred;
+			dst += stride;
+		}
+		i++;
+	}
+	while (i < end) {
+		int nibble, step, delta;
+
+		nibble = nibbles[(i - 1) >> 1];
+		if ((i - 1) & 1)
+			nibble >>= 4;
+		nibble &= 0xf;
+		step = GFraMe_adpcm_steps[idx];
+		delta = step >> 3;
+		if (nibble & 4)
+			delta += step;
+		if (nibble & 2)
+			delta += step >> 1;
+		if (nibble & 1)
+			delta += step >> 2;
+		if (nibble & 8)
+			pred -= delta;
+		else
+			pred += delta;
+		if (pred > 32767)
+			pred = 32767;
+		else if (pred < -32768)
+			pred = -32768;
+		idx += GFraMe_adpcm_index_delta[nibble];
+		if (idx < 0)
+			idx = 0;
+		else if (idx > 88)
+			idx = 88;
+		if (dst) {
+			*dst = (Sint16)pred;
+			dst += stride;
+		}
+		i++;
+	}
+	*predictor = pred;
+	*index = idx;
+}
+
@@ -0,0 +1,274 @@
+/**
+ * @src/gframe_animsys.c
+ */
+#include <GFraMe/GFraMe_animsys.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_pool.h>
+#include <stdlib.h>
+
+/**
+ * Get a handle's slot
+ */
+#define GFraMe_animsys_slot(handle) \
+	((int)((handle) & (GFraMe_pool_max_items - 1)))
+
+/**
+ * Get an instance's position from its handle
+ * @param	*sys	The system
+ * @param	handle	The instance
+ * @return	The position or -1, if the handle is stale
+ */
+static int GFraMe_animsys_get_pos(GFraMe_animsys *sys,
+								  GFraMe_animsys_handle handle);
+
+/**
+ * Restart an instance on a clip
+ * @param	*sys	The system
+ * @param	i	Instance's position
+ * @param	*clip	The clip
+ */
+static void GFraMe_animsys_start(GFraMe_animsys *sys, int i,
+								 const GFraMe_anim_clip *clip);
+
+void GFraMe_anim_clip_init(GFraMe_anim_clip *clip, int fps,
+						   int const *frames, int num_frames, int do_loop) {
+	clip->frames = frames;
+	clip->num_frames = num_frames;
+	clip->do_loop = do_loop;
+	// Same as GFraMe_animation_init
+	if (fps > 0)
+		clip->frame_duration = 1000 / fps;
+	else
+		clip->frame_duration = 0;
+}
+
+GFraMe_ret GFraMe_animsys_init(GFraMe_animsys *sys, int max) {
+	GFraMe_ret rv;
+
+	sys->clips = NULL;
+	sys->acc = NULL;
+	sys->index = NULL;
+	sys->tile = NULL;
+	sys->targets = NULL;
+	sys->flags = NULL;
+	sys->owner = NULL;
+	sys->pos = NULL;
+	sys->changed = NULL;
+	sys->len = 0;
+	sys->num_changed = 0;
+	rv = GFraMe_pool_init(&sys->handles, sizeof(int), max);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init handles", _ret);
+	#define ALLOC(buf, type) \
+		do { \
+			buf = (type*)malloc(sizeof(type) * max); \
+			GFraMe_assertRV(buf, "Failed to alloc memory", \
+							rv = GFraMe_ret_memory_error, _ret); \
+		} while (0)
+	ALLOC(sys->clips, const GFraMe_anim_clip*);
+	ALLOC(sys->acc, int);
+	ALLOC(sys->index, int);
+	ALLOC(sys->tile, int);
+	ALLOC(sys->targets, int*);
+	ALLOC(sys->flags, unsigned char);
+	ALLOC(sys->owner, int);
+	ALLOC(sys->pos, int);
+	ALLOC(sys->changed, GFraMe_animsys_handle);
+	#undef ALLOC
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_animsys_clear(sys);
+	return rv;
+}
+
+void GFraMe_animsys_clear(GFraMe_animsys *sys) {
+	#define FREE(buf) \
+		do { \
+			if (buf) \
+				free((void*)buf); \
+			buf = NULL; \
+		} while (0)
+	FREE(sys->clips);
+	FREE(sys->acc);
+	FREE(sys->index);
+	FREE(sys->tile);
+	FREE(sys->targets);
+	FREE(sys->flags);
+	FREE(sys->owner);
+	FREE(sys->pos);
+	FREE(sys->changed);
+	#undef FREE
+	GFraMe_pool_clear(&sys->handles);
+	sys->len = 0;
+	sys->num_changed = 0;
+}
+
+GFraMe_ret GFraMe_animsys_add(GFraMe_animsys *sys,
+							  GFraMe_animsys_handle *handle,
+							  const GFraMe_anim_clip *clip, int *target) {
+	GFraMe_ret rv;
+	void *item;
+	int i, slot;
+
+	rv = GFraMe_pool_acquire(&sys->handles, handle, &item);
+	if (rv != GFraMe_ret_ok)
+		return rv;
+	slot = GFraMe_animsys_slot(*handle);
+	i = sys->len;
+	sys->len++;
+	sys->owner[i] = slot;
+	sys->pos[slot] = i;
+	sys->targets[i] = target;
+	GFraMe_animsys_start(sys, i, clip);
+	sys->flags[i] = 0;
+	if (target)
+		*target = sys->tile[i];
+	return GFraMe_ret_ok;
+}
+
+void GFraMe_animsys_remove(GFraMe_animsys *sys, GFraMe_animsys_handle handle) {
+	int i, last;
+
+	i = GFraMe_animsys_get_pos(sys, handle);
+	if (i == -1)
+		return;
+	GFraMe_pool_release(&sys->handles, handle);
+	// Move the last instance into the removed one's position
+	sys->len--;
+	last = sys->len;
+	if (i != last) {
+		sys->clips[i] = sys->clips[last];
+		sys->acc[i] = sys->acc[last];
+		sys->index[i] = sys->index[last];
+		sys->tile[i] = sys->tile[last];
+		sys->targets[i] = sys->targets[last];
+		sys->flags[i] = sys->flags[last];
+		sys->owner[i] = sys->owner[last];
+		sys->pos[sys->owner[i]] = i;
+	}
+}
+
+GFraMe_ret GFraMe_animsys_play(GFraMe_animsys *sys,
+							   GFraMe_animsys_handle handle,
+							   const GFraMe_anim_clip *clip) {
+	int i, tile;
+
+	i = GFraMe_animsys_get_pos(sys, handle);
+	if (i == -1)
+		return GFraMe_ret_bad_param;
+	if (sys->clips[i] == clip && !(sys->flags[i] & GFraMe_animsys_finished))
+		return GFraMe_ret_ok;
+	tile = sys->tile[i];
+	GFraMe_animsys_start(sys, i, clip);
+	sys->flags[i] = 0;
+	if (sys->tile[i] != tile && sys->targets[i])
+		*sys->targets[i] = sys->tile[i];
+	return GFraMe_ret_ok;
+}
+
+void GFraMe_animsys_update(GFraMe_animsys *sys, int ms) {
+	int i;
+
+	sys->num_changed = 0;
+	i = 0;
+	while (i < sys->len) {
+		const GFraMe_anim_clip *clip;
+		int acc, index, tile;
+
+		sys->flags[i] &= ~GFraMe_animsys_changed;
+		acc = sys->acc[i];
+		// Still frames and finished clips never change (just like
+		// GFraMe_animation_update, report them as finished)
+		if (acc <= 0) {
+			sys->flags[i] |= GFraMe_animsys_finished;
+			i++;
+			continue;
+		}
+		acc -= ms;
+		if (acc > 0) {
+			sys->acc[i] = acc;
+			i++;
+			continue;
+		}
+		clip = sys->clips[i];
+		index = sys->index[i];
+		// Skip whole loops at once
+		if (clip->do_loop) {
+			int period = clip->frame_duration * clip->num_frames;
+			if (-acc >= period)
+				acc += (-acc / period) * period;
+		}
+		// Issue as many frames as were skipped
+		while (acc <= 0) {
+			index++;
+			if (index >= clip->num_frames) {
+				if (!clip->do_loop) {
+					sys->flags[i] |= GFraMe_animsys_finished;
+					break;
+				}
+				index = 0;
+			}
+			acc += clip->frame_duration;
+		}
+		sys->acc[i] = acc;
+		sys->index[i] = index;
+		// A finished clip stays on its last frame
+		if (index < clip->num_frames)
+			tile = clip->frames[index];
+		else
+			tile = clip->frames[clip->num_frames - 1];
+		if (tile != sys->tile[i]) {
+			sys->tile[i] = tile;
+			sys->flags[i] |= GFraMe_animsys_changed;
+			if (sys->targets[i])
+				*sys->targets[i] = tile;
+			sys->changed[sys->num_changed] =
+					(sys->handles.gens[sys->owner[i]]
+					 << GFraMe_pool_slot_bits) | sys->owner[i];
+			sys->num_changed++;
+		}
+		i++;
+	}
+}
+
+int GFraMe_animsys_get_tile(GFraMe_animsys *sys, GFraMe_animsys_handle handle) {
+	int i = GFraMe_animsys_get_pos(sys, handle);
+	if (i == -1)
+		return -1;
+	return sys->tile[i];
+}
+
+int GFraMe_animsys_get_flags(GFraMe_animsys *sys,
+							 GFraMe_animsys_handle handle) {
+	int i = GFraMe_animsys_get_pos(sys, handle);
+	if (i == -1)
+		return 0;
+	return sys->flags[i];
+}
+
+/**
+ * Get an instance's position from its handle
+ * @param	*sys	The system
+ * @param	handle	The instance
+ * @return	The position or -1, if the handle is stale
+ */
+static int GFraMe_animsys_get_pos(GFraMe_animsys *sys,
+								  GFraMe_animsys_handle handle) {
+	if (!GFraMe_pool_get(&sys->handles, handle))
+		return -1;
+	return sys->pos[GFraMe_animsys_slot(handle)];
+}
+
+/**
+ * Restart an instance on a clip
+ * @param	*sys	The system
+ * @param	i	Instance's position
+ * @param	*clip	The clip
+ */
+static void GFraMe_animsys_start(GFraMe_animsys *sys, int i,
+								 const GFraMe_anim_clip *clip) {
+	sys->clips[i] = clip;
+	sys->acc[i] = clip->frame_duration;
+	sys->index[i] = 0;
+	sys->tile[i] = clip->frames[0];
+}
+
@@ -15,16 +15,23 @@
  *run from. Otherwise, it's expected to be on the same folder as the binary.
  */
 #include <GFraMe/GFraMe.h>
+#include <GFraMe/GFraMe_adpcm.h>
 #include <GFraMe/GFraMe_assets.h>
 #include <GFraMe/GFraMe_error.h>
 #include <GFraMe/GFraMe_log.h>
 #include <GFraMe/GFraMe_util.h>
+#include <GFraMe/wavtodata/readbytes.h>
 #include <GFraMe/wavtodata/wavtodata.h>
 #include <SDL2/SDL.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+static GFraMe_ret GFraMe_assets_encode_adpcm(char *filename, char *name,
+	char **buf, int *frames, int *freq, int *stereo);
+static void GFraMe_assets_write_adpcm(char *name, char *header, int header_len,
+	char *samples, int size);
+
 /**
  * SDL already considers assets on a mobile device to be on a 'assets/'
  * folder, so this function removes it (if it was compiled for mobile)
@@ -141,13 +148,15 @@ _ret:
 	return rv;
 }
 
-GFraMe_ret GFraMe_assets_buffer_audio(char *filename, char **buf, int *len) {
+GFraMe_ret GFraMe_assets_open_audio(char *filename, SDL_RWops **fp,
+	int *len, int *freq, int *stereo) {
 	GFraMe_ret rv = GFraMe_ret_ok;
-	char *samples = NULL;
-	SDL_RWops *fp = NULL;
-	int flen, flen2, tmp;
+	int flen, flen2;
+	char hdr[WAVTODATA_HEADER_SIZE];
 	char name[GFraMe_max_path_len];
 	
+	*fp = NULL;
+	
 	memset(name, 0x0, GFraMe_max_path_len);
 	// Get the proper filename
 	flen = GFraMe_max_path_len;
@@ -164,6 +173,7 @@ GFraMe_ret GFraMe_assets_buffer_audio(char *filename, char **buf, int *len) {
 	name[fuck_android + 3] = 't';
 	name[fuck_android + 4] = '\0';
 #else
+	flen2 = flen;
 	GFraMe_util_strcat(name + GFraMe_max_path_len - flen, ".dat", &flen2);
 #endif
 	
@@ -187,16 +197,57 @@ GFraMe_ret GFraMe_assets_buffer_audio(char *filename, char **buf, int *len) {
 		GFraMe_assertRet(rv == 0, "Failed to create raw audio", _ret);
 	}
 	
-	// Load the file into the buffer
-	fp = SDL_RWFromFile(name, "r");
-	GFraMe_SDLassertRV(fp != NULL, "Failed to open file",
+	*fp = SDL_RWFromFile(name, "r");
+	GFraMe_SDLassertRV(*fp != NULL, "Failed to open file",
 		rv = GFraMe_ret_failed, _ret);
 	
 	// Get the file's length
-	*len = SDL_RWseek(fp, 0, RW_SEEK_END);
+	*len = SDL_RWseek(*fp, 0, RW_SEEK_END);
 	GFraMe_SDLassertRV(*len > 0, "Failed to the file's length", 
 		rv = GFraMe_ret_failed, _ret);
-	SDL_RWseek(fp, 0, RW_SEEK_SET);
+	SDL_RWseek(*fp, 0, RW_SEEK_SET);
+	
+	// Converted audios start with their format; older ones are raw 44100 Hz
+	*freq = 44100;
+	if (*len >= WAVTODATA_HEADER_SIZE
+			&& SDL_RWread(*fp, hdr, 1, WAVTODATA_HEADER_SIZE)
+				== WAVTODATA_HEADER_SIZE
+			&& memcmp(hdr, WAVTODATA_MAGIC, 4) == 0) {
+		*freq = readWORD(hdr + 4);
+		*stereo = (hdr[8] == 2);
+		*len -= WAVTODATA_HEADER_SIZE;
+		GFraMe_assertRV(*freq >= WAVTODATA_MIN_RATE
+			&& *freq <= WAVTODATA_MAX_RATE, "Invalid sample rate",
+			rv = GFraMe_ret_failed, _ret);
+	}
+	else
+		SDL_RWseek(*fp, 0, RW_SEEK_SET);
+	
+	rv = GFraMe_ret_ok;
+_ret:
+	if (rv != GFraMe_ret_ok && *fp) {
+		SDL_RWclose(*fp);
+		*fp = NULL;
+	}
+	return rv;
+}
+
+GFraMe_ret GFraMe_assets_buffer_audio(char *filename, char **buf, int *len) {
+	int freq, stereo;
+	
+	return GFraMe_assets_buffer_audio_fmt(filename, buf, len, &freq, &stereo);
+}
+
+GFraMe_ret GFraMe_assets_buffer_audio_fmt(char *filename, char **buf,
+	int *len, int *freq, int *stereo) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	char *samples = NULL;
+	SDL_RWops *fp = NULL;
+	int tmp;
+	
+	// Open the file (creating it, if needed)
+	rv = GFraMe_assets_open_audio(filename, &fp, len, freq, stereo);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to open audio", _ret);
 	
 	// Then simply read its content into the buffer
 	samples = (char*)malloc(*len);
@@ -326,3 +377,176 @@ _err:
 	return rv;
 }
 
+
+GFraMe_ret GFraMe_assets_buffer_audio_adpcm(char *filename, char **buf,
+	int *frames, int *freq, int *stereo) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	char *samples = NULL;
+	SDL_RWops *fp = NULL;
+	int flen, flen2, size, tmp;
+	char header[WAVTOADPCM_HEADER_SIZE];
+	char name[GFraMe_max_path_len];
+	
+	memset(name, 0x0, GFraMe_max_path_len);
+	// Get the proper filename
+	flen = GFraMe_max_path_len;
+	rv = GFraMe_assets_clean_filename(name, filename, &flen);
+	GFraMe_assertRV(rv == GFraMe_ret_ok, "Failed to get the file name",
+		rv = GFraMe_ret_failed, _ret);
+	
+#ifdef GFRAME_MOBILE
+	int fuck_android = GFraMe_util_strlen(name);
+	name[fuck_android + 0] = '.';
+	name[fuck_android + 1] = 'a';
+	name[fuck_android + 2] = 'd';
+	name[fuck_android + 3] = 'p';
+	name[fuck_android + 4] = '\0';
+#else
+	flen2 = flen;
+	GFraMe_util_strcat(name + GFraMe_max_path_len - flen, ".adp", &flen2);
+#endif
+	
+	// The .adp file should be shipped already encoded (see wavtoadpcm); if
+	// there's none, encode the raw samples (creating them, if needed) and try
+	// to keep the result for the next time
+	if (GFraMe_assets_check_file(name) != GFraMe_ret_ok) {
+		GFraMe_new_log("Couldn't find %s... creating it...", name);
+		return GFraMe_assets_encode_adpcm(filename, name, buf, frames, freq,
+			stereo);
+	}
+	
+	fp = SDL_RWFromFile(name, "rb");
+	GFraMe_SDLassertRV(fp != NULL, "Failed to open file",
+		rv = GFraMe_ret_failed, _ret);
+	
+	// The file starts with how many frames were encoded, the sample rate and
+	// the number of channels
+	tmp = SDL_RWread(fp, header, 1, WAVTOADPCM_HEADER_SIZE);
+	size = 0;
+	if (tmp == WAVTOADPCM_HEADER_SIZE) {
+		*frames = GFraMe_read_UINT(header, 0);
+		*freq = GFraMe_read_UINT(header, 4);
+		*stereo = (header[8] == 2);
+		if (*frames > 0 && *freq >= WAVTODATA_MIN_RATE
+			&& *freq <= WAVTODATA_MAX_RATE)
+			size = GFraMe_adpcm_get_size(*frames, *stereo);
+	}
+	// A truncated (or otherwise broken) file is simply encoded again
+	if (size == 0 || SDL_RWsize(fp) != WAVTOADPCM_HEADER_SIZE + size) {
+		GFraMe_new_log("%s is corrupted... creating it again...", name);
+		SDL_RWclose(fp);
+		fp = NULL;
+		return GFraMe_assets_encode_adpcm(filename, name, buf, frames, freq,
+			stereo);
+	}
+	
+	samples = (char*)malloc(size);
+	GFraMe_assertRV(samples, "Couldn't alloc memory",
+		rv = GFraMe_ret_memory_error, _ret);
+	tmp = SDL_RWread(fp, (void*)samples, 1, size);
+	GFraMe_SDLassertRV(tmp == size, "Error reading file",
+		rv = GFraMe_ret_failed, _ret);
+	
+	*buf = samples;
+	rv = GFraMe_ret_ok;
+_ret:
+	if (rv != GFraMe_ret_ok && samples)
+		free(samples);
+	if (fp)
+		SDL_RWclose(fp);
+	return rv;
+}
+
+/**
+ * Encode an audio's raw samples (creating them, if needed) into ADPCM and try
+ *to keep the result for the next time
+ * @param	*filename	Audio's filename (without extension)
+ * @param	*name	Path of the .adp file
+ * @param	**buf	Returns the encoded audio
+ * @param	*frames	Returns how many frames were encoded
+ * @param	*freq	Returns the sample rate, in Hz
+ * @param	*stereo	Returns whether the audio has two channels
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_assets_encode_adpcm(char *filename, char *name,
+	char **buf, int *frames, int *freq, int *stereo) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	char *samples = NULL;
+	char *pcm = NULL;
+	int len, size;
+	char header[WAVTOADPCM_HEADER_SIZE];
+	
+	rv = GFraMe_assets_buffer_audio_fmt(filename, &pcm, &len, freq, stereo);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to buffer raw audio", _ret);
+	
+	*frames = len / (*stereo ? 4 : 2);
+	size = GFraMe_adpcm_get_size(*frames, *stereo);
+	samples = (char*)malloc(size);
+	GFraMe_assertRV(samples, "Couldn't alloc memory",
+		rv = GFraMe_ret_memory_error, _ret);
+	GFraMe_adpcm_encode(samples, (Sint16*)pcm, *frames, *stereo);
+	
+	header[0] = (char)(*frames & 0xff);
+	header[1] = (char)((*frames >> 8) & 0xff);
+	header[2] = (char)((*frames >> 16) & 0xff);
+	header[3] = (char)((*frames >> 24) & 0xff);
+	header[4] = (char)(*freq & 0xff);
+	header[5] = (char)((*freq >> 8) & 0xff);
+	header[6] = (char)((*freq >> 16) & 0xff);
+	header[7] = (char)((*freq >> 24) & 0xff);
+	header[8] = *stereo ? 2 : 1;
+	header[9] = 0;
+	header[10] = 0;
+	header[11] = 0;
+	// Failing to keep it only means it's encoded again next time
+	GFraMe_assets_write_adpcm(name, header, WAVTOADPCM_HEADER_SIZE, samples,
+		size);
+	
+	*buf = samples;
+	rv = GFraMe_ret_ok;
+_ret:
+	if (rv != GFraMe_ret_ok && samples)
+		free(samples);
+	if (pcm)
+		free(pcm);
+	return rv;
+}
+
+/**
+ * Write an encoded audio into a temporary file, which only replaces the .adp
+ *file once it was completely written (so it's never left truncated)
+ * @param	*name	Path of the .adp file
+ * @param	*header	The file's header
+ * @param	header_len	Size of the header, in bytes
+ * @param	*samples	The encoded audio
+ * @param	size	Size of the encoded audio, in bytes
+ */
+static void GFraMe_assets_write_adpcm(char *name, char *header, int header_len,
+	char *samples, int size) {
+	SDL_RWops *fp;
+	char tmpname[GFraMe_max_path_len + 4];
+	int len, ok;
+	
+	len = GFraMe_util_strlen(name);
+	memcpy(tmpname, name, len);
+	memcpy(tmpname + len, ".tmp", 5);
+	fp = SDL_RWFromFile(tmpname, "wb");
+	if (!fp) {
+		GFraMe_new_log("Couldn't create %s", tmpname);
+		return;
+	}
+	ok = (SDL_RWwrite(fp, header, 1, header_len) == (size_t)header_len);
+	if (ok)
+		ok = (SDL_RWwrite(fp, samples, 1, size) == (size_t)size);
+	// Closing flushes whatever was still buffered, so it may fail as well
+	if (SDL_RWclose(fp) != 0)
+		ok = 0;
+	// Some systems won't rename over an existing (i.e., corrupted) file
+	if (ok)
+		remove(name);
+	if (ok && rename(tmpname, name) == 0)
+		return;
+	GFraMe_new_log("Couldn't write %s", name);
+	remove(tmpname);
+}
+
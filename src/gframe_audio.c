@@ -10,6 +10,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+static void GFraMe_audio_reset_params(GFraMe_audio *aud);
+
 /**
  * Loads an audio from a WAVE file into an GFraMe_audio
  * @param	*aud	Struct where the audio will be stored
@@ -23,24 +25,100 @@ GFraMe_ret GFraMe_audio_init(GFraMe_audio *aud, char *filename, int loop,
 	SDL_RWops *file = NULL;
 	GFraMe_ret rv;
 	
-	rv = GFraMe_assets_buffer_audio(filename, &(aud->buf), &(aud->len));
+	aud->stream = NULL;
+	aud->adpcm = 0;
+	GFraMe_audio_reset_params(aud);
+	// The file may override the number of channels
+	aud->stereo = stereo;
+	rv = GFraMe_assets_buffer_audio_fmt(filename, &(aud->buf), &(aud->len),
+		&(aud->freq), &(aud->stereo));
 	GFraMe_assertRV(rv == GFraMe_ret_ok, "Failed to buffer audio file",
 		rv = GFraMe_ret_failed, _ret);
 	
 	aud->loop = loop;
 	aud->loop_pos = loop_pos;
-	aud->stereo = stereo;
 _ret:
 	if (file)
 		SDL_RWclose(file);
 	return rv;
 }
 
+/**
+ * Loads an audio compressed as IMA-ADPCM, which is decoded as it's mixed
+ * @param	*aud	Struct where the audio will be stored
+ * @param	*filename	Filename of the audio source
+ * @param	loop	Whether the audio should loop or not
+ * @param	loop_pos	Sample that should be jumped to on loop
+ * @return	GFraMe_ok if the audio loaded correctly
+ */
+GFraMe_ret GFraMe_audio_init_adpcm(GFraMe_audio *aud, char *filename,
+	int loop, int loop_pos, int stereo) {
+	GFraMe_ret rv;
+	int frames;
+	
+	aud->stream = NULL;
+	aud->adpcm = 1;
+	GFraMe_audio_reset_params(aud);
+	aud->stereo = stereo;
+	rv = GFraMe_assets_buffer_audio_adpcm(filename, &(aud->buf), &frames,
+		&(aud->freq), &(aud->stereo));
+	GFraMe_assertRV(rv == GFraMe_ret_ok, "Failed to buffer audio file",
+		rv = GFraMe_ret_failed, _ret);
+	
+	aud->len = frames * (aud->stereo ? 4 : 2);
+	aud->loop = loop;
+	aud->loop_pos = loop_pos;
+_ret:
+	return rv;
+}
+
+/**
+ * Opens an audio to be streamed from disk, instead of buffering it
+ * @param	*aud	Struct where the audio will be stored
+ * @param	*filename	Filename of the audio source
+ * @param	loop	Whether the audio should loop or not
+ * @param	loop_pos	Sample that should be jumped to on loop
+ * @return	GFraMe_ok if the audio opened correctly
+ */
+GFraMe_ret GFraMe_audio_init_stream(GFraMe_audio *aud, char *filename,
+	int loop, int loop_pos, int stereo) {
+	GFraMe_ret rv;
+	
+	aud->buf = NULL;
+	aud->len = 0;
+	aud->adpcm = 0;
+	GFraMe_audio_reset_params(aud);
+	aud->stream = (GFraMe_audio_stream*)malloc(sizeof(GFraMe_audio_stream));
+	GFraMe_assertRV(aud->stream, "Failed to alloc memory",
+		rv = GFraMe_ret_memory_error, _ret);
+	
+	rv = GFraMe_audio_stream_init(aud->stream, filename, loop, loop_pos,
+		stereo);
+	GFraMe_assertRV(rv == GFraMe_ret_ok, "Failed to open audio stream",
+		rv = GFraMe_ret_failed, _ret);
+	
+	aud->loop = loop;
+	aud->loop_pos = loop_pos;
+	aud->stereo = aud->stream->stereo;
+	aud->freq = aud->stream->freq;
+_ret:
+	if (rv != GFraMe_ret_ok && aud->stream) {
+		free(aud->stream);
+		aud->stream = NULL;
+	}
+	return rv;
+}
+
 /**
  * Clear up memory allocated by the audio
  * @param	*aud	Struct which should be cleared
  */
 void GFraMe_audio_clear(GFraMe_audio *aud) {
+	if (aud->stream) {
+		GFraMe_audio_stream_clear(aud->stream);
+		free(aud->stream);
+		aud->stream = NULL;
+	}
 	free(aud->buf);
 	aud->buf = NULL;
 }
@@ -49,3 +127,31 @@ void GFraMe_audio_play(GFraMe_audio *aud, double volume) {
 	GFraMe_audio_player_push(aud, volume);
 }
 
+void GFraMe_audio_set_priority(GFraMe_audio *aud, int priority) {
+	aud->priority = priority;
+}
+
+void GFraMe_audio_set_max_instances(GFraMe_audio *aud, int num,
+	GFraMe_audio_replace replace) {
+	aud->max_instances = num;
+	aud->replace = replace;
+}
+
+void GFraMe_audio_set_bus(GFraMe_audio *aud, GFraMe_audio_bus bus) {
+	if (bus < 0 || bus >= GFraMe_audio_bus_max)
+		bus = GFraMe_audio_bus_sfx;
+	aud->bus = bus;
+}
+
+/**
+ * Let an audio play as many instances as there are voices, with the default
+ * priority, on the SFX bus
+ * @param	*aud	The audio
+ */
+static void GFraMe_audio_reset_params(GFraMe_audio *aud) {
+	aud->priority = 0;
+	aud->max_instances = 0;
+	aud->replace = GFraMe_audio_replace_oldest;
+	aud->bus = GFraMe_audio_bus_sfx;
+}
+
@@ -1,60 +1,545 @@
 /**
  * @src/gframe_audio_player.c
  */
+#include <GFraMe/GFraMe_adpcm.h>
 #include <GFraMe/GFraMe_audio.h>
 #include <GFraMe/GFraMe_audio_player.h>
+#include <GFraMe/GFraMe_audio_stream.h>
 #include <GFraMe/GFraMe_error.h>
 #include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_mixer.h>
+#include <GFraMe/GFraMe_reverb.h>
+#include <GFraMe/GFraMe_ringbuf.h>
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_thread.h>
-#include <SDL2/SDL_events.h>
+#include <SDL2/SDL_atomic.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-struct stGFraMe_audio_ll {
-	struct stGFraMe_audio_ll *next;
+/**
+ * Commands sent from the game thread to the audio callback
+ */
+enum enGFraMe_audio_cmd_type {
+	GFraMe_audio_cmd_play = 0,
+	GFraMe_audio_cmd_stop,
+	GFraMe_audio_cmd_volume,
+	GFraMe_audio_cmd_bgm,
+	GFraMe_audio_cmd_bgm_volume,
+	GFraMe_audio_cmd_max_voices,
+	GFraMe_audio_cmd_bus_volume,
+	GFraMe_audio_cmd_bus_lowpass,
+	GFraMe_audio_cmd_bus_reverb,
+	GFraMe_audio_cmd_reverb,
+	GFraMe_audio_cmd_position,
+	GFraMe_audio_cmd_listener,
+	GFraMe_audio_cmd_attenuation
+};
+
+struct stGFraMe_audio_cmd {
+	int type;
+	GFraMe_audio *audio;
+	GFraMe_audio_voice voice;
+	double volume;
+	/**
+	 * Bus modified by the command
+	 */
+	GFraMe_audio_bus bus;
+	/**
+	 * Duration of a fade, in frames
+	 */
+	int frames;
+	/**
+	 * Extra parameter (i.e., the reverb's damping)
+	 */
+	double param;
+	/**
+	 * Whether the audio is played at a position
+	 */
+	int positional;
+	/**
+	 * Position in the world
+	 */
+	double x;
+	double y;
+	/**
+	 * Audio clock's frame when the audio should start (0 to start right away)
+	 */
+	Uint64 time;
+};
+typedef struct stGFraMe_audio_cmd GFraMe_audio_cmd;
+
+/**
+ * A mix bus; only ever touched by the audio callback
+ */
+struct stGFraMe_audio_bus_state {
+	/**
+	 * Where the bus is accumulated
+	 */
+	Sint32 *buf;
+	/**
+	 * Current gain
+	 */
+	float gain;
+	/**
+	 * Gain at the end of the fade
+	 */
+	float target;
+	/**
+	 * How much the gain changes per frame, while fading
+	 */
+	float step;
+	/**
+	 * How many frames are left in the fade
+	 */
+	int fade;
+	/**
+	 * Low-pass' cutoff frequency, in Hz (0 if disabled)
+	 */
+	double cutoff;
+	/**
+	 * Low-pass' coefficient (1.0 if disabled)
+	 */
+	float lowpass;
+	/**
+	 * Low-pass' last output, for each channel
+	 */
+	float lp_state[2];
+	/**
+	 * How much is sent to the reverb
+	 */
+	float send;
+};
+typedef struct stGFraMe_audio_bus_state GFraMe_audio_bus_state;
+
+/**
+ * A playing audio; only ever touched by the audio callback
+ */
+struct stGFraMe_audio_chan {
 	GFraMe_audio *audio;
 	int pos;
 	double volume;
+	GFraMe_audio_voice voice;
+	/**
+	 * Decoder, if the audio is compressed
+	 */
+	GFraMe_adpcm_state adpcm;
+	/**
+	 * Frames carried between callbacks (only used while resampling)
+	 */
+	GFraMe_mixer_resampler resampler;
+	/**
+	 * Whether it's attenuated and panned by its position
+	 */
+	int positional;
+	/**
+	 * Position in the world
+	 */
+	double x;
+	double y;
+	/**
+	 * Volume after the distance attenuation (updated every callback)
+	 */
+	double level;
+	/**
+	 * Gain of each channel, after panning
+	 */
+	Sint16 lgain;
+	Sint16 rgain;
+	/**
+	 * Frame within the current buffer where it starts (only set on the
+	 *buffer where a scheduled audio starts)
+	 */
+	int delay;
+};
+typedef struct stGFraMe_audio_chan GFraMe_audio_chan;
+
+/**
+ * Measurements taken by the callback; copied by the game thread through
+ *timing_seq
+ */
+struct stGFraMe_audio_timing {
+	/**
+	 * Counter when the last callback started (0 if it should be ignored, e.g.
+	 *after the device was paused)
+	 */
+	Uint64 last_start;
+	/**
+	 * Counter ticks spent mixing the last buffer
+	 */
+	Uint64 last_mix;
+	/**
+	 * Longest mix and the size of its buffer, in frames
+	 */
+	Uint64 peak_mix;
+	int peak_frames;
+	/**
+	 * Ticks spent mixing and frames mixed, since the stats were reset
+	 */
+	Uint64 total_mix;
+	Uint64 total_frames;
+	int callbacks;
+	int underruns;
+	/**
+	 * Voices mixed (i.e., not culled) on the last buffer, and the most ever
+	 */
+	int voices;
+	int peak_voices;
+	/**
+	 * Counter on the first underrun of the current auto-tune window, and how
+	 *many happened since then
+	 */
+	Uint64 tune_start;
+	int tune_count;
+};
+typedef struct stGFraMe_audio_timing GFraMe_audio_timing;
+
+/**
+ * Where positional audios are heard from
+ */
+struct stGFraMe_audio_listener {
+	double x;
+	double y;
+	/**
+	 * Horizontal distance where an audio is only heard on one side
+	 */
+	double pan_dist;
+	/**
+	 * Up to which distance audios are heard at their full volume
+	 */
+	double min_dist;
+	/**
+	 * From which distance audios are no longer heard
+	 */
+	double max_dist;
 };
-typedef struct stGFraMe_audio_ll GFraMe_audio_ll;
+typedef struct stGFraMe_audio_listener GFraMe_audio_listener;
 
 static int did_audio_init = 0;
-static SDL_sem *sem_cur;
-static SDL_sem *sem_rec;
-static SDL_sem *sem_bgm;
 static SDL_AudioDeviceID dev = 0;
 static SDL_AudioSpec spec;
-int count;
-static GFraMe_audio_ll *cur;
-static GFraMe_audio_ll *recycle;
-static GFraMe_audio_ll bgm;
+/**
+ * Commands to the callback (written by the game thread, read by the callback)
+ */
+static GFraMe_ringbuf cmds;
+/**
+ * Whether the callback paused the device, as nothing was playing
+ */
+static SDL_atomic_t idle;
+/**
+ * Last voice handle given to the game thread
+ */
+static GFraMe_audio_voice last_voice = 0;
+/**
+ * Every playing audio, packed
+ */
+static GFraMe_audio_chan chans[GFraMe_audio_player_max_voices];
+/**
+ * How many audios are playing
+ */
+static int num_chans = 0;
+/**
+ * Play commands waiting for their time
+ */
+static GFraMe_audio_cmd scheduled[GFraMe_audio_player_max_scheduled];
+static int num_scheduled = 0;
+/**
+ * Audio clock: how many frames were mixed before the current (or last)
+ *buffer, and its size
+ */
+static Uint64 clock_frames = 0;
+static int clock_len = 0;
+/**
+ * Counter when the last buffer started being mixed
+ */
+static Uint64 clock_counter = 0;
+/**
+ * Sequence number around the callback's writes to the clock (odd while it's
+ *writing), so the game thread reads it without locking the device
+ */
+static SDL_atomic_t clock_seq;
+/**
+ * How many audios may play at once
+ */
+static int max_voices = GFraMe_audio_player_max_voices;
+static GFraMe_audio_chan bgm;
+static GFraMe_audio_listener listener;
+/**
+ * Size of the device's buffer, in frames (used when it's opened)
+ */
+static int samples = GFraMe_audio_player_default_samples;
+static GFraMe_audio_timing timing;
+/**
+ * Sequence number around the callback's writes to the measurements (odd while
+ *it's writing), so the game thread reads them without locking the device
+ */
+static SDL_atomic_t timing_seq;
+/**
+ * Set by the game thread to have the callback clear its measurements
+ */
+static SDL_atomic_t timing_reset;
+/**
+ * Whether the game paused the device (only used by the game thread)
+ */
+static int paused = 0;
+/**
+ * Performance counter's frequency
+ */
+static Uint64 perf_freq = 1;
+/**
+ * Whether the buffer grows when underruns keep happening
+ */
+static int auto_tune = 0;
+/**
+ * Set by the callback when auto-tune should grow the buffer
+ */
+static SDL_atomic_t grow;
+/**
+ * Buffer where every audio is accumulated, before being saturated into the
+ * stream
+ */
+static Sint32 *mixbuf = NULL;
+/**
+ * How many samples fit the mixing buffer
+ */
+static int mixbuf_len = 0;
+/**
+ * Every bus (the master bus is accumulated on the mixing buffer)
+ */
+static GFraMe_audio_bus_state buses[GFraMe_audio_bus_max];
+/**
+ * Input of the reverb
+ */
+static Sint32 *revbuf = NULL;
+static GFraMe_reverb reverb;
+/**
+ * For how many more frames the reverb should run, so its tail isn't cut
+ */
+static int reverb_tail = 0;
+/**
+ * Where streamed (or decoded) samples are written into, before being mixed
+ */
+static Sint16 *streambuf = NULL;
+/**
+ * Where the frames of an audio are written into, before being resampled
+ */
+static Sint16 *srcbuf = NULL;
+/**
+ * How many (stereo) frames fit the resampling buffer
+ */
+static int srcbuf_frames = 0;
 
 static void GFraMe_audio_player_callback(void *arg, Uint8 *stream, int len);
-static GFraMe_audio_ll* GFraMe_audio_player_remove(GFraMe_audio_ll *prev,
-											GFraMe_audio_ll *node);
-static GFraMe_audio_ll* GFraMe_audio_player_get_new_audio_ll(GFraMe_audio *aud, double volume);
-static int GFraMe_audio_player_mix(GFraMe_audio_ll *node, Uint8 *dst, int len);
-static int GFraMe_audio_player_mix_mono(GFraMe_audio_ll *node, Uint8 *dst, int len);
+static int GFraMe_audio_player_send(GFraMe_audio_cmd *cmd);
+static void GFraMe_audio_player_run_cmds();
+static int GFraMe_audio_player_mix(GFraMe_audio_chan *chan, Sint32 *acc,
+								   int frames);
+static int GFraMe_audio_player_mix_resampled(GFraMe_audio_chan *chan,
+											 Sint32 *acc, int frames);
+static int GFraMe_audio_player_pull(GFraMe_audio_chan *chan, Sint16 *dst,
+									int frames);
+static int GFraMe_audio_player_skip(GFraMe_audio_chan *chan, int frames);
+static void GFraMe_audio_player_reset_chan(GFraMe_audio_chan *chan);
+static void GFraMe_audio_player_mix_buses(int frames);
+static void GFraMe_audio_player_process_bus(GFraMe_audio_bus_state *bus,
+											int frames);
+static void GFraMe_audio_player_send_bus(int type, GFraMe_audio_bus bus,
+										 double value, int frames);
+static GFraMe_audio_voice GFraMe_audio_player_send_play(GFraMe_audio *aud,
+		double volume, int positional, double x, double y, Uint64 time);
+static void GFraMe_audio_player_update_gains(GFraMe_audio_chan *chan);
+static GFraMe_ret GFraMe_audio_player_open(int num);
+static void GFraMe_audio_player_close();
+static int GFraMe_audio_player_round_samples(int num);
+static void GFraMe_audio_player_reset_timing();
+static void GFraMe_audio_player_measure(Uint64 start, int frames, int voices);
+static void GFraMe_audio_player_start(GFraMe_audio_cmd *cmd, int delay);
+static void GFraMe_audio_player_schedule(GFraMe_audio_cmd *cmd);
+static void GFraMe_audio_player_start_due(int frames);
+static int GFraMe_audio_player_is_victim(GFraMe_audio_chan *a,
+										 GFraMe_audio_chan *b);
+static void GFraMe_audio_player_set_bgm(GFraMe_audio *aud);
 
 GFraMe_ret GFraMe_audio_player_init() {
 	GFraMe_ret rv = GFraMe_ret_ok;
-	SDL_AudioSpec wanted;
-	
+	int i;
+
 	rv = SDL_InitSubSystem(SDL_INIT_AUDIO);
 	GFraMe_SDLassertRV(rv == 0, "Failed to init audio",
 					   rv = GFraMe_ret_sdl_init_failed, _ret);
 	did_audio_init = 1;
-	
+
+	// Everything must be ready before the callback may run
+	num_chans = 0;
+	num_scheduled = 0;
+	clock_frames = 0;
+	clock_len = 0;
+	clock_counter = 0;
+	SDL_AtomicSet(&clock_seq, 0);
+	max_voices = GFraMe_audio_player_max_voices;
+	bgm.audio = NULL;
+	bgm.pos = 0;
+	bgm.volume = 0.0;
+	bgm.positional = 0;
+	listener.x = 0.0;
+	listener.y = 0.0;
+	listener.pan_dist = GFraMe_audio_player_pan_dist;
+	listener.min_dist = GFraMe_audio_player_min_dist;
+	listener.max_dist = GFraMe_audio_player_max_dist;
+	last_voice = 0;
+	SDL_AtomicSet(&idle, 1);
+	rv = GFraMe_ringbuf_init(&cmds, sizeof(GFraMe_audio_cmd)
+									* GFraMe_audio_player_max_cmds);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to create command ring",
+					 _ret);
+	i = 0;
+	while (i < GFraMe_audio_bus_max) {
+		buses[i].buf = NULL;
+		buses[i].gain = 1.0f;
+		buses[i].target = 1.0f;
+		buses[i].step = 0.0f;
+		buses[i].fade = 0;
+		buses[i].cutoff = 0.0;
+		buses[i].lowpass = 1.0f;
+		buses[i].lp_state[0] = 0.0f;
+		buses[i].lp_state[1] = 0.0f;
+		buses[i].send = 0.0f;
+		i++;
+	}
+	reverb.lines = NULL;
+	reverb_tail = 0;
+	perf_freq = SDL_GetPerformanceFrequency();
+	SDL_AtomicSet(&grow, 0);
+	SDL_AtomicSet(&timing_seq, 0);
+	SDL_AtomicSet(&timing_reset, 0);
+	GFraMe_audio_player_reset_timing();
+	paused = 0;
+
+	rv = GFraMe_audio_player_open(samples);
+_ret:
+	return rv;
+}
+
+void GFraMe_audio_player_clear() {
+	GFraMe_audio_player_close();
+	GFraMe_new_log("Closing audio...");
+	GFraMe_new_log("");
+	if (did_audio_init) {
+		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+		did_audio_init = 0;
+	}
+	GFraMe_ringbuf_clear(&cmds);
+	num_chans = 0;
+	num_scheduled = 0;
+	bgm.audio = NULL;
+	GFraMe_reverb_clear(&reverb);
+}
+
+GFraMe_ret GFraMe_audio_player_set_samples(int num) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int was_idle;
+
+	num = GFraMe_audio_player_round_samples(num);
+	if (dev == 0 || num == spec.samples) {
+		samples = num;
+		return GFraMe_ret_ok;
+	}
+	// Closing the device waits for the callback, so everything it owns may be
+	// reallocated; the playing audios are kept as they are
+	was_idle = SDL_AtomicGet(&idle);
+	GFraMe_audio_player_close();
+	rv = GFraMe_audio_player_open(num);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to reopen audio device",
+					 _ret);
+	samples = num;
+	// Reopened devices start paused; only resume what was playing
+	if (!was_idle && !paused)
+		GFraMe_audio_player_play();
+_ret:
+	return rv;
+}
+
+void GFraMe_audio_player_get_stats(GFraMe_audio_stats *stats) {
+	GFraMe_audio_timing cur;
+	Uint64 total;
+	int seq;
+
+	// Retry until the callback didn't write while they were copied (the
+	// atomics are full barriers, so the copy stays between them)
+	do {
+		seq = SDL_AtomicGet(&timing_seq);
+		cur = timing;
+	} while ((seq & 1) || seq != SDL_AtomicGet(&timing_seq));
+	// Until the callback handles a reset, report it as already done
+	if (SDL_AtomicGet(&timing_reset))
+		memset(&cur, 0x0, sizeof(cur));
+	stats->samples = spec.samples;
+	stats->latency_ms = 0.0;
+	if (spec.freq > 0)
+		stats->latency_ms = spec.samples * 1000.0 / spec.freq;
+	stats->callbacks = cur.callbacks;
+	stats->underruns = cur.underruns;
+	stats->last_ms = cur.last_mix * 1000.0 / perf_freq;
+	stats->peak_load = 0.0;
+	if (cur.peak_frames > 0)
+		stats->peak_load = (double)cur.peak_mix * spec.freq
+				/ ((double)cur.peak_frames * perf_freq);
+	stats->avg_load = 0.0;
+	total = cur.total_frames;
+	if (total > 0)
+		stats->avg_load = (double)cur.total_mix * spec.freq
+				/ ((double)total * perf_freq);
+	stats->voices = cur.voices;
+	stats->peak_voices = cur.peak_voices;
+}
+
+void GFraMe_audio_player_reset_stats() {
+	// The callback owns the measurements, so it clears them itself
+	SDL_AtomicSet(&timing_reset, 1);
+}
+
+void GFraMe_audio_player_set_auto_tune(int enable) {
+	auto_tune = enable;
+	SDL_AtomicSet(&grow, 0);
+}
+
+void GFraMe_audio_player_update() {
+	int num;
+
+	if (!auto_tune || !SDL_AtomicCAS(&grow, 1, 0))
+		return;
+	num = spec.samples * 2;
+	if (num > GFraMe_audio_player_max_samples)
+		return;
+	GFraMe_new_log("Audio underruns keep happening; using %i samples", num);
+	GFraMe_audio_player_set_samples(num);
+}
+
+/**
+ * Open the audio device and allocate everything the callback uses (which
+ *depends on the buffer's size); the device is left paused
+ * @param	num	Size of the buffer, in frames
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_audio_player_open(int num) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	SDL_AudioSpec wanted;
+	int i, freq;
+
+	freq = spec.freq;
 	wanted.freq = 44100;
+	// Keep the rate the device was running at, if it's being reopened
+	if (reverb.lines)
+		wanted.freq = freq;
 	wanted.format = AUDIO_S16LSB;
 	wanted.channels = 2;
-	wanted.samples = 1024;
+	wanted.samples = (Uint16)num;
 	wanted.callback = GFraMe_audio_player_callback;
 	wanted.userdata = 0;
-	
-	dev = SDL_OpenAudioDevice(NULL, 0, &wanted, &spec, 0);
+
+	// Run at the device's native rate; audios are resampled while mixing
+	dev = SDL_OpenAudioDevice(NULL, 0, &wanted, &spec,
+							  SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
 	GFraMe_SDLassertRV(dev > 0, "Failed to open audio device",
 					 rv = GFraMe_ret_failed, _ret);
 	GFraMe_new_log("Initializing audio...");
@@ -70,49 +555,113 @@ GFraMe_ret GFraMe_audio_player_init() {
 	// GFraMe_new_log("|   Bytes per sample: %i\n", bytesPerSample);
 	GFraMe_new_log("=============================");
 	GFraMe_new_log("");
-	
-	cur = NULL;
-	recycle = NULL;
-	bgm.next = NULL;
-	bgm.audio = NULL;
-	count = 0;
-	
-	sem_cur = SDL_CreateSemaphore(1);
-	GFraMe_SDLassertRV(sem_cur != NULL, "Failed to create semaphore",
-					 rv = GFraMe_ret_failed, _ret);
-	sem_rec = SDL_CreateSemaphore(1);
-	GFraMe_SDLassertRV(sem_rec != NULL, "Failed to create semaphore",
-					 rv = GFraMe_ret_failed, _ret);
-	sem_bgm = SDL_CreateSemaphore(1);
-	GFraMe_SDLassertRV(sem_bgm != NULL, "Failed to create semaphore",
-					 rv = GFraMe_ret_failed, _ret);
+
+	// The callback is always requested the same amount of bytes (and it only
+	// runs once the device is unpaused)
+	mixbuf_len = spec.size / sizeof(Sint16);
+	mixbuf = (Sint32*)malloc(sizeof(Sint32) * mixbuf_len);
+	GFraMe_assertRV(mixbuf != NULL, "Failed to alloc mixing buffer",
+					rv = GFraMe_ret_memory_error, _ret);
+	streambuf = (Sint16*)malloc(sizeof(Sint16) * mixbuf_len);
+	GFraMe_assertRV(streambuf != NULL, "Failed to alloc streaming buffer",
+					rv = GFraMe_ret_memory_error, _ret);
+	// Fits a whole callback of audios at up to 4x the device's rate (higher
+	// ratios are resampled in parts)
+	srcbuf_frames = mixbuf_len * 2 + 2;
+	srcbuf = (Sint16*)malloc(sizeof(Sint16) * 2 * srcbuf_frames);
+	GFraMe_assertRV(srcbuf != NULL, "Failed to alloc resampling buffer",
+					rv = GFraMe_ret_memory_error, _ret);
+	i = 0;
+	while (i < GFraMe_audio_bus_max) {
+		if (i == GFraMe_audio_bus_master)
+			buses[i].buf = mixbuf;
+		else {
+			buses[i].buf = (Sint32*)malloc(sizeof(Sint32) * mixbuf_len);
+			GFraMe_assertRV(buses[i].buf != NULL, "Failed to alloc bus",
+							rv = GFraMe_ret_memory_error, _ret);
+		}
+		// Filters depend on the rate, which may have changed
+		buses[i].lowpass = GFraMe_mixer_get_lowpass(buses[i].cutoff,
+													spec.freq);
+		i++;
+	}
+	revbuf = (Sint32*)malloc(sizeof(Sint32) * mixbuf_len);
+	GFraMe_assertRV(revbuf != NULL, "Failed to alloc reverb buffer",
+					rv = GFraMe_ret_memory_error, _ret);
+	if (!reverb.lines || freq != spec.freq) {
+		GFraMe_reverb_clear(&reverb);
+		rv = GFraMe_reverb_init(&reverb, spec.freq);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to create reverb",
+						 _ret);
+	}
+	timing.last_start = 0;
 _ret:
 	return rv;
 }
 
-void GFraMe_audio_player_clear() {
+/**
+ * Close the audio device (waiting for the callback) and release the buffers
+ *allocated by GFraMe_audio_player_open
+ */
+static void GFraMe_audio_player_close() {
+	int i;
+
 	if (dev != 0)
 		SDL_CloseAudioDevice(dev);
-	SDL_DestroySemaphore(sem_cur);
-	SDL_DestroySemaphore(sem_rec);
-	SDL_DestroySemaphore(sem_bgm);
-	GFraMe_new_log("Closing audio...");
-	GFraMe_new_log("");
 	dev = 0;
-	if (did_audio_init) {
-		SDL_QuitSubSystem(SDL_INIT_AUDIO);
-		did_audio_init = 0;
-	}
-	while (cur) {
-		GFraMe_audio_ll *tmp = cur;
-		cur = cur->next;
-		free(tmp);
-	}
-	while (recycle) {
-		GFraMe_audio_ll *tmp = recycle;
-		recycle = recycle->next;
-		free(tmp);
+	if (mixbuf)
+		free(mixbuf);
+	mixbuf = NULL;
+	if (streambuf)
+		free(streambuf);
+	streambuf = NULL;
+	if (srcbuf)
+		free(srcbuf);
+	srcbuf = NULL;
+	srcbuf_frames = 0;
+	i = 0;
+	while (i < GFraMe_audio_bus_max) {
+		if (i != GFraMe_audio_bus_master && buses[i].buf)
+			free(buses[i].buf);
+		buses[i].buf = NULL;
+		i++;
 	}
+	if (revbuf)
+		free(revbuf);
+	revbuf = NULL;
+	mixbuf_len = 0;
+}
+
+/**
+ * Round a buffer size to a power of two, within the supported range
+ * @param	num	The requested size, in frames
+ * @return	The size that should be used
+ */
+static int GFraMe_audio_player_round_samples(int num) {
+	int pow;
+
+	pow = GFraMe_audio_player_min_samples;
+	while (pow < num && pow < GFraMe_audio_player_max_samples)
+		pow *= 2;
+	return pow;
+}
+
+/**
+ * Clear every measurement taken by the callback
+ */
+static void GFraMe_audio_player_reset_timing() {
+	timing.last_start = 0;
+	timing.last_mix = 0;
+	timing.peak_mix = 0;
+	timing.peak_frames = 0;
+	timing.total_mix = 0;
+	timing.total_frames = 0;
+	timing.callbacks = 0;
+	timing.underruns = 0;
+	timing.voices = 0;
+	timing.peak_voices = 0;
+	timing.tune_start = 0;
+	timing.tune_count = 0;
 }
 
 SDL_AudioSpec* GFraMe_audio_player_get_spec() {
@@ -120,186 +669,989 @@ SDL_AudioSpec* GFraMe_audio_player_get_spec() {
 }
 
 void GFraMe_audio_player_play_bgm(GFraMe_audio *aud, double volume) {
-	if (aud != bgm.audio) {
-		SDL_SemWait(sem_bgm);
-		if (aud && !bgm.audio) {
-			GFraMe_audio_player_play();
-			count++;
-		}
-		else if (!aud && bgm.audio)
-			count--;
-		bgm.audio = aud;
-		bgm.pos = 0;
-		SDL_SemPost(sem_bgm);
-	}
-	bgm.volume = volume;
+	GFraMe_audio_cmd cmd;
+
+	cmd.type = GFraMe_audio_cmd_bgm;
+	cmd.audio = aud;
+	cmd.voice = 0;
+	cmd.volume = volume;
+	GFraMe_audio_player_send(&cmd);
 }
 
 void GFraMe_audio_player_set_bgm_volume(double volume) {
-	bgm.volume = volume;
+	GFraMe_audio_cmd cmd;
+
+	cmd.type = GFraMe_audio_cmd_bgm_volume;
+	cmd.audio = NULL;
+	cmd.voice = 0;
+	cmd.volume = volume;
+	GFraMe_audio_player_send(&cmd);
 }
 
 void GFraMe_audio_player_push(GFraMe_audio *aud, double volume) {
-	int start_audio = 0;
-	GFraMe_audio_ll *node;
-	node = GFraMe_audio_player_get_new_audio_ll(aud, volume);
-	SDL_SemWait(sem_cur);
-	node->next = cur;
-	start_audio = !cur && !bgm.audio;
-	cur = node;
-	SDL_SemPost(sem_cur);
-	count++;
-	if (start_audio)
-		GFraMe_audio_player_play();
+	GFraMe_audio_player_push_voice(aud, volume);
+}
+
+GFraMe_audio_voice GFraMe_audio_player_push_voice(GFraMe_audio *aud,
+												  double volume) {
+	return GFraMe_audio_player_send_play(aud, volume, 0, 0.0, 0.0, 0);
 }
 
-static GFraMe_audio_ll* GFraMe_audio_player_remove(GFraMe_audio_ll *prev,
-											GFraMe_audio_ll *node) {
-	GFraMe_audio_ll *ret;
-	if (prev) {
-		prev->next = node->next;
-		ret = prev->next;
+GFraMe_audio_voice GFraMe_audio_player_push_at(GFraMe_audio *aud,
+											   double volume, double x,
+											   double y) {
+	return GFraMe_audio_player_send_play(aud, volume, 1, x, y, 0);
+}
+
+GFraMe_audio_voice GFraMe_audio_player_push_scheduled(GFraMe_audio *aud,
+													  double volume,
+													  Uint64 time) {
+	// 0 means "right away", which is what any past frame means as well
+	if (time == 0)
+		time = 1;
+	return GFraMe_audio_player_send_play(aud, volume, 0, 0.0, 0.0, time);
+}
+
+GFraMe_audio_voice GFraMe_audio_player_push_delayed(GFraMe_audio *aud,
+													double volume, int ms) {
+	Uint64 time;
+
+	if (ms < 0)
+		ms = 0;
+	time = GFraMe_audio_player_get_clock() + (Uint64)ms * spec.freq / 1000;
+	return GFraMe_audio_player_push_scheduled(aud, volume, time);
+}
+
+Uint64 GFraMe_audio_player_get_clock() {
+	Uint64 clock, counter, elapsed, frames;
+	int len, seq;
+
+	// Retry until the callback didn't write the clock while it was read (the
+	// atomics are full barriers, so the reads stay between them)
+	do {
+		seq = SDL_AtomicGet(&clock_seq);
+		clock = clock_frames;
+		len = clock_len;
+		counter = clock_counter;
+	} while ((seq & 1) || seq != SDL_AtomicGet(&clock_seq));
+	// Start from the first frame that wasn't mixed yet, so anything scheduled
+	// from now on is never already late
+	clock += len;
+	frames = 0;
+	if (dev != 0 && counter != 0) {
+		// Advance smoothly until the next buffer, but never past it
+		elapsed = SDL_GetPerformanceCounter() - counter;
+		frames = elapsed * spec.freq / perf_freq;
+		if (frames > (Uint64)len)
+			frames = len;
 	}
-	else {
-		SDL_SemWait(sem_cur);
-		cur = node->next;
-		ret = cur;
-		SDL_SemPost(sem_cur);
+	return clock + frames;
+}
+
+void GFraMe_audio_player_set_position(GFraMe_audio_voice voice, double x,
+									  double y) {
+	GFraMe_audio_cmd cmd;
+
+	cmd.type = GFraMe_audio_cmd_position;
+	cmd.audio = NULL;
+	cmd.voice = voice;
+	cmd.volume = 0.0;
+	cmd.x = x;
+	cmd.y = y;
+	GFraMe_audio_player_send(&cmd);
+}
+
+void GFraMe_audio_player_set_listener(double x, double y) {
+	GFraMe_audio_cmd cmd;
+
+	cmd.type = GFraMe_audio_cmd_listener;
+	cmd.audio = NULL;
+	cmd.voice = 0;
+	cmd.volume = 0.0;
+	cmd.param = 0.0;
+	cmd.x = x;
+	cmd.y = y;
+	GFraMe_audio_player_send(&cmd);
+}
+
+void GFraMe_audio_player_set_listener_camera(int cam_x, int cam_y, int cam_w,
+											 int cam_h) {
+	GFraMe_audio_cmd cmd;
+
+	cmd.type = GFraMe_audio_cmd_listener;
+	cmd.audio = NULL;
+	cmd.voice = 0;
+	cmd.volume = 0.0;
+	// Audios on the screen's edges are panned the most
+	cmd.param = cam_w * 0.5;
+	cmd.x = cam_x + cam_w * 0.5;
+	cmd.y = cam_y + cam_h * 0.5;
+	GFraMe_audio_player_send(&cmd);
+}
+
+void GFraMe_audio_player_set_attenuation(double min_dist, double max_dist) {
+	GFraMe_audio_cmd cmd;
+
+	if (min_dist < 0.0)
+		min_dist = 0.0;
+	if (max_dist <= min_dist)
+		max_dist = min_dist + 1.0;
+	cmd.type = GFraMe_audio_cmd_attenuation;
+	cmd.audio = NULL;
+	cmd.voice = 0;
+	cmd.volume = min_dist;
+	cmd.param = max_dist;
+	GFraMe_audio_player_send(&cmd);
+}
+
+/**
+ * Send a command to play an audio
+ * @param	*aud	The audio
+ * @param	volume	The audio's volume
+ * @param	positional	Whether it's played at a position
+ * @param	x	Horizontal position, in world space
+ * @param	y	Vertical position, in world space
+ * @param	time	Audio clock's frame when it starts (0 to start right away)
+ * @return	The voice's handle (or 0, if it can't be played or the command
+ *			was dropped)
+ */
+static GFraMe_audio_voice GFraMe_audio_player_send_play(GFraMe_audio *aud,
+		double volume, int positional, double x, double y, Uint64 time) {
+	GFraMe_audio_cmd cmd;
+
+	if (aud->stream) {
+		GFraMe_log("Streamed audios may only be played as the BGM");
+		return 0;
 	}
-	SDL_SemWait(sem_rec);
-	node->next = recycle;
-	recycle = node;
-	SDL_SemPost(sem_rec);
-	return ret;
+	cmd.type = GFraMe_audio_cmd_play;
+	cmd.audio = aud;
+	cmd.voice = last_voice + 1;
+	if (cmd.voice == 0)
+		cmd.voice = 1;
+	cmd.volume = volume;
+	cmd.positional = positional;
+	cmd.x = x;
+	cmd.y = y;
+	cmd.time = time;
+	// A dropped command never plays, so it mustn't get a handle
+	if (!GFraMe_audio_player_send(&cmd))
+		return 0;
+	last_voice = cmd.voice;
+	return last_voice;
+}
+
+void GFraMe_audio_player_stop(GFraMe_audio_voice voice) {
+	GFraMe_audio_cmd cmd;
+
+	cmd.type = GFraMe_audio_cmd_stop;
+	cmd.audio = NULL;
+	cmd.voice = voice;
+	cmd.volume = 0.0;
+	GFraMe_audio_player_send(&cmd);
+}
+
+void GFraMe_audio_player_set_volume(GFraMe_audio_voice voice, double volume) {
+	GFraMe_audio_cmd cmd;
+
+	cmd.type = GFraMe_audio_cmd_volume;
+	cmd.audio = NULL;
+	cmd.voice = voice;
+	cmd.volume = volume;
+	GFraMe_audio_player_send(&cmd);
+}
+
+void GFraMe_audio_player_set_max_voices(int num) {
+	GFraMe_audio_cmd cmd;
+
+	if (num < 0)
+		num = 0;
+	else if (num > GFraMe_audio_player_max_voices)
+		num = GFraMe_audio_player_max_voices;
+	cmd.type = GFraMe_audio_cmd_max_voices;
+	cmd.audio = NULL;
+	cmd.voice = (GFraMe_audio_voice)num;
+	cmd.volume = 0.0;
+	GFraMe_audio_player_send(&cmd);
 }
 
-static GFraMe_audio_ll* GFraMe_audio_player_get_new_audio_ll(GFraMe_audio *aud,
-															 double volume) {
-	GFraMe_audio_ll *node;
-	SDL_SemWait(sem_rec);
-	if (!recycle)
-		node = (GFraMe_audio_ll*)malloc(sizeof(GFraMe_audio_ll));
-	else {
-		node = recycle;
-		recycle = recycle->next;
+void GFraMe_audio_player_set_bus_volume(GFraMe_audio_bus bus, double volume,
+										int ms) {
+	int frames;
+
+	frames = 0;
+	if (ms > 0)
+		frames = (int)((Sint64)ms * spec.freq / 1000);
+	GFraMe_audio_player_send_bus(GFraMe_audio_cmd_bus_volume, bus, volume,
+								 frames);
+}
+
+void GFraMe_audio_player_set_bus_lowpass(GFraMe_audio_bus bus, double cutoff) {
+	GFraMe_audio_player_send_bus(GFraMe_audio_cmd_bus_lowpass, bus, cutoff, 0);
+}
+
+void GFraMe_audio_player_set_bus_reverb(GFraMe_audio_bus bus, double send) {
+	if (bus == GFraMe_audio_bus_master)
+		return;
+	GFraMe_audio_player_send_bus(GFraMe_audio_cmd_bus_reverb, bus, send, 0);
+}
+
+void GFraMe_audio_player_set_reverb(double room, double damp) {
+	GFraMe_audio_cmd cmd;
+
+	cmd.type = GFraMe_audio_cmd_reverb;
+	cmd.audio = NULL;
+	cmd.voice = 0;
+	cmd.volume = room;
+	cmd.bus = GFraMe_audio_bus_master;
+	cmd.frames = 0;
+	cmd.param = damp;
+	GFraMe_audio_player_send(&cmd);
+}
+
+/**
+ * Send a command that modifies a bus
+ */
+static void GFraMe_audio_player_send_bus(int type, GFraMe_audio_bus bus,
+										 double value, int frames) {
+	GFraMe_audio_cmd cmd;
+
+	if (bus < 0 || bus >= GFraMe_audio_bus_max)
+		return;
+	cmd.type = type;
+	cmd.audio = NULL;
+	cmd.voice = 0;
+	cmd.volume = value;
+	cmd.bus = bus;
+	cmd.frames = frames;
+	cmd.param = 0.0;
+	GFraMe_audio_player_send(&cmd);
+}
+
+/**
+ * Send a command to the callback, waking the device if it was idle
+ * @return	1 - The command was sent; 0 - The ring was full and it was dropped
+ */
+static int GFraMe_audio_player_send(GFraMe_audio_cmd *cmd) {
+	if (GFraMe_ringbuf_get_free(&cmds) < (int)sizeof(GFraMe_audio_cmd)) {
+		GFraMe_log("Audio command ring is full; dropping command");
+		return 0;
+	}
+	GFraMe_ringbuf_write(&cmds, cmd, sizeof(GFraMe_audio_cmd));
+	// Commands sent while the game paused the device wait until it's resumed
+	if (SDL_AtomicCAS(&idle, 1, 0) && !paused)
+		GFraMe_audio_player_play();
+	return 1;
+}
+
+/**
+ * Run every command sent since the last callback
+ */
+static void GFraMe_audio_player_run_cmds() {
+	GFraMe_audio_cmd cmd;
+
+	while (GFraMe_ringbuf_read(&cmds, &cmd, sizeof(GFraMe_audio_cmd))
+			== sizeof(GFraMe_audio_cmd)) {
+		int i;
+
+		switch (cmd.type) {
+			case GFraMe_audio_cmd_play: {
+				if (cmd.time != 0)
+					GFraMe_audio_player_schedule(&cmd);
+				else
+					GFraMe_audio_player_start(&cmd, 0);
+			} break;
+			case GFraMe_audio_cmd_stop:
+			case GFraMe_audio_cmd_volume:
+			case GFraMe_audio_cmd_position: {
+				i = 0;
+				while (i < num_scheduled && scheduled[i].voice != cmd.voice)
+					i++;
+				if (i < num_scheduled) {
+					// Modify it before it even starts
+					if (cmd.type == GFraMe_audio_cmd_volume)
+						scheduled[i].volume = cmd.volume;
+					else if (cmd.type == GFraMe_audio_cmd_position) {
+						scheduled[i].x = cmd.x;
+						scheduled[i].y = cmd.y;
+					}
+					else {
+						num_scheduled--;
+						scheduled[i] = scheduled[num_scheduled];
+					}
+					break;
+				}
+				i = 0;
+				while (i < num_chans && chans[i].voice != cmd.voice)
+					i++;
+				if (i == num_chans)
+					break;
+				if (cmd.type == GFraMe_audio_cmd_volume)
+					chans[i].volume = cmd.volume;
+				else if (cmd.type == GFraMe_audio_cmd_position) {
+					chans[i].x = cmd.x;
+					chans[i].y = cmd.y;
+				}
+				else {
+					num_chans--;
+					chans[i] = chans[num_chans];
+				}
+			} break;
+			case GFraMe_audio_cmd_bgm: {
+				if (cmd.audio != bgm.audio)
+					GFraMe_audio_player_set_bgm(cmd.audio);
+				bgm.volume = cmd.volume;
+			} break;
+			case GFraMe_audio_cmd_bgm_volume: {
+				bgm.volume = cmd.volume;
+			} break;
+			case GFraMe_audio_cmd_max_voices: {
+				max_voices = (int)cmd.voice;
+				// Drop the least important audios that no longer fit
+				while (num_chans > max_voices) {
+					int victim = 0;
+
+					i = 1;
+					while (i < num_chans) {
+						if (GFraMe_audio_player_is_victim(chans + i,
+								chans + victim))
+							victim = i;
+						i++;
+					}
+					num_chans--;
+					chans[victim] = chans[num_chans];
+				}
+			} break;
+			case GFraMe_audio_cmd_bus_volume: {
+				GFraMe_audio_bus_state *bus = buses + cmd.bus;
+
+				bus->target = (float)cmd.volume;
+				if (bus->target < 0.0f)
+					bus->target = 0.0f;
+				bus->fade = cmd.frames;
+				if (bus->fade > 0)
+					bus->step = (bus->target - bus->gain) / bus->fade;
+				else
+					bus->gain = bus->target;
+			} break;
+			case GFraMe_audio_cmd_bus_lowpass: {
+				buses[cmd.bus].cutoff = cmd.volume;
+				buses[cmd.bus].lowpass = GFraMe_mixer_get_lowpass(cmd.volume,
+																  spec.freq);
+			} break;
+			case GFraMe_audio_cmd_bus_reverb: {
+				buses[cmd.bus].send = (float)cmd.volume;
+			} break;
+			case GFraMe_audio_cmd_reverb: {
+				GFraMe_reverb_set(&reverb, cmd.volume, cmd.param);
+			} break;
+			case GFraMe_audio_cmd_listener: {
+				listener.x = cmd.x;
+				listener.y = cmd.y;
+				if (cmd.param > 0.0)
+					listener.pan_dist = cmd.param;
+			} break;
+			case GFraMe_audio_cmd_attenuation: {
+				listener.min_dist = cmd.volume;
+				listener.max_dist = cmd.param;
+			} break;
+		}
 	}
-	SDL_SemPost(sem_rec);
-	node->audio = aud;
-	node->pos = 0;
-	node->volume = volume;
-	return node;
 }
 
 static void GFraMe_audio_player_callback(void *arg, Uint8 *stream, int len) {
-	GFraMe_audio_ll *node;
-	GFraMe_audio_ll *prev = NULL;
-	SDL_SemPost(sem_cur);
-	node = cur;
-	SDL_SemPost(sem_cur);
+	Uint64 start;
+	int i, num, frames, voices;
+
+	start = SDL_GetPerformanceCounter();
+	GFraMe_audio_player_run_cmds();
+	// Output is signed 16 bits stereo
 	memset(stream, 0x0, len);
-	while (node) {
-		int remove;
-		if (node->audio->stereo)
-			remove = GFraMe_audio_player_mix(node, stream, len);
-		else
-			remove = GFraMe_audio_player_mix_mono(node, stream, len);
-		if (remove)
-			node = GFraMe_audio_player_remove(prev, node);
+	num = len / sizeof(Sint16);
+	if (num > mixbuf_len)
+		num = mixbuf_len;
+	frames = num / 2;
+	voices = 0;
+	// This buffer starts at frame 'clock_frames' of the audio clock
+	SDL_AtomicIncRef(&clock_seq);
+	clock_frames += clock_len;
+	clock_len = frames;
+	clock_counter = start;
+	SDL_AtomicIncRef(&clock_seq);
+	GFraMe_audio_player_start_due(frames);
+	i = 0;
+	while (i < GFraMe_audio_bus_max) {
+		memset(buses[i].buf, 0x0, sizeof(Sint32) * num);
+		i++;
+	}
+	i = 0;
+	while (i < num_chans) {
+		int done, delay;
+
+		// Scheduled audios start exactly at their frame
+		delay = chans[i].delay;
+		chans[i].delay = 0;
+		// Inaudible audios (e.g., too far from the listener) only advance, so
+		// they don't cost a mix
+		GFraMe_audio_player_update_gains(chans + i);
+		if (chans[i].level < GFraMe_audio_player_cull_volume)
+			done = GFraMe_audio_player_skip(chans + i, frames - delay);
 		else {
-			prev = node;
-			node = node->next;
+			done = GFraMe_audio_player_mix(chans + i,
+					buses[chans[i].audio->bus].buf + delay * 2,
+					frames - delay);
+			voices++;
+		}
+		if (done) {
+			// Move the last audio into this position
+			num_chans--;
+			chans[i] = chans[num_chans];
 		}
+		else
+			i++;
 	}
-	SDL_SemWait(sem_bgm);
+	GFraMe_audio_player_update_gains(&bgm);
 	if (bgm.audio) {
-		if (GFraMe_audio_player_mix(&bgm, stream, len)) {
-            bgm.audio = 0;
-            count--;
-        }
-	}
-	SDL_SemPost(sem_bgm);
-	if (!cur && !bgm.audio)
-		GFraMe_audio_player_pause();
-}
-
-static int GFraMe_audio_player_mix(GFraMe_audio_ll *node, Uint8 *dst, int len) {
-	int i = 0;
-	while (i < len) {
-		// Get the data to be put into both channels
-		Sint16 chan1 = (node->audio->buf[i + node->pos] & 0x00ff)
-					 | ((node->audio->buf[i + node->pos + 1] << 8) & 0xff00);
-		Sint16 chan2 = (node->audio->buf[i + node->pos + 2] & 0x00ff)
-					 | ((node->audio->buf[i + node->pos + 3] << 8) & 0xff00);
-		// Modify its volume
-		chan1 = ((Sint16)(chan1*node->volume))&0xffff;
-		chan2 = ((Sint16)(chan2*node->volume))&0xffff;
-		// Add it to the channel
-		dst[i] += (Uint8)(chan1&0xff);
-		dst[i+1] += (Uint8)((chan1>>8)&0xff);
-		dst[i+2] += (Uint8)(chan2&0xff);
-		dst[i+3] += (Uint8)((chan2>>8)&0xff);
-		
-		i += 4;
-		// If the sample is over
-		if (i + node->pos >= node->audio->len) {
-			// Loop it
-			if (node->audio->loop) {
-				len -= i;
-				i = 0;
-				node->pos = node->audio->loop_pos;
+		voices++;
+		if (GFraMe_audio_player_mix(&bgm, buses[GFraMe_audio_bus_music].buf,
+									frames))
+			GFraMe_audio_player_set_bgm(NULL);
+	}
+	GFraMe_audio_player_mix_buses(frames);
+	// Saturate only once, after every audio was accumulated
+	GFraMe_mixer_saturate((Sint16*)stream, mixbuf, num);
+	GFraMe_audio_player_measure(start, frames, voices);
+	if (num_chans == 0 && !bgm.audio && num_scheduled == 0) {
+		// If a command arrived in the meantime, either keep running or let
+		// the game thread wake the device
+		SDL_AtomicSet(&idle, 1);
+		if (GFraMe_ringbuf_get_used(&cmds) == 0
+				|| !SDL_AtomicCAS(&idle, 1, 0)) {
+			SDL_PauseAudioDevice(dev, 1);
+			// Don't take the time spent paused for an underrun
+			timing.last_start = 0;
+		}
+	}
+}
+
+/**
+ * Measure how long the callback took and check whether it was called too late
+ *(i.e., the device ran out of samples)
+ * @param	start	Counter when the callback started
+ * @param	frames	How many (stereo) frames were mixed
+ * @param	voices	How many voices were mixed
+ */
+static void GFraMe_audio_player_measure(Uint64 start, int frames, int voices) {
+	Uint64 mix, expected;
+
+	mix = SDL_GetPerformanceCounter() - start;
+	SDL_AtomicIncRef(&timing_seq);
+	if (SDL_AtomicCAS(&timing_reset, 1, 0))
+		GFraMe_audio_player_reset_timing();
+	// Backends usually queue a buffer ahead, so only a gap of over two whole
+	// buffers means the device starved
+	expected = perf_freq * frames / spec.freq;
+	if (timing.last_start != 0 && start - timing.last_start > expected * 2) {
+		timing.underruns++;
+		if (timing.tune_count == 0 || start - timing.tune_start
+				> perf_freq * GFraMe_audio_player_tune_ms / 1000) {
+			timing.tune_start = start;
+			timing.tune_count = 0;
+		}
+		timing.tune_count++;
+		if (timing.tune_count >= GFraMe_audio_player_tune_underruns) {
+			SDL_AtomicSet(&grow, 1);
+			timing.tune_count = 0;
+		}
+	}
+	timing.last_start = start;
+	timing.last_mix = mix;
+	if (mix * timing.peak_frames >= timing.peak_mix * frames) {
+		timing.peak_mix = mix;
+		timing.peak_frames = frames;
+	}
+	timing.total_mix += mix;
+	timing.total_frames += frames;
+	timing.callbacks++;
+	timing.voices = voices;
+	if (voices > timing.peak_voices)
+		timing.peak_voices = voices;
+	SDL_AtomicIncRef(&timing_seq);
+}
+
+/**
+ * Process every bus (once each, no matter how many audios it has) and
+ *accumulate them (and the reverb) into the master bus
+ * @param	frames	How many (stereo) frames there are
+ */
+static void GFraMe_audio_player_mix_buses(int frames) {
+	Sint32 *master = buses[GFraMe_audio_bus_master].buf;
+	int i, j, num;
+
+	num = frames * 2;
+	i = 0;
+	while (i < GFraMe_audio_bus_max) {
+		if (buses[i].send > 0.0f)
+			reverb_tail = spec.freq * 4;
+		i++;
+	}
+	if (reverb_tail > 0)
+		memset(revbuf, 0x0, sizeof(Sint32) * num);
+	i = 0;
+	while (i < GFraMe_audio_bus_max) {
+		GFraMe_audio_bus_state *bus = buses + i;
+
+		if (i == GFraMe_audio_bus_master) {
+			i++;
+			continue;
+		}
+		GFraMe_audio_player_process_bus(bus, frames);
+		if (bus->send > 0.0f) {
+			j = 0;
+			while (j < num) {
+				revbuf[j] += (Sint32)(bus->buf[j] * bus->send);
+				j++;
 			}
+		}
+		j = 0;
+		while (j < num) {
+			master[j] += bus->buf[j];
+			j++;
+		}
+		i++;
+	}
+	if (reverb_tail > 0) {
+		GFraMe_reverb_process(&reverb, master, revbuf, frames);
+		reverb_tail -= frames;
+	}
+	GFraMe_audio_player_process_bus(buses + GFraMe_audio_bus_master, frames);
+}
+
+/**
+ * Apply a bus' gain (fading it) and low-pass
+ * @param	*bus	The bus
+ * @param	frames	How many (stereo) frames there are
+ */
+static void GFraMe_audio_player_process_bus(GFraMe_audio_bus_state *bus,
+											int frames) {
+	if (bus->fade > 0) {
+		int ramp = bus->fade;
+
+		if (ramp > frames)
+			ramp = frames;
+		GFraMe_mixer_gain(bus->buf, frames, &bus->gain, bus->step, ramp);
+		bus->fade -= ramp;
+		if (bus->fade == 0)
+			bus->gain = bus->target;
+	}
+	else if (bus->gain != 1.0f)
+		GFraMe_mixer_gain(bus->buf, frames, &bus->gain, 0.0f, 0);
+	if (bus->lowpass < 1.0f)
+		GFraMe_mixer_lowpass(bus->buf, frames, bus->lowpass, bus->lp_state);
+}
+
+/**
+ * Keep a play command until its time comes
+ * @param	*cmd	The play command
+ */
+static void GFraMe_audio_player_schedule(GFraMe_audio_cmd *cmd) {
+	if (num_scheduled == GFraMe_audio_player_max_scheduled) {
+		// Better late than never
+		GFraMe_audio_player_start(cmd, 0);
+		return;
+	}
+	scheduled[num_scheduled] = *cmd;
+	num_scheduled++;
+}
+
+/**
+ * Start every scheduled audio whose time falls within the current buffer, at
+ *its exact frame (those already late start at the buffer's start)
+ * @param	frames	How many (stereo) frames the buffer has
+ */
+static void GFraMe_audio_player_start_due(int frames) {
+	int i;
+
+	i = 0;
+	while (i < num_scheduled) {
+		GFraMe_audio_cmd *cmd = scheduled + i;
+		int delay;
+
+		if (cmd->time >= clock_frames + frames) {
+			i++;
+			continue;
+		}
+		delay = 0;
+		if (cmd->time > clock_frames)
+			delay = (int)(cmd->time - clock_frames);
+		GFraMe_audio_player_start(cmd, delay);
+		num_scheduled--;
+		scheduled[i] = scheduled[num_scheduled];
+	}
+}
+
+/**
+ * Start playing an audio, respecting both its and the player's limits
+ * @param	*cmd	The play command
+ * @param	delay	Frame within the current buffer where it starts
+ */
+static void GFraMe_audio_player_start(GFraMe_audio_cmd *cmd, int delay) {
+	GFraMe_audio *aud = cmd->audio;
+	GFraMe_audio_chan chan;
+	int i, slot;
+
+	chan.audio = aud;
+	chan.volume = cmd->volume;
+	chan.voice = cmd->voice;
+	chan.positional = cmd->positional;
+	chan.x = cmd->x;
+	chan.y = cmd->y;
+	GFraMe_audio_player_update_gains(&chan);
+	slot = -1;
+	if (aud->max_instances > 0) {
+		int count = 0;
+
+		// Look for the instance that would be replaced
+		i = 0;
+		while (i < num_chans) {
+			if (chans[i].audio == aud) {
+				count++;
+				if (slot == -1)
+					slot = i;
+				else if (aud->replace == GFraMe_audio_replace_quietest
+						&& chans[i].level < chans[slot].level)
+					slot = i;
+				else if (aud->replace != GFraMe_audio_replace_quietest
+						&& (int)(chans[i].voice - chans[slot].voice) < 0)
+					slot = i;
+			}
+			i++;
+		}
+		if (count < aud->max_instances)
+			slot = -1;
+		else if (aud->replace == GFraMe_audio_replace_none)
+			return;
+	}
+	if (slot == -1 && num_chans < max_voices)
+		slot = num_chans++;
+	else if (slot == -1) {
+		if (num_chans == 0)
+			return;
+		// Steal the least important voice, unless it's more important
+		slot = 0;
+		i = 1;
+		while (i < num_chans) {
+			if (GFraMe_audio_player_is_victim(chans + i, chans + slot))
+				slot = i;
+			i++;
+		}
+		if (chans[slot].audio->priority > aud->priority)
+			return;
+		// Don't replace anything with an audio that can't be heard
+		if (chan.level < GFraMe_audio_player_cull_volume
+				&& chans[slot].level >= GFraMe_audio_player_cull_volume)
+			return;
+	}
+	chans[slot] = chan;
+	GFraMe_audio_player_reset_chan(chans + slot);
+	chans[slot].delay = delay;
+}
+
+/**
+ * Check whether a voice should be stolen before another one
+ * @param	*a	The voice being checked
+ * @param	*b	The current candidate
+ * @return	1 - 'a' is less important; 0 - Otherwise
+ */
+static int GFraMe_audio_player_is_victim(GFraMe_audio_chan *a,
+										 GFraMe_audio_chan *b) {
+	if (a->audio->priority != b->audio->priority)
+		return a->audio->priority < b->audio->priority;
+	if (a->level != b->level)
+		return a->level < b->level;
+	// Handles are given in order, so the smallest one is the oldest
+	return (int)(a->voice - b->voice) < 0;
+}
+
+/**
+ * Update an audio's gains, attenuating it by its distance to the listener and
+ *panning it (keeping the same power on every position)
+ * @param	*chan	The audio
+ */
+static void GFraMe_audio_player_update_gains(GFraMe_audio_chan *chan) {
+	double dx, dy, dist, pan;
+
+	if (!chan->positional) {
+		chan->level = chan->volume;
+		chan->lgain = GFraMe_mixer_get_gain(chan->volume);
+		chan->rgain = chan->lgain;
+		return;
+	}
+	dx = chan->x - listener.x;
+	dy = chan->y - listener.y;
+	dist = sqrt(dx * dx + dy * dy);
+	if (dist <= listener.min_dist)
+		chan->level = chan->volume;
+	else if (dist >= listener.max_dist)
+		chan->level = 0.0;
+	else
+		chan->level = chan->volume * (listener.max_dist - dist)
+				/ (listener.max_dist - listener.min_dist);
+	if (chan->level < GFraMe_audio_player_cull_volume) {
+		chan->lgain = 0;
+		chan->rgain = 0;
+		return;
+	}
+	pan = dx / listener.pan_dist;
+	if (pan < -1.0)
+		pan = -1.0;
+	else if (pan > 1.0)
+		pan = 1.0;
+	// From 0 (left) to pi/2 (right)
+	pan = (pan + 1.0) * M_PI * 0.25;
+	chan->lgain = GFraMe_mixer_get_gain(chan->level * cos(pan));
+	chan->rgain = GFraMe_mixer_get_gain(chan->level * sin(pan));
+}
+
+/**
+ * Accumulate an audio into the mixing buffer
+ * @param	*chan	The audio
+ * @param	*acc	The mixing buffer (stereo)
+ * @param	frames	How many (stereo) frames should be mixed
+ * @return	1 - The audio finished and should be removed; 0 - Otherwise
+ */
+static int GFraMe_audio_player_mix(GFraMe_audio_chan *chan, Sint32 *acc,
+								   int frames) {
+	GFraMe_audio *aud = chan->audio;
+	int frame_size;
+
+	if (aud->freq != spec.freq)
+		return GFraMe_audio_player_mix_resampled(chan, acc, frames);
+	if (aud->stream || aud->adpcm) {
+		int num;
+
+		num = GFraMe_audio_player_pull(chan, streambuf, frames);
+		if (aud->stereo)
+			GFraMe_mixer_add(acc, streambuf, num * 2, chan->lgain,
+							 chan->rgain);
+		else
+			GFraMe_mixer_add_mono(acc, streambuf, num, chan->lgain,
+								  chan->rgain);
+		return num < frames;
+	}
+	// Raw samples are mixed straight from the audio's buffer
+	frame_size = aud->stereo ? 4 : 2;
+	while (frames > 0) {
+		int num = (aud->len - chan->pos) / frame_size;
+		if (num > frames)
+			num = frames;
+		if (num > 0) {
+			const Sint16 *src = (const Sint16*)(aud->buf + chan->pos);
+			if (aud->stereo)
+				GFraMe_mixer_add(acc, src, num * 2, chan->lgain,
+								 chan->rgain);
 			else
-				// Issue it to be recycled
+				GFraMe_mixer_add_mono(acc, src, num, chan->lgain,
+									  chan->rgain);
+			acc += num * 2;
+			frames -= num;
+			chan->pos += num * frame_size;
+		}
+		// If the sample is over
+		if (aud->len - chan->pos < frame_size) {
+			// Issue it to be removed
+			if (!aud->loop)
+				return 1;
+			// Loop it (from a whole frame)
+			chan->pos = aud->loop_pos - aud->loop_pos % frame_size;
+			if (aud->len - chan->pos < frame_size)
 				return 1;
 		}
 	}
-	// Update the sample position
-	node->pos += i;
 	return 0;
 }
 
-static int GFraMe_audio_player_mix_mono(GFraMe_audio_ll *node, Uint8 *dst, int len) {
-	int i = 0;
-	len /= 2;
-	while (i < len) {
-		// Get the data to be put into both channels
-		Sint16 chan = node->audio->buf[i + node->pos]
-					 | ((node->audio->buf[i + node->pos + 1] << 8) & 0xff00);
-		// Modify its volume
-		chan = (Sint16)(chan*node->volume*0.5);
-		// Add it to the channel
-		dst[2*i] += (Uint8)(chan&0xff);
-		dst[2*i+1] += (Uint8)((chan>>8)&0xff);
-		dst[2*i+2] += dst[2*i];
-		dst[2*i+3] += dst[2*i+1];
-		
-		i += 2;
-		// If the sample is over
-		if (i + node->pos >= node->audio->len) {
-			// Loop it
-			if (node->audio->loop) {
-				len -= i;
-				i = 0;
-				node->pos = node->audio->loop_pos;
-			}
-			else
-				// Issue it to be recycled
+/**
+ * Resample an audio to the device's rate (linearly interpolating between its
+ *frames) and accumulate it into the mixing buffer
+ * @param	*chan	The audio
+ * @param	*acc	The mixing buffer (stereo)
+ * @param	frames	How many (stereo) frames should be mixed
+ * @return	1 - The audio finished and should be removed; 0 - Otherwise
+ */
+static int GFraMe_audio_player_mix_resampled(GFraMe_audio_chan *chan,
+											 Sint32 *acc, int frames) {
+	GFraMe_audio *aud = chan->audio;
+	int chans, over;
+	Uint32 step;
+
+	chans = aud->stereo ? 2 : 1;
+	step = GFraMe_mixer_get_step(aud->freq, spec.freq);
+	over = 0;
+	while (frames > 0 && !over) {
+		Sint16 *dst;
+		int num, need, got;
+
+		num = frames;
+		need = GFraMe_mixer_resample_begin(&chan->resampler, srcbuf, &num,
+										   srcbuf_frames, step, chans);
+		dst = srcbuf + chan->resampler.num_carry * chans;
+		got = GFraMe_audio_player_pull(chan, dst, need);
+		if (got < need) {
+			// Fade into silence after the last frame
+			memset(dst + got * chans, 0x0,
+				   sizeof(Sint16) * (need - got) * chans);
+			over = 1;
+		}
+		GFraMe_mixer_resample(&chan->resampler, streambuf, srcbuf, num, step,
+							  chans);
+		if (aud->stereo)
+			GFraMe_mixer_add(acc, streambuf, num * 2, chan->lgain,
+							 chan->rgain);
+		else
+			GFraMe_mixer_add_mono(acc, streambuf, num, chan->lgain,
+								  chan->rgain);
+		acc += num * 2;
+		frames -= num;
+	}
+	return over;
+}
+
+/**
+ * Advance an audio without mixing it
+ * @param	*chan	The audio
+ * @param	frames	How many (stereo) frames should be skipped
+ * @return	1 - The audio finished and should be removed; 0 - Otherwise
+ */
+static int GFraMe_audio_player_skip(GFraMe_audio_chan *chan, int frames) {
+	GFraMe_audio *aud = chan->audio;
+	int frame_size, total;
+
+	frame_size = aud->stereo ? 4 : 2;
+	total = aud->len / frame_size;
+	// Convert it into source frames, taking the carried ones into account
+	if (aud->freq != spec.freq)
+		frames = GFraMe_mixer_resample_skip(&chan->resampler, frames,
+				GFraMe_mixer_get_step(aud->freq, spec.freq),
+				aud->stereo ? 2 : 1);
+	while (frames > 0) {
+		int num = total - chan->pos / frame_size;
+		if (num > frames)
+			num = frames;
+		if (num < 0)
+			num = 0;
+		// Compressed audios are decoded from this position when audible again
+		chan->pos += num * frame_size;
+		frames -= num;
+		if (chan->pos / frame_size >= total) {
+			if (!aud->loop)
+				return 1;
+			chan->pos = aud->loop_pos - aud->loop_pos % frame_size;
+			if (chan->pos / frame_size >= total)
 				return 1;
 		}
 	}
-	// Update the sample position
-	node->pos += i;
 	return 0;
 }
 
+/**
+ * Copy (or decode or read) an audio's next frames, at its own rate
+ * @param	*chan	The audio
+ * @param	*dst	Where the frames should be written
+ * @param	frames	How many frames should be written
+ * @return	How many frames were written (less than requested if it's over)
+ */
+static int GFraMe_audio_player_pull(GFraMe_audio_chan *chan, Sint16 *dst,
+									int frames) {
+	GFraMe_audio *aud = chan->audio;
+	int frame_size, total, done;
+
+	frame_size = aud->stereo ? 4 : 2;
+	if (aud->stream) {
+		done = GFraMe_audio_stream_read(aud->stream, dst, frames * frame_size)
+				/ frame_size;
+		if (done < frames && !GFraMe_audio_stream_did_end(aud->stream)) {
+			// On an underrun, the rest is left silent
+			memset((char*)dst + done * frame_size, 0x0,
+				   (frames - done) * frame_size);
+			done = frames;
+		}
+		return done;
+	}
+	total = aud->len / frame_size;
+	done = 0;
+	while (done < frames) {
+		int frame, num;
+
+		frame = chan->pos / frame_size;
+		if (aud->adpcm) {
+			// Only a loop moves the decoder; it then resumes from a block's
+			// start
+			if (chan->adpcm.frame != frame)
+				GFraMe_adpcm_seek(&chan->adpcm, aud->buf, frame, aud->stereo);
+			num = GFraMe_adpcm_decode(dst, &chan->adpcm, aud->buf,
+									  frames - done, total, aud->stereo);
+		}
+		else {
+			num = total - frame;
+			if (num > frames - done)
+				num = frames - done;
+			if (num < 0)
+				num = 0;
+			memcpy(dst, aud->buf + frame * frame_size, num * frame_size);
+		}
+		dst += num * frame_size / sizeof(Sint16);
+		done += num;
+		chan->pos += num * frame_size;
+		// If the sample is over
+		if (chan->pos / frame_size >= total) {
+			if (!aud->loop)
+				break;
+			chan->pos = aud->loop_pos - aud->loop_pos % frame_size;
+			if (chan->pos / frame_size >= total)
+				break;
+		}
+	}
+	return done;
+}
+
+/**
+ * Switch the BGM; a streamed audio is rewound (in the background) as soon as
+ *it stops playing, so switching back to it doesn't have to wait for the disk
+ * @param	*aud	The new BGM (or NULL)
+ */
+static void GFraMe_audio_player_set_bgm(GFraMe_audio *aud) {
+	if (bgm.audio && bgm.audio->stream)
+		GFraMe_audio_stream_restart(bgm.audio->stream);
+	if (aud && aud->stream && GFraMe_audio_stream_was_consumed(aud->stream))
+		GFraMe_audio_stream_restart(aud->stream);
+	bgm.audio = aud;
+	GFraMe_audio_player_reset_chan(&bgm);
+}
+
+/**
+ * Rewind a channel to the start of its audio
+ * @param	*chan	The channel
+ */
+static void GFraMe_audio_player_reset_chan(GFraMe_audio_chan *chan) {
+	chan->pos = 0;
+	chan->delay = 0;
+	GFraMe_mixer_init_resampler(&chan->resampler);
+	GFraMe_adpcm_init_state(&chan->adpcm);
+}
+
 void GFraMe_audio_player_pause() {
 	GFraMe_new_log("Pause audio...");
 	GFraMe_new_log("");
 	SDL_PauseAudioDevice(dev, 1);
+	paused = 1;
+	// The callback won't run until it's unpaused (and it only uses this
+	// field itself, so it isn't published)
+	timing.last_start = 0;
 }
 
 void GFraMe_audio_player_play() {
 	GFraMe_new_log("Play audio...");
 	GFraMe_new_log("");
+	paused = 0;
 	SDL_PauseAudioDevice(dev, 0);
 }
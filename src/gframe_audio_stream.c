@@ -0,0 +1,276 @@
+/**
+ * @src/gframe_audio_stream.c
+ */
+#include <GFraMe/GFraMe_assets.h>
+#include <GFraMe/GFraMe_audio_stream.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_ringbuf.h>
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_rwops.h>
+#include <SDL2/SDL_thread.h>
+#include <stdlib.h>
+
+/**
+ * Thread that refills every stream
+ */
+static SDL_Thread *io_thread = NULL;
+/**
+ * Guards the list of streams (only between the game and the I/O threads)
+ */
+static SDL_mutex *lock = NULL;
+/**
+ * Posted by the game thread, so the I/O thread stops sooner
+ */
+static SDL_sem *wake = NULL;
+static SDL_atomic_t running;
+/**
+ * Every stream serviced by the I/O thread
+ */
+static GFraMe_audio_stream *streams = NULL;
+/**
+ * Where the file is read into, before being written into a ring
+ */
+static char chunk[GFraMe_audio_stream_chunk_size];
+
+static GFraMe_ret GFraMe_audio_stream_start_thread();
+static void GFraMe_audio_stream_stop_thread();
+static int GFraMe_audio_stream_thread(void *arg);
+static void GFraMe_audio_stream_fill(GFraMe_audio_stream *st);
+
+GFraMe_ret GFraMe_audio_stream_init(GFraMe_audio_stream *st, char *filename,
+	int loop, int loop_pos, int stereo) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	st->fp = NULL;
+	st->ring.buf = NULL;
+	st->next = NULL;
+	st->len = 0;
+	st->pos = 0;
+	st->loop = loop;
+	st->loop_pos = loop_pos;
+	st->stereo = stereo;
+	st->freq = 44100;
+	st->offset = 0;
+	st->restarting = 0;
+	st->consumed = 0;
+	SDL_AtomicSet(&st->rewind, 0);
+	SDL_AtomicSet(&st->start, 0);
+	SDL_AtomicSet(&st->ended, 0);
+	SDL_AtomicSet(&st->refill, 0);
+
+	rv = GFraMe_assets_open_audio(filename, &st->fp, &st->len, &st->freq,
+		&st->stereo);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to open audio", _ret);
+	st->offset = (int)SDL_RWtell(st->fp);
+	rv = GFraMe_ringbuf_init(&st->ring, GFraMe_audio_stream_ring_size);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to create stream ring",
+		_ret);
+	rv = GFraMe_audio_stream_start_thread();
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to start I/O thread", _ret);
+
+	SDL_LockMutex(lock);
+	// Buffer its start right away, so it may be played without waiting
+	GFraMe_audio_stream_fill(st);
+	st->next = streams;
+	streams = st;
+	SDL_UnlockMutex(lock);
+_ret:
+	if (rv != GFraMe_ret_ok) {
+		if (st->fp)
+			SDL_RWclose(st->fp);
+		st->fp = NULL;
+		GFraMe_ringbuf_clear(&st->ring);
+	}
+	return rv;
+}
+
+void GFraMe_audio_stream_clear(GFraMe_audio_stream *st) {
+	if (lock) {
+		GFraMe_audio_stream **prev;
+		int empty;
+
+		SDL_LockMutex(lock);
+		prev = &streams;
+		while (*prev && *prev != st)
+			prev = &((*prev)->next);
+		if (*prev)
+			*prev = st->next;
+		empty = (streams == NULL);
+		SDL_UnlockMutex(lock);
+		if (empty)
+			GFraMe_audio_stream_stop_thread();
+	}
+	st->next = NULL;
+	if (st->fp)
+		SDL_RWclose(st->fp);
+	st->fp = NULL;
+	GFraMe_ringbuf_clear(&st->ring);
+}
+
+int GFraMe_audio_stream_read(GFraMe_audio_stream *st, void *data, int len) {
+	int frame_size;
+
+	if (st->restarting) {
+		unsigned int start, head;
+
+		if (SDL_AtomicGet(&st->rewind))
+			return 0;
+		// Discard whatever was buffered before the rewind
+		start = (unsigned int)SDL_AtomicGet(&st->start);
+		head = (unsigned int)SDL_AtomicGet(&st->ring.head);
+		GFraMe_ringbuf_skip(&st->ring, (int)(start - head));
+		st->restarting = 0;
+	}
+	frame_size = st->stereo ? 4 : 2;
+	len = GFraMe_ringbuf_read(&st->ring, data, len - len % frame_size);
+	if (len > 0)
+		st->consumed = 1;
+	// Ask for a refill whenever there's room, even if nothing was read (e.g.,
+	// the rewind may have been handled while a fill was still writing the old
+	// samples, so skipping them just emptied the ring). Only flag it; posting
+	// a semaphore may take a lock on some platforms
+	if (GFraMe_ringbuf_get_free(&st->ring) > 0 && !SDL_AtomicGet(&st->ended))
+		SDL_AtomicSet(&st->refill, 1);
+	return len;
+}
+
+void GFraMe_audio_stream_restart(GFraMe_audio_stream *st) {
+	st->restarting = 1;
+	st->consumed = 0;
+	// Make room for the rewound audio right away; anything written after this
+	// is skipped once the I/O thread handles the rewind
+	GFraMe_ringbuf_skip(&st->ring, GFraMe_ringbuf_get_used(&st->ring));
+	SDL_AtomicSet(&st->rewind, 1);
+	SDL_AtomicSet(&st->refill, 1);
+}
+
+int GFraMe_audio_stream_was_consumed(GFraMe_audio_stream *st) {
+	return st->consumed;
+}
+
+int GFraMe_audio_stream_did_end(GFraMe_audio_stream *st) {
+	// 'ended' is only set after the last samples were written
+	return !st->restarting && SDL_AtomicGet(&st->ended)
+		&& GFraMe_ringbuf_get_used(&st->ring) == 0;
+}
+
+/**
+ * Start the I/O thread, if it isn't running yet
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_audio_stream_start_thread() {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	if (io_thread)
+		return GFraMe_ret_ok;
+	lock = SDL_CreateMutex();
+	GFraMe_SDLassertRV(lock, "Failed to create mutex",
+		rv = GFraMe_ret_failed, _ret);
+	wake = SDL_CreateSemaphore(0);
+	GFraMe_SDLassertRV(wake, "Failed to create semaphore",
+		rv = GFraMe_ret_failed, _ret);
+	SDL_AtomicSet(&running, 1);
+	io_thread = SDL_CreateThread(GFraMe_audio_stream_thread,
+		"GFraMe_audio_stream", NULL);
+	GFraMe_SDLassertRV(io_thread, "Failed to create thread",
+		rv = GFraMe_ret_failed, _ret);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_audio_stream_stop_thread();
+	return rv;
+}
+
+/**
+ * Stop the I/O thread and release its resources
+ */
+static void GFraMe_audio_stream_stop_thread() {
+	if (io_thread) {
+		SDL_AtomicSet(&running, 0);
+		SDL_SemPost(wake);
+		SDL_WaitThread(io_thread, NULL);
+		io_thread = NULL;
+	}
+	if (wake)
+		SDL_DestroySemaphore(wake);
+	wake = NULL;
+	if (lock)
+		SDL_DestroyMutex(lock);
+	lock = NULL;
+}
+
+/**
+ * Keep every stream's ring filled, until there are no more streams
+ * @param	*arg	Unused
+ * @return	Always 0
+ */
+static int GFraMe_audio_stream_thread(void *arg) {
+	while (SDL_AtomicGet(&running)) {
+		GFraMe_audio_stream *st;
+
+		SDL_SemWaitTimeout(wake, GFraMe_audio_stream_poll_ms);
+		SDL_LockMutex(lock);
+		st = streams;
+		while (st) {
+			// Only streams the consumer read from (or rewound) need it
+			if (SDL_AtomicCAS(&st->refill, 1, 0))
+				GFraMe_audio_stream_fill(st);
+			st = st->next;
+		}
+		SDL_UnlockMutex(lock);
+	}
+	return 0;
+}
+
+/**
+ * Read the file into the stream's ring, until it's full, handling rewinds
+ *and loops; must be called with the lock held
+ * @param	*st	The stream
+ */
+static void GFraMe_audio_stream_fill(GFraMe_audio_stream *st) {
+	int frame_size, end, loop_pos;
+
+	frame_size = st->stereo ? 4 : 2;
+	// Only ever write whole frames
+	end = st->len - st->len % frame_size;
+	loop_pos = st->loop_pos - st->loop_pos % frame_size;
+	if (SDL_AtomicGet(&st->rewind)) {
+		st->pos = 0;
+		SDL_AtomicSet(&st->ended, 0);
+		// The consumer skips anything written before this point
+		SDL_AtomicSet(&st->start, SDL_AtomicGet(&st->ring.tail));
+		SDL_AtomicSet(&st->rewind, 0);
+	}
+	while (!SDL_AtomicGet(&st->ended)) {
+		int num;
+
+		if (st->pos >= end) {
+			if (st->loop && loop_pos >= 0 && loop_pos < end) {
+				st->pos = loop_pos;
+				continue;
+			}
+			SDL_AtomicSet(&st->ended, 1);
+			break;
+		}
+		num = GFraMe_ringbuf_get_free(&st->ring);
+		if (num > GFraMe_audio_stream_chunk_size)
+			num = GFraMe_audio_stream_chunk_size;
+		if (num > end - st->pos)
+			num = end - st->pos;
+		num -= num % frame_size;
+		if (num <= 0)
+			break;
+		SDL_RWseek(st->fp, st->offset + st->pos, RW_SEEK_SET);
+		num = (int)SDL_RWread(st->fp, chunk, 1, num);
+		num -= num % frame_size;
+		if (num <= 0) {
+			GFraMe_log("Failed to read streamed audio");
+			SDL_AtomicSet(&st->ended, 1);
+			break;
+		}
+		GFraMe_ringbuf_write(&st->ring, chunk, num);
+		st->pos += num;
+	}
+}
+
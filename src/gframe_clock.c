@@ -0,0 +1,109 @@
+/**
+ * @src/gframe_clock.c
+ */
+#include <GFraMe/GFraMe_clock.h>
+#include <SDL2/SDL.h>
+
+/**
+ * Calculate how many ticks are left until an accumulator issues a frame
+ * @param	*clk	The clock
+ * @param	acc	The accumulator (in ticks times fps)
+ * @param	fps	The accumulator's frames per second
+ * @return	How many ticks are left
+ */
+static Uint64 GFraMe_clock_ticks_left(GFraMe_clock *clk, Uint64 acc, int fps);
+
+void GFraMe_clock_init(GFraMe_clock *clk, int update_fps, int draw_fps,
+					   int max_frames) {
+	clk->freq = SDL_GetPerformanceFrequency();
+	clk->last = SDL_GetPerformanceCounter();
+	clk->update_fps = update_fps;
+	clk->draw_fps = draw_fps;
+	clk->update_acc = 0;
+	clk->draw_acc = 0;
+	// Same as GFraMe_accumulator: cap it 10% before the next frame
+	clk->update_cap = clk->freq * max_frames + clk->freq * 9 / 10;
+	clk->steps = 0;
+	clk->elapsed = 0;
+	GFraMe_clock_set_spin(clk, GFraMe_clock_default_spin_us);
+}
+
+void GFraMe_clock_set_spin(GFraMe_clock *clk, int us) {
+	clk->spin = clk->freq * us / 1000000;
+}
+
+void GFraMe_clock_tick(GFraMe_clock *clk) {
+	Uint64 now, dt;
+
+	now = SDL_GetPerformanceCounter();
+	dt = now - clk->last;
+	clk->last = now;
+	clk->update_acc += dt * clk->update_fps;
+	if (clk->update_acc > clk->update_cap)
+		clk->update_acc = clk->update_cap;
+	// At most one draw may be late
+	clk->draw_acc += dt * clk->draw_fps;
+	if (clk->draw_acc > clk->freq * 2)
+		clk->draw_acc = clk->freq * 2;
+}
+
+void GFraMe_clock_wait(GFraMe_clock *clk) {
+	Uint64 deadline, left, now;
+
+	left = GFraMe_clock_ticks_left(clk, clk->update_acc, clk->update_fps);
+	now = GFraMe_clock_ticks_left(clk, clk->draw_acc, clk->draw_fps);
+	if (now < left)
+		left = now;
+	deadline = clk->last + left;
+	now = SDL_GetPerformanceCounter();
+	while (now < deadline) {
+		left = deadline - now;
+		// SDL_Delay may oversleep, so only sleep while far from it
+		if (left > clk->spin)
+			SDL_Delay((Uint32)((left - clk->spin) * 1000 / clk->freq));
+		now = SDL_GetPerformanceCounter();
+	}
+}
+
+int GFraMe_clock_update(GFraMe_clock *clk) {
+	if (clk->update_acc < clk->freq)
+		return 0;
+	clk->update_acc -= clk->freq;
+	// Spread the fractional milliseconds over a second's worth of steps
+	clk->elapsed = (clk->steps + 1) * 1000 / clk->update_fps
+				   - clk->steps * 1000 / clk->update_fps;
+	clk->steps++;
+	if (clk->steps >= clk->update_fps)
+		clk->steps = 0;
+	return 1;
+}
+
+int GFraMe_clock_draw(GFraMe_clock *clk) {
+	if (clk->draw_acc < clk->freq)
+		return 0;
+	clk->draw_acc -= clk->freq;
+	if (clk->draw_acc >= clk->freq)
+		clk->draw_acc = clk->freq - 1;
+	return 1;
+}
+
+float GFraMe_clock_alpha(GFraMe_clock *clk) {
+	if (clk->update_acc >= clk->freq)
+		return 1.0f;
+	return (float)((double)clk->update_acc / (double)clk->freq);
+}
+
+/**
+ * Calculate how many ticks are left until an accumulator issues a frame
+ * @param	*clk	The clock
+ * @param	acc	The accumulator (in ticks times fps)
+ * @param	fps	The accumulator's frames per second
+ * @return	How many ticks are left
+ */
+static Uint64 GFraMe_clock_ticks_left(GFraMe_clock *clk, Uint64 acc, int fps) {
+	if (acc >= clk->freq)
+		return 0;
+	// Round it up, so it's never woken up too early
+	return (clk->freq - acc + fps - 1) / fps;
+}
+
@@ -0,0 +1,232 @@
+/**
+ * @src/gframe_drawlist.c
+ */
+#include <GFraMe/GFraMe_drawlist.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_sprite.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <stdlib.h>
+
+/**
+ * Push a sprite's render record, offset by a camera
+ * @param	*list	The list
+ * @param	*spr	The sprite
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_drawlist_push(GFraMe_drawlist *list,
+									   GFraMe_sprite *spr, int cam_x,
+									   int cam_y);
+
+/**
+ * Get the index of a spriteset on the list, adding it if needed
+ * @param	*list	The list
+ * @param	*sset	The spriteset
+ * @return	The index or -1, if there are too many spritesets
+ */
+static int GFraMe_drawlist_get_sset(GFraMe_drawlist *list,
+									GFraMe_spriteset *sset);
+
+GFraMe_ret GFraMe_drawlist_init(GFraMe_drawlist *list, int max) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	if (max < 16)
+		max = 16;
+	list->len = 0;
+	list->num_ssets = 0;
+	list->last_sset = -1;
+	list->records = (GFraMe_drawlist_record*)malloc(
+									sizeof(GFraMe_drawlist_record) * max);
+	GFraMe_assertRV(list->records, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	list->max = max;
+_ret:
+	if (rv != GFraMe_ret_ok)
+		list->max = 0;
+	return rv;
+}
+
+void GFraMe_drawlist_clear(GFraMe_drawlist *list) {
+	if (list->records)
+		free(list->records);
+	list->records = NULL;
+	list->len = 0;
+	list->max = 0;
+	list->num_ssets = 0;
+	list->last_sset = -1;
+}
+
+void GFraMe_drawlist_reset(GFraMe_drawlist *list) {
+	list->len = 0;
+}
+
+GFraMe_ret GFraMe_drawlist_push_sprite(GFraMe_drawlist *list,
+									   GFraMe_sprite *spr) {
+	if (!spr->is_visible)
+		return GFraMe_ret_ok;
+	return GFraMe_drawlist_push(list, spr, 0, 0);
+}
+
+GFraMe_ret GFraMe_drawlist_push_sprite_camera(GFraMe_drawlist *list,
+											  GFraMe_sprite *spr, int cam_x,
+											  int cam_y, int cam_w,
+											  int cam_h) {
+	if (!spr->is_visible)
+		return GFraMe_ret_ok;
+	// Same check as GFraMe_sprite_draw_camera
+	if (spr->obj.x + spr->sset->w < cam_x || spr->obj.x > cam_x + cam_w ||
+		spr->obj.y + spr->sset->h < cam_y || spr->obj.y > cam_y + cam_h)
+		return GFraMe_ret_ok;
+	return GFraMe_drawlist_push(list, spr, cam_x, cam_y);
+}
+
+GFraMe_ret GFraMe_drawlist_push_sprite_lerp(GFraMe_drawlist *list,
+											GFraMe_sprite *spr, float alpha,
+											int cam_x, int cam_y, int cam_w,
+											int cam_h) {
+	GFraMe_ret rv;
+	int x, y;
+
+	// Push it from its interpolated position, then revert it
+	x = spr->obj.x;
+	y = spr->obj.y;
+	GFraMe_object_get_lerp_pos(&spr->obj, alpha, &spr->obj.x, &spr->obj.y);
+	rv = GFraMe_drawlist_push_sprite_camera(list, spr, cam_x, cam_y, cam_w,
+											cam_h);
+	spr->obj.x = x;
+	spr->obj.y = y;
+	return rv;
+}
+
+void GFraMe_drawlist_draw(GFraMe_drawlist *list) {
+	GFraMe_drawlist_record *rec;
+	int i;
+
+	rec = list->records;
+	i = 0;
+	while (i < list->len) {
+		GFraMe_spriteset *sset = list->ssets[rec->sset];
+#if defined(GFRAME_OPENGL)
+		GFraMe_ssetRenderCtx ctx;
+
+		ctx.x = rec->x;
+		ctx.y = rec->y;
+		if (rec->flags & GFraMe_drawlist_transform) {
+			ctx.sX = (float)rec->scale_x / GFraMe_drawlist_scale_one;
+			ctx.sY = (float)rec->scale_y / GFraMe_drawlist_scale_one;
+			ctx.angle = (float)rec->angle / GFraMe_drawlist_angle_one;
+			ctx.alpha = (float)rec->alpha / 255.0f;
+		}
+		else {
+			ctx.sX = 1.0f;
+			ctx.sY = 1.0f;
+			ctx.angle = 0.0f;
+			ctx.alpha = 1.0f;
+		}
+		if (rec->flags & GFraMe_drawlist_flipped)
+			ctx.sX *= -1;
+		GFraMe_spriteset_draw_ex(sset, rec->tile, &ctx);
+#else
+		GFraMe_spriteset_draw(sset, rec->tile, rec->x, rec->y,
+							  rec->flags & GFraMe_drawlist_flipped);
+#endif
+		rec++;
+		i++;
+	}
+}
+
+/**
+ * Push a sprite's render record, offset by a camera
+ * @param	*list	The list
+ * @param	*spr	The sprite
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_drawlist_push(GFraMe_drawlist *list,
+									   GFraMe_sprite *spr, int cam_x,
+									   int cam_y) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	GFraMe_drawlist_record *rec;
+	int sset, x;
+
+	sset = GFraMe_drawlist_get_sset(list, spr->sset);
+	GFraMe_assertRV(sset != -1, "Too many spritesets on draw list",
+					rv = GFraMe_ret_failed, _ret);
+	if (list->len >= list->max) {
+		GFraMe_drawlist_record *tmp;
+		int max;
+
+		max = list->max * 2;
+		if (max < 16)
+			max = 16;
+		tmp = (GFraMe_drawlist_record*)realloc(list->records,
+									sizeof(GFraMe_drawlist_record) * max);
+		GFraMe_assertRV(tmp, "Failed to alloc memory",
+						rv = GFraMe_ret_memory_error, _ret);
+		list->records = tmp;
+		list->max = max;
+	}
+	rec = list->records + list->len;
+	list->len++;
+	// Position it just like GFraMe_sprite_draw does
+	x = spr->obj.x - cam_x;
+	if (!spr->flipped)
+		x += spr->offset_x;
+	else
+		x += -(spr->sset->tw - ((int)spr->obj.hitbox.hw * 2))
+			 - spr->offset_x;
+	rec->x = (short)x;
+	rec->y = (short)(spr->obj.y - cam_y + spr->offset_y);
+	rec->tile = (unsigned short)spr->cur_tile;
+	rec->sset = (unsigned char)sset;
+	rec->flags = 0;
+	if (spr->flipped)
+		rec->flags |= GFraMe_drawlist_flipped;
+	if (spr->scale_x != 1.0f || spr->scale_y != 1.0f || spr->angle != 0.0f
+		|| spr->alpha != 1.0f)
+		rec->flags |= GFraMe_drawlist_transform;
+	rec->scale_x = (short)(spr->scale_x * GFraMe_drawlist_scale_one);
+	rec->scale_y = (short)(spr->scale_y * GFraMe_drawlist_scale_one);
+	rec->angle = (short)(spr->angle * GFraMe_drawlist_angle_one);
+	if (spr->alpha <= 0.0f)
+		rec->alpha = 0;
+	else if (spr->alpha >= 1.0f)
+		rec->alpha = 255;
+	else
+		rec->alpha = (unsigned char)(spr->alpha * 255.0f + 0.5f);
+	rec->pad = 0;
+_ret:
+	return rv;
+}
+
+/**
+ * Get the index of a spriteset on the list, adding it if needed
+ * @param	*list	The list
+ * @param	*sset	The spriteset
+ * @return	The index or -1, if there are too many spritesets
+ */
+static int GFraMe_drawlist_get_sset(GFraMe_drawlist *list,
+									GFraMe_spriteset *sset) {
+	int i;
+
+	// Sprites usually come in runs of the same spriteset
+	if (list->last_sset != -1 && list->ssets[list->last_sset] == sset)
+		return list->last_sset;
+	i = 0;
+	while (i < list->num_ssets) {
+		if (list->ssets[i] == sset)
+			break;
+		i++;
+	}
+	if (i == list->num_ssets) {
+		if (list->num_ssets >= GFraMe_drawlist_max_ssets)
+			return -1;
+		list->ssets[i] = sset;
+		list->num_ssets++;
+	}
+	list->last_sset = i;
+	return i;
+}
+
@@ -0,0 +1,451 @@
+/**
+ * @src/gframe_ecs.c
+ */
+#include <GFraMe/GFraMe_animation.h>
+#include <GFraMe/GFraMe_ecs.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_hitbox.h>
+#include <GFraMe/GFraMe_pool.h>
+#include <GFraMe/GFraMe_sprite.h>
+#include <GFraMe/GFraMe_spriteset.h>
+#include <GFraMe/GFraMe_tween.h>
+#include <GFraMe/GFraMe_util.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Get an entity's slot from its handle
+ */
+#define GFraMe_ecs_slot(ent)	((int)((ent) & (GFraMe_pool_max_items - 1)))
+
+/**
+ * Get a component from a set
+ */
+#define GFraMe_ecs_at(set, i)	((set)->data + (size_t)(i) * (set)->size)
+
+/**
+ * Size of each component type
+ */
+static const int GFraMe_ecs_sizes[GFraMe_ecs_num_components] = {
+	sizeof(GFraMe_ecs_transform),
+	sizeof(GFraMe_ecs_physics),
+	sizeof(GFraMe_hitbox),
+	sizeof(GFraMe_animation),
+	sizeof(GFraMe_ecs_render),
+	sizeof(GFraMe_tween)
+};
+
+/**
+ * Get a slot's component from a set
+ * @param	*set	The set
+ * @param	slot	The entity's slot
+ * @return	The component or NULL
+ */
+static void *GFraMe_ecs_set_get(GFraMe_ecs_set *set, int slot);
+
+/**
+ * Remove the component at a position of a set, moving the last one into it
+ * @param	*set	The set
+ * @param	i	Component's position
+ */
+static void GFraMe_ecs_set_remove_at(GFraMe_ecs_set *set, int i);
+
+GFraMe_ret GFraMe_ecs_init(GFraMe_ecs *ecs, int max_entities) {
+	GFraMe_ret rv;
+	int i;
+
+	memset(ecs->sets, 0x0, sizeof(ecs->sets));
+	rv = GFraMe_pool_init(&ecs->entities, sizeof(int), max_entities);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init entities", _ret);
+	i = 0;
+	while (i < GFraMe_ecs_num_components) {
+		GFraMe_ecs_set *set = ecs->sets + i;
+
+		set->size = GFraMe_ecs_sizes[i];
+		set->data = (char*)malloc((size_t)set->size * max_entities);
+		GFraMe_assertRV(set->data, "Failed to alloc memory",
+						rv = GFraMe_ret_memory_error, _ret);
+		set->dense = (int*)malloc(sizeof(int) * max_entities);
+		GFraMe_assertRV(set->dense, "Failed to alloc memory",
+						rv = GFraMe_ret_memory_error, _ret);
+		set->sparse = (int*)malloc(sizeof(int) * max_entities);
+		GFraMe_assertRV(set->sparse, "Failed to alloc memory",
+						rv = GFraMe_ret_memory_error, _ret);
+		memset(set->sparse, 0xff, sizeof(int) * max_entities);
+		set->len = 0;
+		i++;
+	}
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_ecs_clear(ecs);
+	return rv;
+}
+
+void GFraMe_ecs_clear(GFraMe_ecs *ecs) {
+	int i;
+
+	GFraMe_pool_clear(&ecs->entities);
+	i = 0;
+	while (i < GFraMe_ecs_num_components) {
+		GFraMe_ecs_set *set = ecs->sets + i;
+
+		if (set->data)
+			free(set->data);
+		set->data = NULL;
+		if (set->dense)
+			free(set->dense);
+		set->dense = NULL;
+		if (set->sparse)
+			free(set->sparse);
+		set->sparse = NULL;
+		set->len = 0;
+		i++;
+	}
+}
+
+GFraMe_ret GFraMe_ecs_create(GFraMe_ecs *ecs, GFraMe_ecs_entity *ent) {
+	void *item;
+
+	return GFraMe_pool_acquire(&ecs->entities, ent, &item);
+}
+
+void GFraMe_ecs_destroy(GFraMe_ecs *ecs, GFraMe_ecs_entity ent) {
+	int i, slot;
+
+	if (!GFraMe_pool_get(&ecs->entities, ent))
+		return;
+	slot = GFraMe_ecs_slot(ent);
+	i = 0;
+	while (i < GFraMe_ecs_num_components) {
+		if (ecs->sets[i].sparse[slot] != -1)
+			GFraMe_ecs_set_remove_at(ecs->sets + i, ecs->sets[i].sparse[slot]);
+		i++;
+	}
+	GFraMe_pool_release(&ecs->entities, ent);
+}
+
+void *GFraMe_ecs_add(GFraMe_ecs *ecs, GFraMe_ecs_entity ent,
+					 GFraMe_ecs_component comp) {
+	GFraMe_ecs_set *set;
+	void *data;
+	int slot;
+
+	if (!GFraMe_pool_get(&ecs->entities, ent))
+		return NULL;
+	set = ecs->sets + comp;
+	slot = GFraMe_ecs_slot(ent);
+	data = GFraMe_ecs_set_get(set, slot);
+	if (data)
+		return data;
+	// Append it to the set (it can't be full, since there's a slot for
+	// every entity)
+	set->dense[set->len] = slot;
+	set->sparse[slot] = set->len;
+	data = GFraMe_ecs_at(set, set->len);
+	set->len++;
+	memset(data, 0x0, set->size);
+	return data;
+}
+
+void GFraMe_ecs_remove(GFraMe_ecs *ecs, GFraMe_ecs_entity ent,
+					   GFraMe_ecs_component comp) {
+	GFraMe_ecs_set *set;
+	int slot;
+
+	if (!GFraMe_pool_get(&ecs->entities, ent))
+		return;
+	set = ecs->sets + comp;
+	slot = GFraMe_ecs_slot(ent);
+	if (set->sparse[slot] != -1)
+		GFraMe_ecs_set_remove_at(set, set->sparse[slot]);
+}
+
+void *GFraMe_ecs_get(GFraMe_ecs *ecs, GFraMe_ecs_entity ent,
+					 GFraMe_ecs_component comp) {
+	if (!GFraMe_pool_get(&ecs->entities, ent))
+		return NULL;
+	return GFraMe_ecs_set_get(ecs->sets + comp, GFraMe_ecs_slot(ent));
+}
+
+void GFraMe_ecs_update(GFraMe_ecs *ecs, int ms) {
+	GFraMe_ecs_set *phys, *trans, *tweens;
+	double time;
+	int i;
+
+	time = ((double)ms) / 1000.0;
+	trans = ecs->sets + GFraMe_ecs_transform_comp;
+	phys = ecs->sets + GFraMe_ecs_physics_comp;
+	tweens = ecs->sets + GFraMe_ecs_tween_comp;
+	// Store the last position of every entity
+	i = 0;
+	while (i < trans->len) {
+		GFraMe_ecs_transform *t;
+
+		t = (GFraMe_ecs_transform*)GFraMe_ecs_at(trans, i);
+		t->last_x = t->x;
+		t->last_y = t->y;
+		i++;
+	}
+	// Move every entity that's being tweened
+	i = 0;
+	while (i < tweens->len) {
+		GFraMe_ecs_transform *t;
+		GFraMe_tween *tw;
+
+		tw = (GFraMe_tween*)GFraMe_ecs_at(tweens, i);
+		t = (GFraMe_ecs_transform*)GFraMe_ecs_set_get(trans, tweens->dense[i]);
+		if (GFraMe_tween_update(tw, time) == GFraMe_tween_ret_ok && t &&
+			tw->type == GFraMe_tween_lerp) {
+			double p = tw->time / tw->maxTime;
+			// Positions are truncated, just like GFraMe_tween_set_obj does
+			t->x = (int)GFraMe_util_lerp(tw->fromX, tw->toX, p);
+			t->y = (int)GFraMe_util_lerp(tw->fromY, tw->toY, p);
+			t->last_x = t->x;
+			t->last_y = t->y;
+		}
+		i++;
+	}
+	// Integrate every other one
+	i = 0;
+	while (i < phys->len) {
+		GFraMe_ecs_transform *t;
+		GFraMe_ecs_physics *p;
+		GFraMe_tween *tw;
+		int slot;
+
+		p = (GFraMe_ecs_physics*)GFraMe_ecs_at(phys, i);
+		slot = phys->dense[i];
+		i++;
+		tw = (GFraMe_tween*)GFraMe_ecs_set_get(tweens, slot);
+		if (tw && tw->time < tw->maxTime)
+			continue;
+		t = (GFraMe_ecs_transform*)GFraMe_ecs_set_get(trans, slot);
+		if (!t)
+			continue;
+		if (p->ax != 0.0)
+			p->vx += GFraMe_util_integrate(p->ax, time);
+		if (p->vx != 0.0)
+			t->x += GFraMe_util_integrate(p->vx, time);
+		if (p->ay != 0.0)
+			p->vy += GFraMe_util_integrate(p->ay, time);
+		if (p->vy != 0.0)
+			t->y += GFraMe_util_integrate(p->vy, time);
+	}
+}
+
+void GFraMe_ecs_animate(GFraMe_ecs *ecs, int ms) {
+	GFraMe_ecs_set *anims, *renders;
+	int i;
+
+	anims = ecs->sets + GFraMe_ecs_animation_comp;
+	renders = ecs->sets + GFraMe_ecs_render_comp;
+	i = 0;
+	while (i < anims->len) {
+		GFraMe_animation *anim;
+		GFraMe_ecs_render *r;
+		GFraMe_ret ret;
+
+		anim = (GFraMe_animation*)GFraMe_ecs_at(anims, i);
+		ret = GFraMe_animation_update(anim, ms);
+		if (ret == GFraMe_ret_anim_new_frame) {
+			r = (GFraMe_ecs_render*)GFraMe_ecs_set_get(renders,
+													   anims->dense[i]);
+			if (r)
+				r->tile = anim->tile;
+		}
+		else if (ret == GFraMe_ret_anim_finished) {
+			// Just like sprites, drop finished animations (the last one is
+			// moved here, so check this position again)
+			GFraMe_ecs_set_remove_at(anims, i);
+			continue;
+		}
+		i++;
+	}
+}
+
+void GFraMe_ecs_draw(GFraMe_ecs *ecs) {
+	GFraMe_ecs_set *hitboxes, *renders, *trans;
+	int i;
+
+	trans = ecs->sets + GFraMe_ecs_transform_comp;
+	hitboxes = ecs->sets + GFraMe_ecs_hitbox_comp;
+	renders = ecs->sets + GFraMe_ecs_render_comp;
+	i = 0;
+	while (i < renders->len) {
+		GFraMe_ecs_transform *t;
+		GFraMe_ecs_render *r;
+		int x, y;
+
+		r = (GFraMe_ecs_render*)GFraMe_ecs_at(renders, i);
+		i++;
+		if (!r->is_visible || !r->sset)
+			continue;
+		t = (GFraMe_ecs_transform*)GFraMe_ecs_set_get(trans,
+													  renders->dense[i - 1]);
+		if (!t)
+			continue;
+		x = (int)t->x;
+		y = (int)t->y + r->offset_y;
+		if (!r->flipped)
+			x += r->offset_x;
+		else {
+			GFraMe_hitbox *hb;
+			int w = 0;
+
+			// Mirror it around the hitbox, just like GFraMe_sprite_draw
+			hb = (GFraMe_hitbox*)GFraMe_ecs_set_get(hitboxes,
+													renders->dense[i - 1]);
+			if (hb)
+				w = (int)hb->hw * 2;
+			x -= r->sset->tw - w + r->offset_x;
+		}
+#if defined(GFRAME_OPENGL)
+		do {
+			GFraMe_ssetRenderCtx ctx;
+
+			ctx.x = x;
+			ctx.y = y;
+			ctx.sX = r->flipped? -r->scale_x : r->scale_x;
+			ctx.sY = r->scale_y;
+			ctx.alpha = r->alpha;
+			ctx.angle = r->angle;
+			GFraMe_spriteset_draw_ex(r->sset, r->tile, &ctx);
+		} while (0);
+#else
+		GFraMe_spriteset_draw(r->sset, r->tile, x, y, r->flipped);
+#endif
+	}
+}
+
+GFraMe_ret GFraMe_ecs_add_sprite(GFraMe_ecs *ecs, GFraMe_ecs_entity *ent,
+								 GFraMe_sprite *spr) {
+	GFraMe_ecs_transform *t;
+	GFraMe_ecs_physics *p;
+	GFraMe_ecs_render *r;
+	GFraMe_ret rv;
+
+	rv = GFraMe_ecs_create(ecs, ent);
+	if (rv != GFraMe_ret_ok)
+		return rv;
+	t = (GFraMe_ecs_transform*)GFraMe_ecs_add(ecs, *ent,
+											  GFraMe_ecs_transform_comp);
+	t->x = spr->obj.dx;
+	t->y = spr->obj.dy;
+	t->last_x = spr->obj.ldx;
+	t->last_y = spr->obj.ldy;
+	p = (GFraMe_ecs_physics*)GFraMe_ecs_add(ecs, *ent,
+											GFraMe_ecs_physics_comp);
+	p->vx = spr->obj.vx;
+	p->vy = spr->obj.vy;
+	p->ax = spr->obj.ax;
+	p->ay = spr->obj.ay;
+	*((GFraMe_hitbox*)GFraMe_ecs_add(ecs, *ent, GFraMe_ecs_hitbox_comp))
+		= spr->obj.hitbox;
+	*((GFraMe_tween*)GFraMe_ecs_add(ecs, *ent, GFraMe_ecs_tween_comp))
+		= spr->obj.tween;
+	if (spr->anim)
+		*((GFraMe_animation*)GFraMe_ecs_add(ecs, *ent,
+											GFraMe_ecs_animation_comp))
+			= *spr->anim;
+	r = (GFraMe_ecs_render*)GFraMe_ecs_add(ecs, *ent, GFraMe_ecs_render_comp);
+	r->sset = spr->sset;
+	r->tile = spr->cur_tile;
+	r->offset_x = spr->offset_x;
+	r->offset_y = spr->offset_y;
+	r->scale_x = spr->scale_x;
+	r->scale_y = spr->scale_y;
+	r->angle = spr->angle;
+	r->alpha = spr->alpha;
+	r->flipped = spr->flipped;
+	r->is_visible = spr->is_visible;
+	return GFraMe_ret_ok;
+}
+
+GFraMe_ret GFraMe_ecs_get_sprite(GFraMe_ecs *ecs, GFraMe_ecs_entity ent,
+								 GFraMe_sprite *spr) {
+	GFraMe_ecs_transform *t;
+	GFraMe_ecs_physics *p;
+	GFraMe_ecs_render *r;
+	GFraMe_animation *anim;
+	GFraMe_hitbox *hb;
+	GFraMe_tween *tw;
+
+	if (!GFraMe_pool_get(&ecs->entities, ent))
+		return GFraMe_ret_bad_param;
+	t = (GFraMe_ecs_transform*)GFraMe_ecs_get(ecs, ent,
+											  GFraMe_ecs_transform_comp);
+	if (t) {
+		spr->obj.dx = t->x;
+		spr->obj.dy = t->y;
+		spr->obj.ldx = t->last_x;
+		spr->obj.ldy = t->last_y;
+		spr->obj.x = (int)t->x;
+		spr->obj.y = (int)t->y;
+	}
+	p = (GFraMe_ecs_physics*)GFraMe_ecs_get(ecs, ent, GFraMe_ecs_physics_comp);
+	if (p) {
+		spr->obj.vx = p->vx;
+		spr->obj.vy = p->vy;
+		spr->obj.ax = p->ax;
+		spr->obj.ay = p->ay;
+	}
+	hb = (GFraMe_hitbox*)GFraMe_ecs_get(ecs, ent, GFraMe_ecs_hitbox_comp);
+	if (hb)
+		spr->obj.hitbox = *hb;
+	tw = (GFraMe_tween*)GFraMe_ecs_get(ecs, ent, GFraMe_ecs_tween_comp);
+	if (tw)
+		spr->obj.tween = *tw;
+	if (spr->anim) {
+		anim = (GFraMe_animation*)GFraMe_ecs_get(ecs, ent,
+												 GFraMe_ecs_animation_comp);
+		if (anim)
+			*spr->anim = *anim;
+		else
+			spr->anim = NULL;
+	}
+	r = (GFraMe_ecs_render*)GFraMe_ecs_get(ecs, ent, GFraMe_ecs_render_comp);
+	if (r) {
+		spr->sset = r->sset;
+		spr->cur_tile = r->tile;
+		spr->offset_x = r->offset_x;
+		spr->offset_y = r->offset_y;
+		spr->scale_x = r->scale_x;
+		spr->scale_y = r->scale_y;
+		spr->angle = r->angle;
+		spr->alpha = r->alpha;
+		spr->flipped = r->flipped;
+		spr->is_visible = r->is_visible;
+	}
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Get a slot's component from a set
+ * @param	*set	The set
+ * @param	slot	The entity's slot
+ * @return	The component or NULL
+ */
+static void *GFraMe_ecs_set_get(GFraMe_ecs_set *set, int slot) {
+	if (set->sparse[slot] == -1)
+		return NULL;
+	return GFraMe_ecs_at(set, set->sparse[slot]);
+}
+
+/**
+ * Remove the component at a position of a set, moving the last one into it
+ * @param	*set	The set
+ * @param	i	Component's position
+ */
+static void GFraMe_ecs_set_remove_at(GFraMe_ecs_set *set, int i) {
+	int last;
+
+	set->sparse[set->dense[i]] = -1;
+	set->len--;
+	if (i == set->len)
+		return;
+	last = set->dense[set->len];
+	memcpy(GFraMe_ecs_at(set, i), GFraMe_ecs_at(set, set->len), set->size);
+	set->dense[i] = last;
+	set->sparse[last] = i;
+}
+
@@ -0,0 +1,313 @@
+/**
+ * @src/gframe_mixer.c
+ */
+#include <GFraMe/GFraMe_mixer.h>
+#include <SDL2/SDL_stdinc.h>
+#include <math.h>
+#include <string.h>
+
+#if !defined(GFRAME_NO_SIMD) && defined(__SSE2__)
+#  define GFRAME_MIXER_SSE2
+#  include <emmintrin.h>
+#elif !defined(GFRAME_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#  define GFRAME_MIXER_NEON
+#  include <arm_neon.h>
+#endif
+
+static int GFraMe_mixer_resample_need(Uint32 frac, int frames, Uint32 step);
+
+Sint16 GFraMe_mixer_get_gain(double volume) {
+	if (volume <= 0.0)
+		return 0;
+	else if (volume >= 1.0)
+		return GFraMe_mixer_unity;
+	return (Sint16)(volume * GFraMe_mixer_unity + 0.5);
+}
+
+void GFraMe_mixer_add(Sint32 *acc, const Sint16 *src, int num, Sint16 lgain,
+					  Sint16 rgain) {
+	int i;
+
+	i = 0;
+#if defined(GFRAME_MIXER_SSE2)
+	{
+		// Samples alternate between channels, and so do the gains
+		__m128i g = _mm_set_epi16(rgain, lgain, rgain, lgain, rgain, lgain,
+								  rgain, lgain);
+		while (i + 8 <= num) {
+			__m128i s, lo, hi;
+
+			s = _mm_loadu_si128((const __m128i*)(src + i));
+			// Full 32 bits products, from its low and high halves
+			lo = _mm_mullo_epi16(s, g);
+			hi = _mm_mulhi_epi16(s, g);
+			_mm_storeu_si128((__m128i*)(acc + i), _mm_add_epi32(
+					_mm_loadu_si128((__m128i*)(acc + i)),
+					_mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15)));
+			_mm_storeu_si128((__m128i*)(acc + i + 4), _mm_add_epi32(
+					_mm_loadu_si128((__m128i*)(acc + i + 4)),
+					_mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15)));
+			i += 8;
+		}
+	}
+#elif defined(GFRAME_MIXER_NEON)
+	{
+		int16x4_t g = vzip_s16(vdup_n_s16(lgain), vdup_n_s16(rgain)).val[0];
+		while (i + 4 <= num) {
+			int32x4_t p = vshrq_n_s32(vmull_s16(vld1_s16(src + i), g), 15);
+			vst1q_s32(acc + i, vaddq_s32(vld1q_s32(acc + i), p));
+			i += 4;
+		}
+	}
+#endif
+	while (i < num) {
+		acc[i] += ((Sint32)src[i] * ((i & 1) ? rgain : lgain)) >> 15;
+		i++;
+	}
+}
+
+void GFraMe_mixer_add_mono(Sint32 *acc, const Sint16 *src, int num,
+						   Sint16 lgain, Sint16 rgain) {
+	int i;
+
+	i = 0;
+#if defined(GFRAME_MIXER_SSE2)
+	{
+		__m128i gl = _mm_set1_epi16(lgain);
+		__m128i gr = _mm_set1_epi16(rgain);
+		while (i + 8 <= num) {
+			__m128i s, llo, lhi, rlo, rhi, l, r;
+			Sint32 *dst = acc + i * 2;
+
+			s = _mm_loadu_si128((const __m128i*)(src + i));
+			llo = _mm_mullo_epi16(s, gl);
+			lhi = _mm_mulhi_epi16(s, gl);
+			rlo = _mm_mullo_epi16(s, gr);
+			rhi = _mm_mulhi_epi16(s, gr);
+			// Interleave each channel's products
+			l = _mm_srai_epi32(_mm_unpacklo_epi16(llo, lhi), 15);
+			r = _mm_srai_epi32(_mm_unpacklo_epi16(rlo, rhi), 15);
+			_mm_storeu_si128((__m128i*)dst, _mm_add_epi32(
+					_mm_loadu_si128((__m128i*)dst),
+					_mm_unpacklo_epi32(l, r)));
+			_mm_storeu_si128((__m128i*)(dst + 4), _mm_add_epi32(
+					_mm_loadu_si128((__m128i*)(dst + 4)),
+					_mm_unpackhi_epi32(l, r)));
+			l = _mm_srai_epi32(_mm_unpackhi_epi16(llo, lhi), 15);
+			r = _mm_srai_epi32(_mm_unpackhi_epi16(rlo, rhi), 15);
+			_mm_storeu_si128((__m128i*)(dst + 8), _mm_add_epi32(
+					_mm_loadu_si128((__m128i*)(dst + 8)),
+					_mm_unpacklo_epi32(l, r)));
+			_mm_storeu_si128((__m128i*)(dst + 12), _mm_add_epi32(
+					_mm_loadu_si128((__m128i*)(dst + 12)),
+					_mm_unpackhi_epi32(l, r)));
+			i += 8;
+		}
+	}
+#elif defined(GFRAME_MIXER_NEON)
+	{
+		int16x4_t gl = vdup_n_s16(lgain);
+		int16x4_t gr = vdup_n_s16(rgain);
+		while (i + 4 <= num) {
+			int32x4x2_t d;
+			int16x4_t s;
+			Sint32 *dst = acc + i * 2;
+
+			s = vld1_s16(src + i);
+			d = vld2q_s32(dst);
+			d.val[0] = vaddq_s32(d.val[0], vshrq_n_s32(vmull_s16(s, gl), 15));
+			d.val[1] = vaddq_s32(d.val[1], vshrq_n_s32(vmull_s16(s, gr), 15));
+			vst2q_s32(dst, d);
+			i += 4;
+		}
+	}
+#endif
+	while (i < num) {
+		acc[i * 2] += ((Sint32)src[i] * lgain) >> 15;
+		acc[i * 2 + 1] += ((Sint32)src[i] * rgain) >> 15;
+		i++;
+	}
+}
+
+void GFraMe_mixer_saturate(Sint16 *dst, const Sint32 *acc, int num) {
+	int i;
+
+	i = 0;
+#if defined(GFRAME_MIXER_SSE2)
+	while (i + 8 <= num) {
+		// packs saturates each 32 bits value into 16 bits
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(
+				_mm_loadu_si128((const __m128i*)(acc + i)),
+				_mm_loadu_si128((const __m128i*)(acc + i + 4))));
+		i += 8;
+	}
+#elif defined(GFRAME_MIXER_NEON)
+	while (i + 4 <= num) {
+		vst1_s16(dst + i, vqmovn_s32(vld1q_s32(acc + i)));
+		i += 4;
+	}
+#endif
+	while (i < num) {
+		Sint32 s = acc[i];
+		if (s > 32767)
+			s = 32767;
+		else if (s < -32768)
+			s = -32768;
+		dst[i] = (Sint16)s;
+		i++;
+	}
+}
+
+void GFraMe_mixer_gain(Sint32 *acc, int frames, float *gain, float step,
+					   int ramp) {
+	float g;
+	int i, num;
+
+	g = *gain;
+	if (ramp > frames)
+		ramp = frames;
+	i = 0;
+	while (i < ramp) {
+		acc[i * 2] = (Sint32)(acc[i * 2] * g);
+		acc[i * 2 + 1] = (Sint32)(acc[i * 2 + 1] * g);
+		g += step;
+		i++;
+	}
+	*gain = g;
+	if (g == 1.0f)
+		return;
+	// Constant gain, which the compiler is free to vectorize
+	num = frames * 2;
+	i *= 2;
+	while (i < num) {
+		acc[i] = (Sint32)(acc[i] * g);
+		i++;
+	}
+}
+
+void GFraMe_mixer_lowpass(Sint32 *acc, int frames, float coef, float *state) {
+	float l, r;
+	int i;
+
+	// Each output depends on the previous one, so only the channels are
+	// processed together
+	l = state[0];
+	r = state[1];
+	i = 0;
+	while (i < frames) {
+		l += (acc[i * 2] - l) * coef;
+		r += (acc[i * 2 + 1] - r) * coef;
+		acc[i * 2] = (Sint32)l;
+		acc[i * 2 + 1] = (Sint32)r;
+		i++;
+	}
+	state[0] = l;
+	state[1] = r;
+}
+
+float GFraMe_mixer_get_lowpass(double cutoff, int freq) {
+	if (cutoff <= 0.0 || cutoff * 2.0 >= freq)
+		return 1.0f;
+	return (float)(1.0 - exp(-2.0 * M_PI * cutoff / freq));
+}
+
+
+Uint32 GFraMe_mixer_get_step(int src_freq, int dst_freq) {
+	return (Uint32)((((Uint64)src_freq << 16) + dst_freq / 2) / dst_freq);
+}
+
+void GFraMe_mixer_init_resampler(GFraMe_mixer_resampler *rs) {
+	rs->frac = 0;
+	// A single silent frame, so it fades in from silence
+	memset(rs->carry, 0x0, sizeof(rs->carry));
+	rs->num_carry = 1;
+}
+
+/**
+ * Get how many source frames a part uses
+ * @param	frac	Position of the part's first frame, in 16.16 fixed point
+ * @param	frames	How many (output) frames there are
+ * @param	step	Source frames per output frame
+ * @return	How many source frames (counting the carried ones) are used
+ */
+static int GFraMe_mixer_resample_need(Uint32 frac, int frames, Uint32 step) {
+	int need, adv;
+
+	// Every frame interpolated, plus the one where the next part starts
+	need = (int)((frac + (Uint64)(frames - 1) * step) >> 16) + 2;
+	adv = (int)((frac + (Uint64)frames * step) >> 16);
+	if (adv + 1 > need)
+		need = adv + 1;
+	return need;
+}
+
+int GFraMe_mixer_resample_begin(GFraMe_mixer_resampler *rs, Sint16 *src,
+								int *frames, int max, Uint32 step, int chans) {
+	Uint64 lim;
+
+	// Only as many as fits the source (besides the frames carried over and the
+	// one after the last), keeping every position within 32 bits
+	if (max > 0x10000)
+		max = 0x10000;
+	lim = (Uint64)(max - 3) << 16;
+	if ((Uint64)*frames * step > lim)
+		*frames = (int)(lim / step);
+	// The first frames are the ones left over from the previous part
+	memcpy(src, rs->carry, sizeof(Sint16) * rs->num_carry * chans);
+	return GFraMe_mixer_resample_need(rs->frac, *frames, step)
+			- rs->num_carry;
+}
+
+void GFraMe_mixer_resample(GFraMe_mixer_resampler *rs, Sint16 *dst,
+						   const Sint16 *src, int frames, Uint32 step,
+						   int chans) {
+	Uint64 end;
+	Uint32 pos;
+	int i, c, need, adv;
+
+	need = GFraMe_mixer_resample_need(rs->frac, frames, step);
+	end = rs->frac + (Uint64)frames * step;
+	pos = rs->frac;
+	i = 0;
+	while (i < frames) {
+		const Sint16 *a = src + (pos >> 16) * chans;
+		int f = (int)(pos & 0xffff) >> 1;
+
+		c = 0;
+		while (c < chans) {
+			dst[i * chans + c] = (Sint16)(a[c]
+					+ (((a[chans + c] - a[c]) * f) >> 15));
+			c++;
+		}
+		pos += step;
+		i++;
+	}
+	// Keep whatever was read but not yet passed (at most 2 frames)
+	adv = (int)(end >> 16);
+	rs->num_carry = need - adv;
+	memcpy(rs->carry, src + adv * chans,
+		   sizeof(Sint16) * rs->num_carry * chans);
+	rs->frac = (Uint32)(end & 0xffff);
+}
+
+int GFraMe_mixer_resample_skip(GFraMe_mixer_resampler *rs, int frames,
+							   Uint32 step, int chans) {
+	Uint64 end;
+	int adv, num;
+
+	// Convert it into source frames, taking the carried ones into account
+	end = rs->frac + (Uint64)frames * step;
+	adv = (int)(end >> 16);
+	rs->frac = (Uint32)(end & 0xffff);
+	if (adv < rs->num_carry) {
+		rs->num_carry -= adv;
+		memmove(rs->carry, rs->carry + adv * chans,
+				sizeof(Sint16) * rs->num_carry * chans);
+		return 0;
+	}
+	num = adv + 1 - rs->num_carry;
+	// The frame at the new position was skipped as well
+	memset(rs->carry, 0x0, sizeof(rs->carry));
+	rs->num_carry = 1;
+	return num;
+}
@@ -0,0 +1,740 @@
+/**
+ * @src/gframe_nav.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_nav.h>
+#include <GFraMe/GFraMe_tilemap.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Cost of moving to an orthogonal tile
+ */
+#define GFraMe_nav_straight	10
+/**
+ * Cost of moving to a diagonal tile
+ */
+#define GFraMe_nav_diagonal	14
+
+/**
+ * Offset of each direction, clockwise from the right (even directions are
+ *straight, odd ones are diagonal)
+ */
+static const int dir_x[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int dir_y[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+/**
+ * Check whether a tile is inside the map and isn't solid
+ * @param	*nav	The navigation
+ * @param	x	Tile's column
+ * @param	y	Tile's row
+ * @return	1 - It's walkable; 0 - Otherwise
+ */
+static int GFraMe_nav_walkable(GFraMe_nav *nav, int x, int y);
+
+/**
+ * Check whether a tile may be moved to, from a neighbour
+ * @param	*nav	The navigation
+ * @param	x	Neighbour's column
+ * @param	y	Neighbour's row
+ * @param	d	Direction of the move
+ * @return	1 - It may; 0 - Otherwise
+ */
+static int GFraMe_nav_can_move(GFraMe_nav *nav, int x, int y, int d);
+
+/**
+ * Insert a tile into a heap
+ * @param	*heap	The heap
+ * @param	key	Tile's priority
+ * @param	tile	The tile
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_nav_heap_push(GFraMe_nav_heap *heap, int key,
+									   int tile);
+
+/**
+ * Remove the tile with the lowest priority from a (non-empty) heap
+ * @param	*heap	The heap
+ * @param	*key	Returns the tile's priority
+ * @return	The tile
+ */
+static int GFraMe_nav_heap_pop(GFraMe_nav_heap *heap, int *key);
+
+/**
+ * Octile distance between two tiles
+ * @return	The distance
+ */
+static int GFraMe_nav_octile(int x0, int y0, int x1, int y1);
+
+/**
+ * Look for a jump point, moving from a tile on a direction
+ * @param	*nav	The navigation
+ * @param	*jx	Returns the jump point's column
+ * @param	*jy	Returns the jump point's row
+ * @param	x	Column of the first tile to be checked
+ * @param	y	Row of the first tile to be checked
+ * @param	dx	Horizontal direction
+ * @param	dy	Vertical direction
+ * @param	goal	Goal tile
+ * @return	1 - Found; 0 - Otherwise
+ */
+static int GFraMe_nav_jump(GFraMe_nav *nav, int *jx, int *jy, int x, int y,
+						   int dx, int dy, int goal);
+
+/**
+ * Start building a new flow field
+ * @param	*nav	The navigation
+ */
+static void GFraMe_nav_rebuild(GFraMe_nav *nav);
+
+/**
+ * Push a tile into the flow field's pending list, on failure the field is
+ *rebuilt from scratch
+ * @param	*nav	The navigation
+ * @param	key	Tile's distance
+ * @param	tile	The tile
+ */
+static void GFraMe_nav_push_pending(GFraMe_nav *nav, int key, int tile);
+
+/**
+ * Initialize the navigation over a tilemap; the tilemap must have been
+ *initialized with collideable tiles
+ * @param	*nav	The navigation
+ * @param	*tmap	The tilemap
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_nav_init(GFraMe_nav *nav, GFraMe_tilemap *tmap) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int len;
+
+	// Init every alloc'ed pointer with NULL
+	nav->solid = NULL;
+	nav->cost = NULL;
+	nav->parent = NULL;
+	nav->visited = NULL;
+	nav->closed = NULL;
+	nav->dist[0] = NULL;
+	nav->dist[1] = NULL;
+	nav->dir[0] = NULL;
+	nav->dir[1] = NULL;
+	memset(&nav->open, 0x0, sizeof(GFraMe_nav_heap));
+	memset(&nav->pending, 0x0, sizeof(GFraMe_nav_heap));
+	nav->search = 0;
+	nav->front = 0;
+	nav->target = -1;
+	nav->mode = GFraMe_nav_idle;
+	GFraMe_assertRV(tmap->solid, "Tilemap has no solid tiles",
+					rv = GFraMe_ret_bad_param, _ret);
+	nav->width = tmap->width_in_tiles;
+	nav->height = tmap->height_in_tiles;
+	len = nav->width * nav->height;
+	// Alloc everything
+	#define ALLOC(buf, size) \
+		do { \
+			buf = malloc(size * len); \
+			GFraMe_assertRV(buf, "Failed to alloc memory", \
+							rv = GFraMe_ret_memory_error, _ret); \
+		} while (0)
+	ALLOC(nav->solid, sizeof(char));
+	ALLOC(nav->cost, sizeof(int));
+	ALLOC(nav->parent, sizeof(int));
+	ALLOC(nav->visited, sizeof(int));
+	ALLOC(nav->closed, sizeof(int));
+	ALLOC(nav->dist[0], sizeof(int));
+	ALLOC(nav->dist[1], sizeof(int));
+	ALLOC(nav->dir[0], sizeof(signed char));
+	ALLOC(nav->dir[1], sizeof(signed char));
+	#undef ALLOC
+	memcpy(nav->solid, tmap->solid, len);
+	memset(nav->visited, 0x0, sizeof(int) * len);
+	memset(nav->closed, 0x0, sizeof(int) * len);
+	// There's no target, so everything is unreachable
+	memset(nav->dir[0], 0xff, len);
+	len--;
+	while (len >= 0) {
+		nav->dist[0][len] = GFraMe_nav_unreachable;
+		len--;
+	}
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_nav_clear(nav);
+	return rv;
+}
+
+/**
+ * Release every memory alloc'ed by the navigation
+ * @param	*nav	The navigation
+ */
+void GFraMe_nav_clear(GFraMe_nav *nav) {
+	#define FREE(buf) \
+		do { \
+			if (buf) \
+				free(buf); \
+			buf = NULL; \
+		} while (0)
+	FREE(nav->solid);
+	FREE(nav->cost);
+	FREE(nav->parent);
+	FREE(nav->visited);
+	FREE(nav->closed);
+	FREE(nav->dist[0]);
+	FREE(nav->dist[1]);
+	FREE(nav->dir[0]);
+	FREE(nav->dir[1]);
+	FREE(nav->open.keys);
+	FREE(nav->open.tiles);
+	FREE(nav->pending.keys);
+	FREE(nav->pending.tiles);
+	#undef FREE
+	nav->open.len = 0;
+	nav->open.max = 0;
+	nav->pending.len = 0;
+	nav->pending.max = 0;
+	nav->target = -1;
+	nav->mode = GFraMe_nav_idle;
+}
+
+/**
+ * Change whether a tile is solid, updating the flow field accordingly
+ * @param	*nav	The navigation
+ * @param	x	Tile's column
+ * @param	y	Tile's row
+ * @param	solid	Whether it's now solid
+ */
+void GFraMe_nav_set_solid(GFraMe_nav *nav, int x, int y, int solid) {
+	int d, i, *dist;
+	signed char *dir;
+
+	if (x < 0 || y < 0 || x >= nav->width || y >= nav->height)
+		return;
+	i = x + y*nav->width;
+	solid = (solid != 0);
+	if (nav->solid[i] == solid)
+		return;
+	nav->solid[i] = solid;
+	if (nav->target == -1)
+		return;
+	// Blocking a tile may make any distance longer, and a field that's
+	// being built may already have gone through the freed tile
+	if (solid || nav->mode == GFraMe_nav_building || i == nav->target) {
+		GFraMe_nav_rebuild(nav);
+		return;
+	}
+	// Otherwise, distances may only get shorter, so simply get the best one
+	// for the freed tile and propagate it (its neighbours are re-checked as
+	// well, since diagonal moves around it may now be allowed)
+	dist = nav->dist[nav->front];
+	dir = nav->dir[nav->front];
+	dist[i] = GFraMe_nav_unreachable;
+	dir[i] = -1;
+	d = 0;
+	while (d < 8) {
+		int nx, ny, n;
+
+		nx = x + dir_x[d];
+		ny = y + dir_y[d];
+		if (GFraMe_nav_can_move(nav, x, y, d)) {
+			n = nx + ny*nav->width;
+			if (dist[n] != GFraMe_nav_unreachable) {
+				int cost;
+
+				cost = dist[n] + ((d & 1)? GFraMe_nav_diagonal :
+										   GFraMe_nav_straight);
+				if (cost < dist[i]) {
+					dist[i] = cost;
+					dir[i] = d;
+				}
+				GFraMe_nav_push_pending(nav, dist[n], n);
+			}
+		}
+		d++;
+	}
+	if (dist[i] != GFraMe_nav_unreachable)
+		GFraMe_nav_push_pending(nav, dist[i], i);
+	if (nav->mode != GFraMe_nav_building && nav->pending.len > 0)
+		nav->mode = GFraMe_nav_repairing;
+}
+
+/**
+ * Find the shortest path between two tiles
+ * @param	*nav	The navigation
+ * @param	*path	Returns each tile (index) on the path, excluding the start
+ *					one (may be NULL)
+ * @param	max_len	How many tiles fit on the path
+ * @param	*len	Returns how many tiles the whole path has
+ * @param	sx	Start tile's column
+ * @param	sy	Start tile's row
+ * @param	gx	Goal tile's column
+ * @param	gy	Goal tile's row
+ * @return	GFraMe_ret_ok - Found; GFraMe_ret_failed - Unreachable;
+ *			Anything else - Failure
+ */
+GFraMe_ret GFraMe_nav_find_path(GFraMe_nav *nav, int *path, int max_len,
+								int *len, int sx, int sy, int gx, int gy) {
+	GFraMe_ret rv = GFraMe_ret_failed;
+	int goal, start, i, pos;
+
+	*len = 0;
+	if (!GFraMe_nav_walkable(nav, sx, sy) || !GFraMe_nav_walkable(nav, gx, gy))
+		goto _ret;
+	start = sx + sy*nav->width;
+	goal = gx + gy*nav->width;
+	if (start == goal) {
+		rv = GFraMe_ret_ok;
+		goto _ret;
+	}
+	// Use a new search id, instead of clearing every tile
+	nav->search++;
+	if (nav->search <= 0) {
+		memset(nav->visited, 0x0, sizeof(int) * nav->width * nav->height);
+		memset(nav->closed, 0x0, sizeof(int) * nav->width * nav->height);
+		nav->search = 1;
+	}
+	nav->open.len = 0;
+	nav->cost[start] = 0;
+	nav->parent[start] = -1;
+	nav->visited[start] = nav->search;
+	rv = GFraMe_nav_heap_push(&nav->open, GFraMe_nav_octile(sx, sy, gx, gy),
+							  start);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to open tile", _ret);
+	rv = GFraMe_ret_failed;
+	while (nav->open.len > 0) {
+		int cur, cx, cy, d, key, px, py;
+
+		cur = GFraMe_nav_heap_pop(&nav->open, &key);
+		// Tiles may be pushed more than once, so skip the outdated ones
+		if (nav->closed[cur] == nav->search)
+			continue;
+		nav->closed[cur] = nav->search;
+		if (cur == goal) {
+			rv = GFraMe_ret_ok;
+			break;
+		}
+		cx = cur % nav->width;
+		cy = cur / nav->width;
+		px = 0;
+		py = 0;
+		if (nav->parent[cur] != -1) {
+			px = cx - nav->parent[cur] % nav->width;
+			py = cy - nav->parent[cur] / nav->width;
+			px = (px > 0) - (px < 0);
+			py = (py > 0) - (py < 0);
+		}
+		// Only check the directions that weren't pruned
+		d = 0;
+		while (d < 8) {
+			int dx, dy, jx, jy, j, cost;
+
+			dx = dir_x[d];
+			dy = dir_y[d];
+			d++;
+			if (px != 0 || py != 0) {
+				if (px != 0 && py != 0) {
+					// Diagonal: keep going straight or diagonally forward
+					if (!((dx == px && dy == py) || (dx == px && dy == 0) ||
+						  (dx == 0 && dy == py)))
+						continue;
+				}
+				else if ((px != 0 && dx == -px) || (py != 0 && dy == -py))
+					// Straight: anything but going back (since corners can't
+					// be cut, the sides must always be checked)
+					continue;
+			}
+			if (!GFraMe_nav_can_move(nav, cx, cy, d - 1))
+				continue;
+			if (!GFraMe_nav_jump(nav, &jx, &jy, cx + dx, cy + dy, dx, dy,
+								 goal))
+				continue;
+			j = jx + jy*nav->width;
+			if (nav->closed[j] == nav->search)
+				continue;
+			cost = nav->cost[cur] + GFraMe_nav_octile(cx, cy, jx, jy);
+			if (nav->visited[j] != nav->search || cost < nav->cost[j]) {
+				nav->visited[j] = nav->search;
+				nav->cost[j] = cost;
+				nav->parent[j] = cur;
+				rv = GFraMe_nav_heap_push(&nav->open,
+							cost + GFraMe_nav_octile(jx, jy, gx, gy), j);
+				GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to open tile",
+								 _ret);
+				rv = GFraMe_ret_failed;
+			}
+		}
+	}
+	if (rv != GFraMe_ret_ok)
+		goto _ret;
+	// Count how many tiles there are between every jump point...
+	i = goal;
+	while (i != start) {
+		int dx, dy, p;
+
+		p = nav->parent[i];
+		dx = abs(i % nav->width - p % nav->width);
+		dy = abs(i / nav->width - p / nav->width);
+		*len += (dx > dy)? dx : dy;
+		i = p;
+	}
+	if (!path)
+		goto _ret;
+	// ...and then fill the path, from the goal back to the start
+	pos = *len - 1;
+	i = goal;
+	while (i != start) {
+		int dx, dy, x, y, p, px, py;
+
+		p = nav->parent[i];
+		x = i % nav->width;
+		y = i / nav->width;
+		px = p % nav->width;
+		py = p / nav->width;
+		dx = (px > x) - (px < x);
+		dy = (py > y) - (py < y);
+		while (x != px || y != py) {
+			if (pos < max_len)
+				path[pos] = x + y*nav->width;
+			pos--;
+			x += dx;
+			y += dy;
+		}
+		i = p;
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Set the flow field's target; the field is only rebuilt by GFraMe_nav_step
+ * @param	*nav	The navigation
+ * @param	x	Target's column
+ * @param	y	Target's row
+ */
+void GFraMe_nav_set_target(GFraMe_nav *nav, int x, int y) {
+	int target;
+
+	if (x < 0 || y < 0 || x >= nav->width || y >= nav->height)
+		return;
+	target = x + y*nav->width;
+	if (target == nav->target)
+		return;
+	nav->target = target;
+	GFraMe_nav_rebuild(nav);
+}
+
+/**
+ * Update the flow field, processing a limited number of tiles
+ * @param	*nav	The navigation
+ * @param	max_tiles	How many tiles may be processed (0 or less for all)
+ * @return	1 - The field is up to date; 0 - There's still work to do
+ */
+int GFraMe_nav_step(GFraMe_nav *nav, int max_tiles) {
+	signed char *dir;
+	int *dist, num;
+
+	if (nav->mode == GFraMe_nav_idle)
+		return 1;
+	// Repairs are done on the field being read, while rebuilds use the other
+	if (nav->mode == GFraMe_nav_building) {
+		dist = nav->dist[nav->front ^ 1];
+		dir = nav->dir[nav->front ^ 1];
+	}
+	else {
+		dist = nav->dist[nav->front];
+		dir = nav->dir[nav->front];
+	}
+	num = 0;
+	while (nav->pending.len > 0 && (max_tiles <= 0 || num < max_tiles)) {
+		int cur, cx, cy, d, key;
+
+		cur = GFraMe_nav_heap_pop(&nav->pending, &key);
+		// Skip tiles that were pushed again with a shorter distance
+		if (key > dist[cur])
+			continue;
+		cx = cur % nav->width;
+		cy = cur / nav->width;
+		d = 0;
+		while (d < 8) {
+			int n, cost;
+
+			if (GFraMe_nav_can_move(nav, cx, cy, d)) {
+				n = cx + dir_x[d] + (cy + dir_y[d])*nav->width;
+				cost = key + ((d & 1)? GFraMe_nav_diagonal :
+									   GFraMe_nav_straight);
+				if (cost < dist[n]) {
+					dist[n] = cost;
+					// Point back toward the current tile
+					dir[n] = (d + 4) & 7;
+					if (GFraMe_nav_heap_push(&nav->pending, cost, n)
+						!= GFraMe_ret_ok) {
+						// Not much can be done... try again later
+						GFraMe_nav_rebuild(nav);
+						return 0;
+					}
+				}
+			}
+			d++;
+		}
+		num++;
+	}
+	if (nav->pending.len > 0)
+		return 0;
+	if (nav->mode == GFraMe_nav_building)
+		nav->front ^= 1;
+	nav->mode = GFraMe_nav_idle;
+	return 1;
+}
+
+/**
+ * Get a tile's distance to the flow field's target
+ * @param	*nav	The navigation
+ * @param	x	Tile's column
+ * @param	y	Tile's row
+ * @return	The distance (10 per tile) or GFraMe_nav_unreachable
+ */
+int GFraMe_nav_get_distance(GFraMe_nav *nav, int x, int y) {
+	if (x < 0 || y < 0 || x >= nav->width || y >= nav->height)
+		return GFraMe_nav_unreachable;
+	return nav->dist[nav->front][x + y*nav->width];
+}
+
+/**
+ * Get the next tile toward the flow field's target
+ * @param	*nav	The navigation
+ * @param	*nx	Returns the next tile's column
+ * @param	*ny	Returns the next tile's row
+ * @param	x	Current tile's column
+ * @param	y	Current tile's row
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - Already on the
+ *			target or it's unreachable
+ */
+GFraMe_ret GFraMe_nav_get_next(GFraMe_nav *nav, int *nx, int *ny, int x,
+							   int y) {
+	int d;
+
+	if (x < 0 || y < 0 || x >= nav->width || y >= nav->height)
+		return GFraMe_ret_failed;
+	d = nav->dir[nav->front][x + y*nav->width];
+	// The field may be outdated (while it's rebuilt), so check the move
+	if (d < 0 || !GFraMe_nav_can_move(nav, x, y, d))
+		return GFraMe_ret_failed;
+	*nx = x + dir_x[d];
+	*ny = y + dir_y[d];
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Start building a new flow field
+ * @param	*nav	The navigation
+ */
+static void GFraMe_nav_rebuild(GFraMe_nav *nav) {
+	signed char *dir;
+	int i, *dist;
+
+	dist = nav->dist[nav->front ^ 1];
+	dir = nav->dir[nav->front ^ 1];
+	i = nav->width * nav->height - 1;
+	while (i >= 0) {
+		dist[i] = GFraMe_nav_unreachable;
+		i--;
+	}
+	memset(dir, 0xff, nav->width * nav->height);
+	nav->pending.len = 0;
+	nav->mode = GFraMe_nav_building;
+	if (nav->solid[nav->target])
+		return;
+	// This can't fail (since the heap was emptied, unless it was never
+	// alloc'ed and there's no memory), in which case the field is empty
+	dist[nav->target] = 0;
+	GFraMe_nav_heap_push(&nav->pending, 0, nav->target);
+}
+
+/**
+ * Push a tile into the flow field's pending list, on failure the field is
+ *rebuilt from scratch
+ * @param	*nav	The navigation
+ * @param	key	Tile's distance
+ * @param	tile	The tile
+ */
+static void GFraMe_nav_push_pending(GFraMe_nav *nav, int key, int tile) {
+	if (GFraMe_nav_heap_push(&nav->pending, key, tile) != GFraMe_ret_ok)
+		GFraMe_nav_rebuild(nav);
+}
+
+/**
+ * Look for a jump point, moving from a tile on a direction
+ * @param	*nav	The navigation
+ * @param	*jx	Returns the jump point's column
+ * @param	*jy	Returns the jump point's row
+ * @param	x	Column of the first tile to be checked
+ * @param	y	Row of the first tile to be checked
+ * @param	dx	Horizontal direction
+ * @param	dy	Vertical direction
+ * @param	goal	Goal tile
+ * @return	1 - Found; 0 - Otherwise
+ */
+static int GFraMe_nav_jump(GFraMe_nav *nav, int *jx, int *jy, int x, int y,
+						   int dx, int dy, int goal) {
+	int tmpx, tmpy;
+
+	while (1) {
+		if (!GFraMe_nav_walkable(nav, x, y))
+			return 0;
+		if (x + y*nav->width == goal)
+			break;
+		if (dx != 0 && dy != 0) {
+			// Diagonal moves stop wherever a straight move would find a
+			// jump point
+			if (GFraMe_nav_jump(nav, &tmpx, &tmpy, x + dx, y, dx, 0, goal) ||
+				GFraMe_nav_jump(nav, &tmpx, &tmpy, x, y + dy, 0, dy, goal))
+				break;
+		}
+		else if (dx != 0) {
+			// Stop on forced neighbours (i.e., a wall behind ends)
+			if ((GFraMe_nav_walkable(nav, x, y - 1) &&
+				 !GFraMe_nav_walkable(nav, x - dx, y - 1)) ||
+				(GFraMe_nav_walkable(nav, x, y + 1) &&
+				 !GFraMe_nav_walkable(nav, x - dx, y + 1)))
+				break;
+		}
+		else {
+			if ((GFraMe_nav_walkable(nav, x - 1, y) &&
+				 !GFraMe_nav_walkable(nav, x - 1, y - dy)) ||
+				(GFraMe_nav_walkable(nav, x + 1, y) &&
+				 !GFraMe_nav_walkable(nav, x + 1, y - dy)))
+				break;
+		}
+		// Corners can't be cut
+		if (!GFraMe_nav_walkable(nav, x + dx, y) ||
+			!GFraMe_nav_walkable(nav, x, y + dy))
+			return 0;
+		x += dx;
+		y += dy;
+	}
+	*jx = x;
+	*jy = y;
+	return 1;
+}
+
+/**
+ * Check whether a tile is inside the map and isn't solid
+ * @param	*nav	The navigation
+ * @param	x	Tile's column
+ * @param	y	Tile's row
+ * @return	1 - It's walkable; 0 - Otherwise
+ */
+static int GFraMe_nav_walkable(GFraMe_nav *nav, int x, int y) {
+	return x >= 0 && y >= 0 && x < nav->width && y < nav->height &&
+		   !nav->solid[x + y*nav->width];
+}
+
+/**
+ * Check whether a tile may be moved to, from a neighbour
+ * @param	*nav	The navigation
+ * @param	x	Neighbour's column
+ * @param	y	Neighbour's row
+ * @param	d	Direction of the move
+ * @return	1 - It may; 0 - Otherwise
+ */
+static int GFraMe_nav_can_move(GFraMe_nav *nav, int x, int y, int d) {
+	int dx, dy;
+
+	dx = dir_x[d];
+	dy = dir_y[d];
+	if (!GFraMe_nav_walkable(nav, x + dx, y + dy))
+		return 0;
+	// Diagonals may only be taken if both orthogonal tiles are free
+	if (d & 1)
+		return GFraMe_nav_walkable(nav, x + dx, y) &&
+			   GFraMe_nav_walkable(nav, x, y + dy);
+	return 1;
+}
+
+/**
+ * Octile distance between two tiles
+ * @return	The distance
+ */
+static int GFraMe_nav_octile(int x0, int y0, int x1, int y1) {
+	int dx, dy;
+
+	dx = abs(x1 - x0);
+	dy = abs(y1 - y0);
+	if (dx < dy)
+		return GFraMe_nav_diagonal * dx + GFraMe_nav_straight * (dy - dx);
+	return GFraMe_nav_diagonal * dy + GFraMe_nav_straight * (dx - dy);
+}
+
+/**
+ * Insert a tile into a heap
+ * @param	*heap	The heap
+ * @param	key	Tile's priority
+ * @param	tile	The tile
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_nav_heap_push(GFraMe_nav_heap *heap, int key,
+									   int tile) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i;
+
+	if (heap->len >= heap->max) {
+		int max, *tmp;
+
+		max = (heap->max > 0)? heap->max * 2 : 256;
+		tmp = (int*)realloc(heap->keys, sizeof(int) * max);
+		GFraMe_assertRV(tmp, "Failed to alloc memory",
+						rv = GFraMe_ret_memory_error, _ret);
+		heap->keys = tmp;
+		tmp = (int*)realloc(heap->tiles, sizeof(int) * max);
+		GFraMe_assertRV(tmp, "Failed to alloc memory",
+						rv = GFraMe_ret_memory_error, _ret);
+		heap->tiles = tmp;
+		heap->max = max;
+	}
+	// Sift it up
+	i = heap->len;
+	heap->len++;
+	while (i > 0) {
+		int p = (i - 1) / 2;
+		if (heap->keys[p] <= key)
+			break;
+		heap->keys[i] = heap->keys[p];
+		heap->tiles[i] = heap->tiles[p];
+		i = p;
+	}
+	heap->keys[i] = key;
+	heap->tiles[i] = tile;
+_ret:
+	return rv;
+}
+
+/**
+ * Remove the tile with the lowest priority from a (non-empty) heap
+ * @param	*heap	The heap
+ * @param	*key	Returns the tile's priority
+ * @return	The tile
+ */
+static int GFraMe_nav_heap_pop(GFraMe_nav_heap *heap, int *key) {
+	int i, last_key, last_tile, tile;
+
+	*key = heap->keys[0];
+	tile = heap->tiles[0];
+	heap->len--;
+	last_key = heap->keys[heap->len];
+	last_tile = heap->tiles[heap->len];
+	// Sift the last item down, from the root
+	i = 0;
+	while (1) {
+		int c = i*2 + 1;
+		if (c >= heap->len)
+			break;
+		if (c + 1 < heap->len && heap->keys[c + 1] < heap->keys[c])
+			c++;
+		if (last_key <= heap->keys[c])
+			break;
+		heap->keys[i] = heap->keys[c];
+		heap->tiles[i] = heap->tiles[c];
+		i = c;
+	}
+	heap->keys[i] = last_key;
+	heap->tiles[i] = last_tile;
+	return tile;
+}
+
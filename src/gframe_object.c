@@ -7,6 +7,32 @@
 #include <GFraMe/GFraMe_tween.h>
 #include <GFraMe/GFraMe_util.h>
 
+/**
+ * Position an object exactly grazing another one, on the side it was on the
+ * previous frame
+ * @param	*cur	Object to be moved
+ * @param	*other	Object that stays still
+ * @param	hcol	Whether it should be separated horizontally
+ * @param	vcol	Whether it should be separated vertically
+ * @param	hmax	Maximum horizontal distance for overlap
+ * @param	vmax	Maximum vertical distance for overlap
+ */
+static void GFraMe_object_graze(GFraMe_object *cur, GFraMe_object *other,
+								int hcol, int vcol, double hmax, double vmax);
+
+/**
+ * Set the hit flags of two objects that collided
+ * @param	*o1	One of the objects
+ * @param	*o2	The other object
+ * @param	hcol	Whether they collided horizontally
+ * @param	vcol	Whether they collided vertically
+ * @param	hdist	Horizontal distance from o1's center to o2's
+ * @param	vdist	Vertical distance from o1's center to o2's
+ */
+static void GFraMe_object_set_hit(GFraMe_object *o1, GFraMe_object *o2,
+								  int hcol, int vcol, double hdist,
+								  double vdist);
+
 /**
  * Clear every one of the object's attribute
  * @param	*obj	The object
@@ -23,6 +49,10 @@ void GFraMe_object_clear(GFraMe_object *obj) {
 	obj->ay = 0.0;
 	// Reset collision
 	obj->hit = GFraMe_direction_none;
+	// Put it on the first layer, colliding against everything
+	GFraMe_object_set_layer(obj, 0x1, ~0x0u);
+	// Make it a dynamic object, awake
+	GFraMe_object_set_static(obj, 0);
 	// Reset the hitbox
 	GFraMe_hitbox_set(GFraMe_object_get_hitbox(obj), GFraMe_hitbox_center, 
 					  0, 0, 0, 0);
@@ -41,6 +71,8 @@ void GFraMe_object_set_x(GFraMe_object *obj, int X) {
 	obj->dx = (double)X;
 	// Setting this avoids glitches on collision
 	obj->ldx = (double)X;
+	// Make sure a collision world notices it
+	obj->sleeping = 0;
 }
 
 /**
@@ -54,6 +86,8 @@ void GFraMe_object_set_y(GFraMe_object *obj, int Y) {
 	obj->dy = (double)Y;
 	// Setting this avoids glitches on collision
 	obj->ldy = (double)Y;
+	// Make sure a collision world notices it
+	obj->sleeping = 0;
 }
 
 /**
@@ -69,6 +103,78 @@ void GFraMe_object_set_pos(GFraMe_object *obj, int X, int Y) {
 	GFraMe_object_set_y(obj, Y);
 }
 
+/**
+ * Get an object's position interpolated between its last and current update
+ * @param	*obj	The object
+ * @param	alpha	How far into the next update it is (0.0 is the last
+ *				position and 1.0 the current one)
+ * @param	*X	Returns the horizontal position
+ * @param	*Y	Returns the vertical position
+ */
+void GFraMe_object_get_lerp_pos(GFraMe_object *obj, float alpha, int *X,
+								int *Y) {
+	double t;
+
+	if (alpha < 0.0f)
+		alpha = 0.0f;
+	else if (alpha > 1.0f)
+		alpha = 1.0f;
+	// Move back from the current position (so 1.0 is exactly x and y)
+	t = 1.0 - (double)alpha;
+	*X = obj->x - (int)((obj->dx - obj->ldx) * t);
+	*Y = obj->y - (int)((obj->dy - obj->ldy) * t);
+}
+
+/**
+ * Sets in which layers an object is and against which layers it collides;
+ * two objects only collide, on a collision world, if each one's category
+ * matches the other's mask
+ * @param	*obj	The object
+ * @param	category	Bitfield of layers the object belongs to
+ * @param	mask	Bitfield of layers the object collides against
+ */
+void GFraMe_object_set_layer(GFraMe_object *obj, unsigned int category,
+							 unsigned int mask) {
+	obj->category = category;
+	obj->mask = mask;
+}
+
+/**
+ * Sets whether an object is static; static objects are never updated by a
+ * collision world, but still collide against awake objects
+ * @param	*obj	The object
+ * @param	is_static	Whether it's static
+ */
+void GFraMe_object_set_static(GFraMe_object *obj, int is_static) {
+	obj->is_static = is_static;
+	obj->sleeping = is_static;
+	obj->idle_time = 0;
+}
+
+/**
+ * Wakes an object, so a collision world will update it again; changing its
+ * velocity, acceleration, tween or position already wakes it
+ * @param	*obj	The object
+ */
+void GFraMe_object_wake(GFraMe_object *obj) {
+	obj->sleeping = 0;
+	obj->idle_time = 0;
+}
+
+/**
+ * Check whether an object is at rest (i.e., not moving nor tweening)
+ * @param	*obj	The object
+ * @return	1 - It's at rest; 0 - It's moving
+ */
+int GFraMe_object_is_idle(GFraMe_object *obj) {
+	GFraMe_tween *tw;
+
+	tw = GFraMe_object_get_tween(obj);
+	return obj->vx == 0.0 && obj->vy == 0.0 && obj->ax == 0.0 &&
+		   obj->ay == 0.0 && obj->dx == obj->ldx && obj->dy == obj->ldy &&
+		   tw->time >= tw->maxTime;
+}
+
 /**
  * Updates an object's position, velocity and collision state
  * @param	*obj	Object to be update
@@ -198,66 +304,15 @@ GFraMe_ret GFraMe_object_overlap(GFraMe_object *o1, GFraMe_object *o2,
 				case GFraMe_second_fixed: cur = o1; other = o2; break;
 				default: goto _aftercol; // Avoids accessing null objects
 			}
-			// If they weren't overlapping horizontally, separate it
-			if (hcol) {
-				// Position it exactly grazing horizontally
-				cur->dx = other->dx + other->hitbox.cx - cur->hitbox.cx;
-				if (cur->ldx + cur->hitbox.cx > other->ldx + other->hitbox.cx) {
-                    // GFraMe_log("right");
-					cur->dx += hmax;
-                }
-				else {
-                    // GFraMe_log("left");
-					cur->dx -= hmax;
-                }
-				// Update the actual position!!
-				cur->x = (int)cur->dx;
-			}
-			// If they weren't overlapping vertically, separate it
-			if (vcol) {
-				// Position it exactly grazing vertically
-				cur->dy = other->dy + other->hitbox.cy - cur->hitbox.cy;
-				if (cur->ldy + cur->hitbox.cy > other->ldy + other->hitbox.cy) {
-                    // GFraMe_log("bellow");
-					cur->dy += vmax;
-                }
-				else {
-                    // GFraMe_log("above");
-					cur->dy -= vmax;
-                }
-				// Update the actual position!!
-				cur->y = (int)cur->dy;
-			}
+			// Separate it on every direction it wasn't overlapping before
+			GFraMe_object_graze(cur, other, hcol, vcol, hmax, vmax);
 		}
 _aftercol:
 		// TODO this will probably clear overlap after one frame...
 		// is it a problem?
 		
 		// Now, set all the flags
-		// If they are overlapping horizontally
-		if (hcol) {
-			// Check which was farther to the right/left
-			if (hdist > 0) {
-				o1->hit |= GFraMe_direction_right;
-				o2->hit |= GFraMe_direction_left;
-			}
-			else {
-				o1->hit |= GFraMe_direction_left;
-				o2->hit |= GFraMe_direction_right;
-			}
-		}
-		// If they are overlapping vertically
-		if (vcol) {
-			// Check which was higher/lower
-			if (vdist > 0) {
-				o1->hit |= GFraMe_direction_down;
-				o2->hit |= GFraMe_direction_up;
-			}
-			else {
-				o1->hit |= GFraMe_direction_up;
-				o2->hit |= GFraMe_direction_down;
-			}
-		}
+		GFraMe_object_set_hit(o1, o2, hcol, vcol, hdist, vdist);
 		// Signal as overlap happening
 		rv = GFraMe_ret_ok;
 	}
@@ -265,6 +320,221 @@ _aftercol:
 	return rv;
 }
 
+/**
+ * Calculate when, between their last and current positions, two objects
+ * start overlapping; both are considered to move linearly
+ * @param	*o1	One of the objects
+ * @param	*o2	The other object
+ * @param	*toi	Returns the time of impact, in the range [0, 1)
+ * @param	*hcol	Returns whether they touched horizontally
+ * @param	*vcol	Returns whether they touched vertically
+ * @return	GFraMe_ret_ok - if they hit; GFraMe_ret_no_overlap - otherwise
+ */
+GFraMe_ret GFraMe_object_sweep_toi(GFraMe_object *o1, GFraMe_object *o2,
+								   double *toi, int *hcol, int *vcol) {
+	double hdist, vdist;
+	double hmax, vmax;
+	double rvx, rvy;
+	double hin, hout, vin, vout;
+	double tin, tout;
+	
+	// Compute the distance between their centers on the last frame
+	hdist = o2->ldx + o2->hitbox.cx - o1->ldx - o1->hitbox.cx;
+	vdist = o2->ldy + o2->hitbox.cy - o1->ldy - o1->hitbox.cy;
+	// Compute maximum distances for overlap
+	hmax = o2->hitbox.hw + o1->hitbox.hw;
+	vmax = o2->hitbox.hh + o1->hitbox.hh;
+	// If they were already overlapping, there's no time of impact
+	if (GFraMe_util_absd(hdist) < hmax && GFraMe_util_absd(vdist) < vmax)
+		return GFraMe_ret_no_overlap;
+	// Get how much o2 moved, as seen from o1
+	rvx = (o2->dx - o2->ldx) - (o1->dx - o1->ldx);
+	rvy = (o2->dy - o2->ldy) - (o1->dy - o1->ldy);
+	// Calculate the interval in which they overlap horizontally...
+	if (rvx == 0.0) {
+		if (GFraMe_util_absd(hdist) >= hmax)
+			return GFraMe_ret_no_overlap;
+		hin = -1.0;
+		hout = 2.0;
+	}
+	else {
+		hin = (-hmax - hdist) / rvx;
+		hout = (hmax - hdist) / rvx;
+		if (hin > hout) {
+			double tmp = hin;
+			hin = hout;
+			hout = tmp;
+		}
+	}
+	// ...and vertically
+	if (rvy == 0.0) {
+		if (GFraMe_util_absd(vdist) >= vmax)
+			return GFraMe_ret_no_overlap;
+		vin = -1.0;
+		vout = 2.0;
+	}
+	else {
+		vin = (-vmax - vdist) / rvy;
+		vout = (vmax - vdist) / rvy;
+		if (vin > vout) {
+			double tmp = vin;
+			vin = vout;
+			vout = tmp;
+		}
+	}
+	// They only overlap when both intervals do, and it must be this frame
+	tin = (hin > vin)? hin : vin;
+	tout = (hout < vout)? hout : vout;
+	if (tin >= tout || tin >= 1.0 || tout <= 0.0)
+		return GFraMe_ret_no_overlap;
+	// The last axis to start overlapping is the one that was hit
+	*toi = tin;
+	*hcol = (hin >= vin);
+	*vcol = (vin >= hin);
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Overlaps two objects, according to the mode passed, but checking the whole
+ * movement since the last frame; this avoids fast objects from tunneling
+ * through thin ones. If the objects were already overlapping on the previous
+ * frame, it works exactly as GFraMe_object_overlap
+ * @param	*o1	One of the objects to be overlaped
+ * @param	*o2	The other object to be overlaped
+ * @param	mode	How collision should be handle
+ * @return	Whether an overlap occured (GFraMe_ret_ok) or not (GFraMe_ret_no_overlap)
+ */
+GFraMe_ret GFraMe_object_sweep(GFraMe_object *o1, GFraMe_object *o2,
+							   GFraMe_collision_type mode) {
+	double hdist;
+	double vdist;
+	double toi;
+	int hcol, vcol;
+	GFraMe_ret rv;
+	
+	// Compute the distance between their centers on the last frame
+	hdist = o2->ldx + o2->hitbox.cx - o1->ldx - o1->hitbox.cx;
+	vdist = o2->ldy + o2->hitbox.cy - o1->ldy - o1->hitbox.cy;
+	// Objects that were overlapping can be handled the usual way
+	if (GFraMe_util_absd(hdist) < o2->hitbox.hw + o1->hitbox.hw &&
+		GFraMe_util_absd(vdist) < o2->hitbox.hh + o1->hitbox.hh)
+		return GFraMe_object_overlap(o1, o2, mode);
+	
+	rv = GFraMe_object_sweep_toi(o1, o2, &toi, &hcol, &vcol);
+	if (rv != GFraMe_ret_ok)
+		return rv;
+	
+	if (mode == GFraMe_collision_full) {
+		// Move both back to where they touched
+		if (hcol) {
+			o1->dx = o1->ldx + (o1->dx - o1->ldx) * toi;
+			o2->dx = o2->ldx + (o2->dx - o2->ldx) * toi;
+			o1->x = (int)o1->dx;
+			o2->x = (int)o2->dx;
+		}
+		if (vcol) {
+			o1->dy = o1->ldy + (o1->dy - o1->ldy) * toi;
+			o2->dy = o2->ldy + (o2->dy - o2->ldy) * toi;
+			o1->y = (int)o1->dy;
+			o2->y = (int)o2->dy;
+		}
+	}
+	else if (mode == GFraMe_first_fixed)
+		GFraMe_object_graze(o2, o1, hcol, vcol,
+							o2->hitbox.hw + o1->hitbox.hw,
+							o2->hitbox.hh + o1->hitbox.hh);
+	else if (mode == GFraMe_second_fixed)
+		GFraMe_object_graze(o1, o2, hcol, vcol,
+							o2->hitbox.hw + o1->hitbox.hw,
+							o2->hitbox.hh + o1->hitbox.hh);
+	// Since they may have crossed each other, use the last frame distance
+	GFraMe_object_set_hit(o1, o2, hcol, vcol, hdist, vdist);
+	
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Position an object exactly grazing another one, on the side it was on the
+ * previous frame
+ * @param	*cur	Object to be moved
+ * @param	*other	Object that stays still
+ * @param	hcol	Whether it should be separated horizontally
+ * @param	vcol	Whether it should be separated vertically
+ * @param	hmax	Maximum horizontal distance for overlap
+ * @param	vmax	Maximum vertical distance for overlap
+ */
+static void GFraMe_object_graze(GFraMe_object *cur, GFraMe_object *other,
+								int hcol, int vcol, double hmax, double vmax) {
+	// If they weren't overlapping horizontally, separate it
+	if (hcol) {
+		// Position it exactly grazing horizontally
+		cur->dx = other->dx + other->hitbox.cx - cur->hitbox.cx;
+		if (cur->ldx + cur->hitbox.cx > other->ldx + other->hitbox.cx) {
+			// GFraMe_log("right");
+			cur->dx += hmax;
+		}
+		else {
+			// GFraMe_log("left");
+			cur->dx -= hmax;
+		}
+		// Update the actual position!!
+		cur->x = (int)cur->dx;
+	}
+	// If they weren't overlapping vertically, separate it
+	if (vcol) {
+		// Position it exactly grazing vertically
+		cur->dy = other->dy + other->hitbox.cy - cur->hitbox.cy;
+		if (cur->ldy + cur->hitbox.cy > other->ldy + other->hitbox.cy) {
+			// GFraMe_log("bellow");
+			cur->dy += vmax;
+		}
+		else {
+			// GFraMe_log("above");
+			cur->dy -= vmax;
+		}
+		// Update the actual position!!
+		cur->y = (int)cur->dy;
+	}
+}
+
+/**
+ * Set the hit flags of two objects that collided
+ * @param	*o1	One of the objects
+ * @param	*o2	The other object
+ * @param	hcol	Whether they collided horizontally
+ * @param	vcol	Whether they collided vertically
+ * @param	hdist	Horizontal distance from o1's center to o2's
+ * @param	vdist	Vertical distance from o1's center to o2's
+ */
+static void GFraMe_object_set_hit(GFraMe_object *o1, GFraMe_object *o2,
+								  int hcol, int vcol, double hdist,
+								  double vdist) {
+	// If they are overlapping horizontally
+	if (hcol) {
+		// Check which was farther to the right/left
+		if (hdist > 0) {
+			o1->hit |= GFraMe_direction_right;
+			o2->hit |= GFraMe_direction_left;
+		}
+		else {
+			o1->hit |= GFraMe_direction_left;
+			o2->hit |= GFraMe_direction_right;
+		}
+	}
+	// If they are overlapping vertically
+	if (vcol) {
+		// Check which was higher/lower
+		if (vdist > 0) {
+			o1->hit |= GFraMe_direction_down;
+			o2->hit |= GFraMe_direction_up;
+		}
+		else {
+			o1->hit |= GFraMe_direction_up;
+			o2->hit |= GFraMe_direction_down;
+		}
+	}
+}
+
 GFraMe_hitbox *GFraMe_object_get_hitbox(GFraMe_object *obj) {
 	return &obj->hitbox;
 }
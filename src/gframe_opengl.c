@@ -70,6 +70,15 @@ void GFraMe_opengl_setAlpha(float alpha) {
 	glw_setAlpha(alpha);
 }
 
+void GFraMe_opengl_setTime(float ms) {
+	glw_setTime(ms);
+}
+
+void GFraMe_opengl_setAnimation(int first, int num, float fps, float start,
+	int columns) {
+	glw_setAnimation(first, num, fps, start, columns);
+}
+
 void GFraMe_opengl_renderSprite(int x, int y, int dx, int dy, int tx, int ty) {
 	glw_renderSprite(x, y, dx, dy, tx, ty);
 }
@@ -0,0 +1,202 @@
+/**
+ * @src/gframe_pool.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_pool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Mask for getting the slot out of a handle
+ */
+#define GFraMe_pool_slot_mask	(GFraMe_pool_max_items - 1)
+/**
+ * Greatest generation before it wraps around
+ */
+#define GFraMe_pool_max_gen	(0xffffffffu >> GFraMe_pool_slot_bits)
+
+/**
+ * Get the memory of a slot
+ */
+#define GFraMe_pool_slot(pool, slot) \
+	((pool)->items + (size_t)(slot) * (pool)->item_size)
+
+/**
+ * Get the slot pointed by a handle
+ * @param	*pool	The pool
+ * @param	handle	The handle
+ * @return	The slot or -1, if the handle is stale
+ */
+static int GFraMe_pool_get_slot(GFraMe_pool *pool, GFraMe_pool_handle handle);
+
+GFraMe_ret GFraMe_pool_init(GFraMe_pool *pool, int item_size, int max_items) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i;
+
+	pool->items = NULL;
+	pool->gens = NULL;
+	pool->live = NULL;
+	pool->live_pos = NULL;
+	pool->len = 0;
+	pool->free_slot = -1;
+	pool->max_items = 0;
+	GFraMe_assertRV(max_items > 0 && max_items <= GFraMe_pool_max_items,
+					"Invalid number of items", rv = GFraMe_ret_bad_param,
+					_ret);
+	// Free slots store the next one, so every item must fit an int
+	if (item_size < (int)sizeof(int))
+		item_size = sizeof(int);
+	pool->item_size = item_size;
+	pool->items = (char*)malloc((size_t)item_size * max_items);
+	GFraMe_assertRV(pool->items, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->gens = (unsigned int*)malloc(sizeof(unsigned int) * max_items);
+	GFraMe_assertRV(pool->gens, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->live = (int*)malloc(sizeof(int) * max_items);
+	GFraMe_assertRV(pool->live, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->live_pos = (int*)malloc(sizeof(int) * max_items);
+	GFraMe_assertRV(pool->live_pos, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	pool->max_items = max_items;
+	i = 0;
+	while (i < max_items) {
+		pool->gens[i] = 1;
+		pool->live_pos[i] = 0;
+		i++;
+	}
+	GFraMe_pool_reset(pool);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_pool_clear(pool);
+	return rv;
+}
+
+void GFraMe_pool_clear(GFraMe_pool *pool) {
+	if (pool->items)
+		free(pool->items);
+	pool->items = NULL;
+	if (pool->gens)
+		free(pool->gens);
+	pool->gens = NULL;
+	if (pool->live)
+		free(pool->live);
+	pool->live = NULL;
+	if (pool->live_pos)
+		free(pool->live_pos);
+	pool->live_pos = NULL;
+	pool->max_items = 0;
+	pool->len = 0;
+	pool->free_slot = -1;
+}
+
+void GFraMe_pool_reset(GFraMe_pool *pool) {
+	int i;
+
+	// Invalidate every live handle
+	i = 0;
+	while (i < pool->len) {
+		int slot = pool->live[i];
+		pool->gens[slot]++;
+		if (pool->gens[slot] > GFraMe_pool_max_gen)
+			pool->gens[slot] = 1;
+		i++;
+	}
+	pool->len = 0;
+	// Chain every slot, in order, so the first ones are used first
+	i = pool->max_items - 1;
+	pool->free_slot = -1;
+	while (i >= 0) {
+		memcpy(GFraMe_pool_slot(pool, i), &pool->free_slot, sizeof(int));
+		pool->free_slot = i;
+		i--;
+	}
+}
+
+GFraMe_ret GFraMe_pool_acquire(GFraMe_pool *pool, GFraMe_pool_handle *handle,
+							   void **item) {
+	int slot;
+
+	if (pool->free_slot == -1)
+		return GFraMe_ret_failed;
+	// Pop the first free slot
+	slot = pool->free_slot;
+	memcpy(&pool->free_slot, GFraMe_pool_slot(pool, slot), sizeof(int));
+	// And append it to the live list
+	pool->live[pool->len] = slot;
+	pool->live_pos[slot] = pool->len;
+	pool->len++;
+	if (handle)
+		*handle = (pool->gens[slot] << GFraMe_pool_slot_bits) | slot;
+	*item = GFraMe_pool_slot(pool, slot);
+	return GFraMe_ret_ok;
+}
+
+GFraMe_ret GFraMe_pool_release(GFraMe_pool *pool, GFraMe_pool_handle handle) {
+	int slot;
+
+	slot = GFraMe_pool_get_slot(pool, handle);
+	if (slot == -1)
+		return GFraMe_ret_bad_param;
+	GFraMe_pool_release_at(pool, pool->live_pos[slot]);
+	return GFraMe_ret_ok;
+}
+
+void GFraMe_pool_release_at(GFraMe_pool *pool, int i) {
+	int last, slot;
+
+	slot = pool->live[i];
+	// Swap the last live item into this position
+	pool->len--;
+	last = pool->live[pool->len];
+	pool->live[i] = last;
+	pool->live_pos[last] = i;
+	// Invalidate the slot's handles and push it onto the free list
+	pool->gens[slot]++;
+	if (pool->gens[slot] > GFraMe_pool_max_gen)
+		pool->gens[slot] = 1;
+	memcpy(GFraMe_pool_slot(pool, slot), &pool->free_slot, sizeof(int));
+	pool->free_slot = slot;
+}
+
+void *GFraMe_pool_get(GFraMe_pool *pool, GFraMe_pool_handle handle) {
+	int slot;
+
+	slot = GFraMe_pool_get_slot(pool, handle);
+	if (slot == -1)
+		return NULL;
+	return GFraMe_pool_slot(pool, slot);
+}
+
+void *GFraMe_pool_at(GFraMe_pool *pool, int i) {
+	return GFraMe_pool_slot(pool, pool->live[i]);
+}
+
+GFraMe_pool_handle GFraMe_pool_handle_at(GFraMe_pool *pool, int i) {
+	int slot = pool->live[i];
+	return (pool->gens[slot] << GFraMe_pool_slot_bits) | slot;
+}
+
+/**
+ * Get the slot pointed by a handle
+ * @param	*pool	The pool
+ * @param	handle	The handle
+ * @return	The slot or -1, if the handle is stale
+ */
+static int GFraMe_pool_get_slot(GFraMe_pool *pool, GFraMe_pool_handle handle) {
+	int slot;
+
+	slot = (int)(handle & GFraMe_pool_slot_mask);
+	if (slot >= pool->max_items)
+		return -1;
+	if (pool->gens[slot] != (handle >> GFraMe_pool_slot_bits))
+		return -1;
+	// Released slots have already had their generation incremented, but
+	// make sure the slot is actually alive
+	if (pool->live_pos[slot] >= pool->len ||
+		pool->live[pool->live_pos[slot]] != slot)
+		return -1;
+	return slot;
+}
+
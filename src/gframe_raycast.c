@@ -0,0 +1,238 @@
+/**
+ * @src/gframe_raycast.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_raycast.h>
+#include <math.h>
+
+/**
+ * Distance used for axis that the segment never crosses
+ */
+#define GFraMe_raycast_far	1e30
+
+/**
+ * Clip a segment against an AABB
+ * @param	*enter	Returns where the segment enters the box
+ * @param	*leave	Returns where the segment leaves the box
+ * @param	*face	Returns the face through which it entered
+ * @return	GFraMe_ret_ok - Hit; GFraMe_ret_no_overlap - Missed
+ */
+static GFraMe_ret GFraMe_raycast_clip(double *enter, double *leave,
+									  GFraMe_direction *face, double x0,
+									  double y0, double x1, double y1,
+									  double l, double t, double r,
+									  double b);
+
+/**
+ * Cast a segment against an AABB
+ * @param	*hit	Returns where it was hit (only set on hits)
+ * @param	x0	Segment's horizontal start
+ * @param	y0	Segment's vertical start
+ * @param	x1	Segment's horizontal end
+ * @param	y1	Segment's vertical end
+ * @param	l	Box's left edge
+ * @param	t	Box's top edge
+ * @param	r	Box's right edge
+ * @param	b	Box's bottom edge
+ * @return	GFraMe_ret_ok - Hit; GFraMe_ret_no_overlap - Missed
+ */
+GFraMe_ret GFraMe_raycast_aabb(GFraMe_raycast_hit *hit, double x0, double y0,
+							   double x1, double y1, double l, double t,
+							   double r, double b) {
+	GFraMe_direction face;
+	double enter, leave;
+	GFraMe_ret rv;
+
+	rv = GFraMe_raycast_clip(&enter, &leave, &face, x0, y0, x1, y1, l, t, r,
+							 b);
+	if (rv == GFraMe_ret_ok) {
+		hit->did_hit = 1;
+		hit->t = enter;
+		hit->x = x0 + (x1 - x0) * enter;
+		hit->y = y0 + (y1 - y0) * enter;
+		hit->face = face;
+	}
+	return rv;
+}
+
+/**
+ * Start walking a grid, placing the walker on the first cell crossed by the
+ *segment; coordinates are relative to the grid's upper left corner
+ * @param	*dda	The walker
+ * @param	x0	Segment's horizontal start
+ * @param	y0	Segment's vertical start
+ * @param	x1	Segment's horizontal end
+ * @param	y1	Segment's vertical end
+ * @param	cell_w	Width of each cell
+ * @param	cell_h	Height of each cell
+ * @param	columns	How many cells there are horizontally
+ * @param	rows	How many cells there are vertically
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_no_overlap - The segment
+ *			doesn't cross the grid
+ */
+GFraMe_ret GFraMe_raycast_dda_init(GFraMe_raycast_dda *dda, double x0,
+								   double y0, double x1, double y1,
+								   double cell_w, double cell_h, int columns,
+								   int rows) {
+	double dx, dy, px, py;
+	GFraMe_ret rv;
+
+	// Only walk the part of the segment inside the grid
+	rv = GFraMe_raycast_clip(&dda->t, &dda->t_end, &dda->face, x0, y0, x1,
+							 y1, 0.0, 0.0, cell_w * columns, cell_h * rows);
+	if (rv != GFraMe_ret_ok)
+		return rv;
+	dx = x1 - x0;
+	dy = y1 - y0;
+	px = x0 + dx * dda->t;
+	py = y0 + dy * dda->t;
+	dda->columns = columns;
+	dda->rows = rows;
+	// Get the first cell (clamping it, since it may be exactly on the edge)
+	dda->cx = (int)floor(px / cell_w);
+	dda->cy = (int)floor(py / cell_h);
+	if (dda->cx < 0)
+		dda->cx = 0;
+	else if (dda->cx >= columns)
+		dda->cx = columns - 1;
+	if (dda->cy < 0)
+		dda->cy = 0;
+	else if (dda->cy >= rows)
+		dda->cy = rows - 1;
+	// Get when each axis crosses its first cell border and how long each
+	// cell is, along the segment
+	if (dx > 0.0) {
+		dda->step_x = 1;
+		dda->t_delta_x = cell_w / dx;
+		dda->t_max_x = ((dda->cx + 1) * cell_w - x0) / dx;
+	}
+	else if (dx < 0.0) {
+		dda->step_x = -1;
+		dda->t_delta_x = -cell_w / dx;
+		dda->t_max_x = (dda->cx * cell_w - x0) / dx;
+	}
+	else {
+		dda->step_x = 0;
+		dda->t_delta_x = GFraMe_raycast_far;
+		dda->t_max_x = GFraMe_raycast_far;
+	}
+	if (dy > 0.0) {
+		dda->step_y = 1;
+		dda->t_delta_y = cell_h / dy;
+		dda->t_max_y = ((dda->cy + 1) * cell_h - y0) / dy;
+	}
+	else if (dy < 0.0) {
+		dda->step_y = -1;
+		dda->t_delta_y = -cell_h / dy;
+		dda->t_max_y = (dda->cy * cell_h - y0) / dy;
+	}
+	else {
+		dda->step_y = 0;
+		dda->t_delta_y = GFraMe_raycast_far;
+		dda->t_max_y = GFraMe_raycast_far;
+	}
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Move the walker to the next cell crossed by the segment
+ * @param	*dda	The walker
+ * @return	1 - Moved; 0 - The segment ended (or left the grid)
+ */
+int GFraMe_raycast_dda_next(GFraMe_raycast_dda *dda) {
+	// Cross whichever border comes first
+	if (dda->t_max_x < dda->t_max_y) {
+		dda->cx += dda->step_x;
+		dda->t = dda->t_max_x;
+		dda->t_max_x += dda->t_delta_x;
+		if (dda->step_x > 0)
+			dda->face = GFraMe_direction_left;
+		else
+			dda->face = GFraMe_direction_right;
+	}
+	else {
+		dda->cy += dda->step_y;
+		dda->t = dda->t_max_y;
+		dda->t_max_y += dda->t_delta_y;
+		if (dda->step_y > 0)
+			dda->face = GFraMe_direction_up;
+		else
+			dda->face = GFraMe_direction_down;
+	}
+	return dda->t <= dda->t_end && dda->cx >= 0 && dda->cx < dda->columns &&
+		   dda->cy >= 0 && dda->cy < dda->rows;
+}
+
+/**
+ * Clip a segment against an AABB
+ * @param	*enter	Returns where the segment enters the box
+ * @param	*leave	Returns where the segment leaves the box
+ * @param	*face	Returns the face through which it entered
+ * @return	GFraMe_ret_ok - Hit; GFraMe_ret_no_overlap - Missed
+ */
+static GFraMe_ret GFraMe_raycast_clip(double *enter, double *leave,
+									  GFraMe_direction *face, double x0,
+									  double y0, double x1, double y1,
+									  double l, double t, double r,
+									  double b) {
+	double dx, dy, tmin, tmax;
+
+	dx = x1 - x0;
+	dy = y1 - y0;
+	tmin = 0.0;
+	tmax = 1.0;
+	*face = GFraMe_direction_none;
+	// Clip it horizontally
+	if (dx == 0.0) {
+		if (x0 < l || x0 > r)
+			return GFraMe_ret_no_overlap;
+	}
+	else {
+		double t0, t1;
+
+		t0 = (l - x0) / dx;
+		t1 = (r - x0) / dx;
+		if (dx < 0.0) {
+			double tmp = t0;
+			t0 = t1;
+			t1 = tmp;
+		}
+		if (t0 > tmin) {
+			tmin = t0;
+			*face = (dx > 0.0)? GFraMe_direction_left : GFraMe_direction_right;
+		}
+		if (t1 < tmax)
+			tmax = t1;
+		if (tmin > tmax)
+			return GFraMe_ret_no_overlap;
+	}
+	// Clip it vertically
+	if (dy == 0.0) {
+		if (y0 < t || y0 > b)
+			return GFraMe_ret_no_overlap;
+	}
+	else {
+		double t0, t1;
+
+		t0 = (t - y0) / dy;
+		t1 = (b - y0) / dy;
+		if (dy < 0.0) {
+			double tmp = t0;
+			t0 = t1;
+			t1 = tmp;
+		}
+		if (t0 > tmin) {
+			tmin = t0;
+			*face = (dy > 0.0)? GFraMe_direction_up : GFraMe_direction_down;
+		}
+		if (t1 < tmax)
+			tmax = t1;
+		if (tmin > tmax)
+			return GFraMe_ret_no_overlap;
+	}
+	*enter = tmin;
+	*leave = tmax;
+	return GFraMe_ret_ok;
+}
+
@@ -0,0 +1,113 @@
+/**
+ * @src/gframe_reverb.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_reverb.h>
+#include <SDL2/SDL_stdinc.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Delays (at 44100 Hz), mutually prime so the echoes don't pile up
+ */
+static const int GFraMe_reverb_comb_delays[GFraMe_reverb_num_combs] = {
+	1116, 1188, 1277, 1356
+};
+static const int GFraMe_reverb_ap_delays[GFraMe_reverb_num_allpass] = {
+	556, 441
+};
+
+GFraMe_ret GFraMe_reverb_init(GFraMe_reverb *rev, int freq) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i, total;
+
+	rev->lines = NULL;
+	total = 0;
+	i = 0;
+	while (i < GFraMe_reverb_num_combs) {
+		rev->comb_len[i] = GFraMe_reverb_comb_delays[i] * freq / 44100 + 1;
+		rev->comb_pos[i] = 0;
+		rev->comb_lp[i] = 0.0f;
+		total += rev->comb_len[i];
+		i++;
+	}
+	i = 0;
+	while (i < GFraMe_reverb_num_allpass) {
+		rev->ap_len[i] = GFraMe_reverb_ap_delays[i] * freq / 44100 + 1;
+		rev->ap_pos[i] = 0;
+		total += rev->ap_len[i];
+		i++;
+	}
+	rev->lines = (float*)malloc(sizeof(float) * total);
+	GFraMe_assertRV(rev->lines, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	memset(rev->lines, 0x0, sizeof(float) * total);
+	GFraMe_reverb_set(rev, 0.5, 0.5);
+_ret:
+	return rv;
+}
+
+void GFraMe_reverb_clear(GFraMe_reverb *rev) {
+	if (rev->lines)
+		free(rev->lines);
+	rev->lines = NULL;
+}
+
+void GFraMe_reverb_set(GFraMe_reverb *rev, double room, double damp) {
+	if (room < 0.0)
+		room = 0.0;
+	else if (room > 1.0)
+		room = 1.0;
+	if (damp < 0.0)
+		damp = 0.0;
+	else if (damp > 1.0)
+		damp = 1.0;
+	rev->feedback = (float)(0.7 + room * 0.28);
+	rev->damp = (float)(damp * 0.4);
+}
+
+void GFraMe_reverb_process(GFraMe_reverb *rev, Sint32 *dst, const Sint32 *src,
+						   int frames) {
+	int i;
+
+	i = 0;
+	while (i < frames) {
+		float in, out, *line;
+		int c;
+
+		// Scaled down, so the combs' gain doesn't clip (and offset by a tiny
+		// amount, so the lines never decay into slow denormals)
+		in = (src[i * 2] + src[i * 2 + 1]) * 0.125f + 1e-18f;
+		out = 0.0f;
+		line = rev->lines;
+		c = 0;
+		while (c < GFraMe_reverb_num_combs) {
+			float y = line[rev->comb_pos[c]];
+
+			out += y;
+			rev->comb_lp[c] = y + (rev->comb_lp[c] - y) * rev->damp;
+			line[rev->comb_pos[c]] = in + rev->comb_lp[c] * rev->feedback;
+			rev->comb_pos[c]++;
+			if (rev->comb_pos[c] == rev->comb_len[c])
+				rev->comb_pos[c] = 0;
+			line += rev->comb_len[c];
+			c++;
+		}
+		c = 0;
+		while (c < GFraMe_reverb_num_allpass) {
+			float y = line[rev->ap_pos[c]];
+
+			line[rev->ap_pos[c]] = out + y * 0.5f;
+			out = y - out;
+			rev->ap_pos[c]++;
+			if (rev->ap_pos[c] == rev->ap_len[c])
+				rev->ap_pos[c] = 0;
+			line += rev->ap_len[c];
+			c++;
+		}
+		dst[i * 2] += (Sint32)out;
+		dst[i * 2 + 1] += (Sint32)out;
+		i++;
+	}
+}
+
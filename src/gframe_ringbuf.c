@@ -0,0 +1,121 @@
+/**
+ * @src/gframe_ringbuf.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_ringbuf.h>
+#include <SDL2/SDL_atomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+GFraMe_ret GFraMe_ringbuf_init(GFraMe_ringbuf *rb, int size) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int pot;
+
+	rb->buf = NULL;
+	rb->size = 0;
+	SDL_AtomicSet(&rb->head, 0);
+	SDL_AtomicSet(&rb->tail, 0);
+	GFraMe_assertRV(size > 0 && size <= (1 << 30), "Invalid ring size",
+					rv = GFraMe_ret_bad_param, _ret);
+	pot = 1;
+	while (pot < size)
+		pot <<= 1;
+	rb->buf = (char*)malloc(pot);
+	GFraMe_assertRV(rb->buf, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	rb->size = pot;
+_ret:
+	return rv;
+}
+
+void GFraMe_ringbuf_clear(GFraMe_ringbuf *rb) {
+	if (rb->buf)
+		free(rb->buf);
+	rb->buf = NULL;
+	rb->size = 0;
+	GFraMe_ringbuf_reset(rb);
+}
+
+void GFraMe_ringbuf_reset(GFraMe_ringbuf *rb) {
+	SDL_AtomicSet(&rb->head, 0);
+	SDL_AtomicSet(&rb->tail, 0);
+}
+
+int GFraMe_ringbuf_get_used(GFraMe_ringbuf *rb) {
+	unsigned int head, tail;
+
+	head = (unsigned int)SDL_AtomicGet(&rb->head);
+	tail = (unsigned int)SDL_AtomicGet(&rb->tail);
+	return (int)(tail - head);
+}
+
+int GFraMe_ringbuf_get_free(GFraMe_ringbuf *rb) {
+	return rb->size - GFraMe_ringbuf_get_used(rb);
+}
+
+int GFraMe_ringbuf_write(GFraMe_ringbuf *rb, const void *data, int len) {
+	unsigned int head, tail;
+	int pos, first, space;
+
+	head = (unsigned int)SDL_AtomicGet(&rb->head);
+	tail = (unsigned int)SDL_AtomicGet(&rb->tail);
+	// Don't overwrite anything before the consumer is done reading it
+	SDL_MemoryBarrierAcquire();
+	space = rb->size - (int)(tail - head);
+	if (len > space)
+		len = space;
+	if (len <= 0)
+		return 0;
+	// Copy it in (at most) two parts, around the end of the buffer
+	pos = (int)(tail & (unsigned int)(rb->size - 1));
+	first = rb->size - pos;
+	if (first > len)
+		first = len;
+	memcpy(rb->buf + pos, data, first);
+	memcpy(rb->buf, (const char*)data + first, len - first);
+	// Publish it only after it was completely written
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&rb->tail, (int)(tail + (unsigned int)len));
+	return len;
+}
+
+int GFraMe_ringbuf_read(GFraMe_ringbuf *rb, void *data, int len) {
+	unsigned int head, tail;
+	int pos, first, used;
+
+	head = (unsigned int)SDL_AtomicGet(&rb->head);
+	tail = (unsigned int)SDL_AtomicGet(&rb->tail);
+	// Don't read anything before the producer is done writing it
+	SDL_MemoryBarrierAcquire();
+	used = (int)(tail - head);
+	if (len > used)
+		len = used;
+	if (len <= 0)
+		return 0;
+	pos = (int)(head & (unsigned int)(rb->size - 1));
+	first = rb->size - pos;
+	if (first > len)
+		first = len;
+	memcpy(data, rb->buf + pos, first);
+	memcpy((char*)data + first, rb->buf, len - first);
+	// Release the space only after it was completely read
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&rb->head, (int)(head + (unsigned int)len));
+	return len;
+}
+
+int GFraMe_ringbuf_skip(GFraMe_ringbuf *rb, int len) {
+	unsigned int head, tail;
+	int used;
+
+	head = (unsigned int)SDL_AtomicGet(&rb->head);
+	tail = (unsigned int)SDL_AtomicGet(&rb->tail);
+	used = (int)(tail - head);
+	if (len > used)
+		len = used;
+	if (len <= 0)
+		return 0;
+	SDL_AtomicSet(&rb->head, (int)(head + (unsigned int)len));
+	return len;
+}
+
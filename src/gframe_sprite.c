@@ -171,6 +171,51 @@ __ret:
     return;
 }
 
+/**
+ * Draw a sprite interpolated between its last and current update
+ * 
+ * @param *spr Sprite to be drawn
+ * @param alpha How far into the next update it is (e.g., GFraMe_event_alpha)
+ */
+void GFraMe_sprite_draw_lerp(GFraMe_sprite *spr, float alpha) {
+    int x, y;
+    
+    // Assign its interpolated position, render and revert
+    x = spr->obj.x;
+    y = spr->obj.y;
+    GFraMe_object_get_lerp_pos(&spr->obj, alpha, &spr->obj.x, &spr->obj.y);
+    
+    GFraMe_sprite_draw(spr);
+    
+    spr->obj.x = x;
+    spr->obj.y = y;
+}
+
+/**
+ * Draw a sprite from world space into screen space, interpolated between its
+ * last and current update; the camera should be interpolated by the caller
+ * (e.g., through GFraMe_util_lerp)
+ * 
+ * @param *spr Sprite to be drawn
+ * @param alpha How far into the next update it is (e.g., GFraMe_event_alpha)
+ * @param cam_x The camera's horizontal position
+ * @param cam_y The camera's vertical position
+ * @param cam_w The camera's width
+ * @param cam_h The camera's height
+ */
+void GFraMe_sprite_draw_camera_lerp(GFraMe_sprite *spr, float alpha, int cam_x, int cam_y, int cam_w, int cam_h) {
+    int x, y;
+    
+    x = spr->obj.x;
+    y = spr->obj.y;
+    GFraMe_object_get_lerp_pos(&spr->obj, alpha, &spr->obj.x, &spr->obj.y);
+    
+    GFraMe_sprite_draw_camera(spr, cam_x, cam_y, cam_w, cam_h);
+    
+    spr->obj.x = x;
+    spr->obj.y = y;
+}
+
 /**
  * Change the sprite    s animation
  * @param *spr Sprite to have it    s animation changed
@@ -7,6 +7,11 @@
 #include <GFraMe/GFraMe_spriteset.h>
 #include <GFraMe/GFraMe_texture.h>
 
+/**
+ * Time used by looping tiles, in milliseconds
+ */
+static int _GFraMe_sset_time = 0;
+
 /**
  * Initialize a new spriteset
  * @param	*sset	Spriteset to be initialized
@@ -113,4 +118,60 @@ _ret:
 	return rv;
 }
 
+/**
+ * Set the time used by looping tiles (usually, the time since the game
+ *started); on OpenGL, it's only uploaded once per frame
+ * @param	ms	Current time, in milliseconds
+ */
+void GFraMe_spriteset_set_time(int ms) {
+	_GFraMe_sset_time = ms;
+#if defined(GFRAME_OPENGL)
+	GFraMe_opengl_setTime((float)ms);
+#endif
+}
 
+/**
+ * Render a looping animation, whose frames are num_frames contiguous tiles.
+ *The current frame is calculated from the time set by
+ *GFraMe_spriteset_set_time (on OpenGL, by the vertex shader), so the
+ *animation never has to be updated
+ * @param	*sset	Spriteset used to render
+ * @param	first_tile	Animation's first tile
+ * @param	num_frames	How many frames there are in the animation
+ * @param	fps	At how many frames per second it should run
+ * @param	start_ms	When the animation started, in milliseconds
+ * @param	*ctx	Position and transformations
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_spriteset_draw_looped(GFraMe_spriteset *sset,
+	int first_tile, int num_frames, int fps, int start_ms,
+	GFraMe_ssetRenderCtx *ctx) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	
+	GFraMe_assertRV(first_tile + num_frames <= sset->max, "Invalid tile!",
+					rv = GFraMe_ret_bad_param, _ret);
+	if (num_frames <= 1 || fps <= 0)
+		return GFraMe_spriteset_draw_ex(sset, first_tile, ctx);
+#if defined(GFRAME_OPENGL)
+	GFraMe_opengl_setAnimation(first_tile, num_frames, (float)fps,
+		(float)start_ms, sset->columns);
+	rv = GFraMe_spriteset_draw_ex(sset, first_tile, ctx);
+	GFraMe_opengl_setAnimation(0, 0, 0.0f, 0.0f, 0);
+#else
+	{
+		long long frame;
+		// Same as the shader: floor((time - start) * fps / 1000) mod frames
+		frame = (long long)(_GFraMe_sset_time - start_ms) * fps;
+		if (frame >= 0)
+			frame /= 1000;
+		else
+			frame = -((-frame + 999) / 1000);
+		frame %= num_frames;
+		if (frame < 0)
+			frame += num_frames;
+		rv = GFraMe_spriteset_draw_ex(sset, first_tile + (int)frame, ctx);
+	}
+#endif
+_ret:
+	return rv;
+}
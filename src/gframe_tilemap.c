@@ -2,14 +2,41 @@
  * @src/gframe_tilemap.c
  */
 #include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_hitbox.h>
 #include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_raycast.h>
 #include <GFraMe/GFraMe_spriteset.h>
 #include <GFraMe/GFraMe_tilemap.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /**
- * 
+ * Mark which tiles are solid
+ * @param	*tmap	Tilemap (with data and dimensions already set)
+ * @param	*collideable	Array with which tile types are solid
+ * @param	col_len	Length of the collideable array
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_tilemap_build_solid(GFraMe_tilemap *tmap,
+											 char *collideable, int col_len);
+
+/**
+ * Cover every solid tile with as few boxes as possible
+ * @param	*tmap	Tilemap (with its solid tiles already marked)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_tilemap_build_boxes(GFraMe_tilemap *tmap);
+
+/**
+ * Move the boxes to the tilemap's current position, if it has changed
+ * @param	*tmap	The tilemap
+ */
+static void GFraMe_tilemap_place_boxes(GFraMe_tilemap *tmap);
+
+/**
+ * Initialize a tilemap; if a spriteset and collideable tiles are supplied,
+ * solid tiles will be covered by as few boxes as possible
  * @param	*tmap	Tilemap to be initialized
  * @param	width_in_tiles	How many tiles there are horizontally
  * @param	height_in_tiles	How many tiles there are vertically
@@ -25,7 +52,9 @@ GFraMe_ret GFraMe_tilemap_init(GFraMe_tilemap *tmap, int width_in_tiles,
 	GFraMe_ret rv = GFraMe_ret_ok;
 	// Init every alloc'ed pointer with NULL
 	tmap->data = NULL;
+	tmap->solid = NULL;
 	tmap->boxes = NULL;
+	tmap->num_boxes = 0;
 	// Copy tilemap's limits
 	tmap->width_in_tiles = width_in_tiles;
 	tmap->height_in_tiles = height_in_tiles;
@@ -33,10 +62,16 @@ GFraMe_ret GFraMe_tilemap_init(GFraMe_tilemap *tmap, int width_in_tiles,
 	tmap->data = data;
 	GFraMe_assertRV(tmap->data, "Failed to alloc assign data",
 					rv = GFraMe_ret_memory_error, _ret);
-	// TODO check collideable array and create the minimum amount
-	// of objects to cover the complete area
 	// Copy the spriteset
 	tmap->sset = sset;
+	// Create the objects that cover the solid area
+	if (sset && collideable && col_len > 0) {
+		rv = GFraMe_tilemap_build_solid(tmap, collideable, col_len);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to mark solid tiles",
+						 _ret);
+		rv = GFraMe_tilemap_build_boxes(tmap);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to create boxes", _ret);
+	}
 _ret:
 	if (rv != GFraMe_ret_ok)
 		GFraMe_tilemap_clear(tmap);
@@ -54,10 +89,14 @@ void GFraMe_tilemap_clear(GFraMe_tilemap *tmap) {
 	//if (tmap->data)
 	//	free(tmap->data);
 	tmap->data = NULL;
+	if (tmap->solid)
+		free(tmap->solid);
+	tmap->solid = NULL;
 	// Check if there was any data and free it
 	if (tmap->boxes)
 		free(tmap->boxes);
 	tmap->boxes = NULL;
+	tmap->num_boxes = 0;
 }
 
 GFraMe_ret GFraMe_tilemap_draw(GFraMe_tilemap *tmap) {
@@ -104,8 +143,321 @@ _ret:
 	return rv;
 }
 
+/**
+ * Draw only the tiles inside a camera, from world space into screen space; to
+ * scroll smoothly between updates, pass a camera interpolated by the caller
+ * (e.g., through GFraMe_util_lerp)
+ * @param	*tmap	The tilemap
+ * @param	cam_x	The camera's horizontal position
+ * @param	cam_y	The camera's vertical position
+ * @param	cam_w	The camera's width
+ * @param	cam_h	The camera's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_tilemap_draw_camera(GFraMe_tilemap *tmap, int cam_x,
+									  int cam_y, int cam_w, int cam_h) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i, j, tw, th, left, top, right, bottom;
+
+	tw = tmap->sset->tw;
+	th = tmap->sset->th;
+	// Get the range of visible tiles
+	left = 0;
+	if (cam_x > tmap->x)
+		left = (cam_x - tmap->x) / tw;
+	top = 0;
+	if (cam_y > tmap->y)
+		top = (cam_y - tmap->y) / th;
+	right = (cam_x + cam_w - tmap->x) / tw + 1;
+	if (right > tmap->width_in_tiles)
+		right = tmap->width_in_tiles;
+	bottom = (cam_y + cam_h - tmap->y) / th + 1;
+	if (bottom > tmap->height_in_tiles)
+		bottom = tmap->height_in_tiles;
+	j = top;
+	while (j < bottom) {
+		i = left;
+		while (i < right) {
+			char tile = tmap->data[i + j*tmap->width_in_tiles];
+			if (tile > 0)
+				rv = GFraMe_spriteset_draw(tmap->sset, tile,
+										   tmap->x + i*tw - cam_x,
+										   tmap->y + j*th - cam_y, 0);
+			GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to draw tilemap",
+							 _ret);
+			i++;
+		}
+		j++;
+	}
+_ret:
+	return rv;
+}
+
 GFraMe_ret GFraMe_tilemap_overlap(GFraMe_tilemap *tmap,GFraMe_object *obj){
+	int i;
 	GFraMe_ret rv = GFraMe_ret_no_overlap;
+	
+	GFraMe_tilemap_place_boxes(tmap);
+	// Simply collide against every box
+	i = 0;
+	while (i < tmap->num_boxes) {
+		if (GFraMe_object_overlap(&tmap->boxes[i], obj, GFraMe_first_fixed)
+			== GFraMe_ret_ok)
+			rv = GFraMe_ret_ok;
+		i++;
+	}
 	return rv;
 }
 
+/**
+ * Collide an object against every box on the tilemap, checking its whole
+ * movement since the last frame (so it won't tunnel through thin walls);
+ * the boxes are handled in the order they were hit
+ * @param	*tmap	The tilemap
+ * @param	*obj	Object to be collided
+ * @return	Whether an overlap occured (GFraMe_ret_ok) or not (GFraMe_ret_no_overlap)
+ */
+GFraMe_ret GFraMe_tilemap_sweep(GFraMe_tilemap *tmap, GFraMe_object *obj) {
+	int i, n;
+	GFraMe_ret rv = GFraMe_ret_no_overlap;
+	
+	GFraMe_tilemap_place_boxes(tmap);
+	// Stop the object on the first box it hits, then check the remaining
+	// movement (since it may slide into another box)
+	n = 0;
+	while (n < GFraMe_tilemap_max_sweeps) {
+		double toi, first_toi;
+		int first, hcol, vcol;
+		
+		first = -1;
+		first_toi = 1.0;
+		i = 0;
+		while (i < tmap->num_boxes) {
+			if (GFraMe_object_sweep_toi(&tmap->boxes[i], obj, &toi, &hcol,
+										&vcol) == GFraMe_ret_ok
+				&& toi < first_toi) {
+				first = i;
+				first_toi = toi;
+			}
+			i++;
+		}
+		if (first == -1)
+			break;
+		GFraMe_object_sweep(&tmap->boxes[first], obj, GFraMe_first_fixed);
+		rv = GFraMe_ret_ok;
+		n++;
+	}
+	// Handle anything that was already overlapping on the previous frame
+	if (GFraMe_tilemap_overlap(tmap, obj) == GFraMe_ret_ok)
+		rv = GFraMe_ret_ok;
+	return rv;
+}
+
+/**
+ * Cast a segment against the tilemap's solid tiles
+ * @param	*tmap	The tilemap
+ * @param	*hit	Returns the first solid tile hit
+ * @param	x0	Segment's horizontal start (in world space)
+ * @param	y0	Segment's vertical start
+ * @param	x1	Segment's horizontal end
+ * @param	y1	Segment's vertical end
+ * @return	GFraMe_ret_ok - Hit; GFraMe_ret_no_overlap - Missed
+ */
+GFraMe_ret GFraMe_tilemap_raycast(GFraMe_tilemap *tmap,
+								  GFraMe_raycast_hit *hit, double x0,
+								  double y0, double x1, double y1) {
+	GFraMe_raycast_dda dda;
+	GFraMe_ret rv;
+	
+	hit->did_hit = 0;
+	if (!tmap->solid)
+		return GFraMe_ret_no_overlap;
+	// Walk every tile crossed by the segment, in order
+	rv = GFraMe_raycast_dda_init(&dda, x0 - tmap->x, y0 - tmap->y,
+								 x1 - tmap->x, y1 - tmap->y, tmap->sset->tw,
+								 tmap->sset->th, tmap->width_in_tiles,
+								 tmap->height_in_tiles);
+	if (rv != GFraMe_ret_ok)
+		return rv;
+	do {
+		if (tmap->solid[dda.cx + dda.cy*tmap->width_in_tiles]) {
+			hit->did_hit = 1;
+			hit->t = dda.t;
+			hit->x = x0 + (x1 - x0) * dda.t;
+			hit->y = y0 + (y1 - y0) * dda.t;
+			hit->face = dda.face;
+			hit->obj = NULL;
+			hit->tile_x = dda.cx;
+			hit->tile_y = dda.cy;
+			return GFraMe_ret_ok;
+		}
+	} while (GFraMe_raycast_dda_next(&dda));
+	return GFraMe_ret_no_overlap;
+}
+
+/**
+ * Check whether there's no solid tile between two points
+ * @param	*tmap	The tilemap
+ * @param	x0	First point's horizontal position
+ * @param	y0	First point's vertical position
+ * @param	x1	Second point's horizontal position
+ * @param	y1	Second point's vertical position
+ * @return	1 - They can see each other; 0 - Otherwise
+ */
+int GFraMe_tilemap_line_of_sight(GFraMe_tilemap *tmap, double x0, double y0,
+								 double x1, double y1) {
+	GFraMe_raycast_hit hit;
+	
+	return GFraMe_tilemap_raycast(tmap, &hit, x0, y0, x1, y1)
+		   == GFraMe_ret_no_overlap;
+}
+
+/**
+ * Cast many segments against the tilemap's solid tiles (e.g., a vision cone)
+ * @param	*tmap	The tilemap
+ * @param	*hits	Returns each segment's hit (did_hit is 0 on misses)
+ * @param	*segs	Segments, as x0, y0, x1, y1 (4 values per segment)
+ * @param	num	How many segments there are
+ * @return	How many segments hit a solid tile
+ */
+int GFraMe_tilemap_raycast_batch(GFraMe_tilemap *tmap,
+								 GFraMe_raycast_hit *hits, double *segs,
+								 int num) {
+	int i, count;
+	
+	count = 0;
+	i = 0;
+	while (i < num) {
+		if (GFraMe_tilemap_raycast(tmap, hits + i, segs[0], segs[1], segs[2],
+								   segs[3]) == GFraMe_ret_ok)
+			count++;
+		segs += 4;
+		i++;
+	}
+	return count;
+}
+
+/**
+ * Mark which tiles are solid
+ * @param	*tmap	Tilemap (with data and dimensions already set)
+ * @param	*collideable	Array with which tile types are solid
+ * @param	col_len	Length of the collideable array
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_tilemap_build_solid(GFraMe_tilemap *tmap,
+											 char *collideable, int col_len) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	char is_solid[256];
+	int i, len;
+	
+	// Use a table, instead of searching the collideable list for each tile
+	memset(is_solid, 0x0, sizeof(is_solid));
+	i = 0;
+	while (i < col_len) {
+		is_solid[(unsigned char)collideable[i]] = 1;
+		i++;
+	}
+	len = tmap->width_in_tiles * tmap->height_in_tiles;
+	tmap->solid = (char*)malloc(len);
+	GFraMe_assertRV(tmap->solid, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	i = 0;
+	while (i < len) {
+		tmap->solid[i] = is_solid[(unsigned char)tmap->data[i]];
+		i++;
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Cover every solid tile with as few boxes as possible
+ * @param	*tmap	Tilemap (with its solid tiles already marked)
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_tilemap_build_boxes(GFraMe_tilemap *tmap) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	char *solid = NULL;
+	int i, len;
+	
+	len = tmap->width_in_tiles * tmap->height_in_tiles;
+	// Copy which tiles are solid (tiles are cleared as they are covered)
+	solid = (char*)malloc(len);
+	GFraMe_assertRV(solid, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	memcpy(solid, tmap->solid, len);
+	// There can't be more boxes than solid tiles
+	tmap->boxes = (GFraMe_object*)malloc(sizeof(GFraMe_object)*len);
+	GFraMe_assertRV(tmap->boxes, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	// Greedily expand each box to the right, then downward
+	i = 0;
+	while (i < len) {
+		GFraMe_object *box;
+		int x, y, w, h;
+		
+		if (!solid[i]) {
+			i++;
+			continue;
+		}
+		x = i % tmap->width_in_tiles;
+		y = i / tmap->width_in_tiles;
+		w = 1;
+		while (x + w < tmap->width_in_tiles && solid[i + w])
+			w++;
+		h = 1;
+		while (y + h < tmap->height_in_tiles) {
+			char *row = solid + i + h*tmap->width_in_tiles;
+			int j = 0;
+			while (j < w && row[j])
+				j++;
+			if (j < w)
+				break;
+			h++;
+		}
+		// Remove the covered tiles
+		y = 0;
+		while (y < h) {
+			memset(solid + i + y*tmap->width_in_tiles, 0x0, w);
+			y++;
+		}
+		y = i / tmap->width_in_tiles;
+		// Create the box (on the tilemap's local space)
+		box = &tmap->boxes[tmap->num_boxes];
+		GFraMe_object_clear(box);
+		GFraMe_object_set_pos(box, x*tmap->sset->tw, y*tmap->sset->th);
+		GFraMe_hitbox_set(GFraMe_object_get_hitbox(box),
+						  GFraMe_hitbox_upper_left, 0, 0, w*tmap->sset->tw,
+						  h*tmap->sset->th);
+		tmap->num_boxes++;
+		i += w;
+	}
+	tmap->box_x = 0;
+	tmap->box_y = 0;
+_ret:
+	if (solid)
+		free(solid);
+	return rv;
+}
+
+/**
+ * Move the boxes to the tilemap's current position, if it has changed
+ * @param	*tmap	The tilemap
+ */
+static void GFraMe_tilemap_place_boxes(GFraMe_tilemap *tmap) {
+	int i, dx, dy;
+	
+	dx = tmap->x - tmap->box_x;
+	dy = tmap->y - tmap->box_y;
+	if (tmap->num_boxes == 0 || (dx == 0 && dy == 0))
+		return;
+	i = 0;
+	while (i < tmap->num_boxes) {
+		GFraMe_object *box = &tmap->boxes[i];
+		GFraMe_object_set_pos(box, box->x + dx, box->y + dy);
+		i++;
+	}
+	tmap->box_x = tmap->x;
+	tmap->box_y = tmap->y;
+}
+
@@ -15,9 +15,9 @@ static Uint32 simple_callback(Uint32 interval, void *param);
  * @return	How long each frame must take, in milliseconds
  */
 int GFraMe_timer_get_ms(int fps) {
-	// Apparently, SDL requires this granularity where interval must be
-	// a multiple of 10...
-	return 1000 / fps / 10 * 10;
+	// SDL2 timers have millisecond granularity (rounding it down to a
+	// multiple of 10 made 60 fps run at 100 ticks per second)
+	return 1000 / fps;
 }
 
 /**
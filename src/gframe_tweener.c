@@ -0,0 +1,481 @@
+/**
+ * @src/gframe_tweener.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_pool.h>
+#include <GFraMe/GFraMe_tweener.h>
+#include <math.h>
+
+/**
+ * What a tween modifies
+ */
+enum enGFraMe_tweener_type {
+	GFraMe_tweener_float_type = 0,
+	GFraMe_tweener_int_type,
+	GFraMe_tweener_obj_type
+};
+
+/**
+ * Flags of a tween
+ */
+enum enGFraMe_tweener_flags {
+	/**
+	 * Waiting for a previous tween to complete
+	 */
+	GFraMe_tweener_waiting    = 0x01,
+	/**
+	 * The delay already elapsed (and the initial value was set)
+	 */
+	GFraMe_tweener_started    = 0x02,
+	/**
+	 * Read the initial value from the target when starting
+	 */
+	GFraMe_tweener_from_cur   = 0x04
+};
+
+/**
+ * A tween, as stored on the pool
+ */
+struct stGFraMe_tweener_item {
+	/**
+	 * What is modified (a float, an int or a GFraMe_object)
+	 */
+	void *target;
+	/**
+	 * Initial and final values (the second one is only used by objects)
+	 */
+	float from[2];
+	float to[2];
+	/**
+	 * Time elapsed since it started (negative while delayed)
+	 */
+	int time;
+	/**
+	 * How long the tween lasts, in milliseconds
+	 */
+	int duration;
+	/**
+	 * Tween started when this one completes (or 0)
+	 */
+	GFraMe_tweener_handle next;
+	/**
+	 * Step on which it was started by a chain
+	 */
+	unsigned int woken;
+	unsigned char ease;
+	unsigned char type;
+	unsigned char flags;
+};
+typedef struct stGFraMe_tweener_item GFraMe_tweener_item;
+
+/**
+ * Easing tables, built on the first GFraMe_tweener_init
+ */
+static float _GFraMe_tweener_lut[GFraMe_tweener_num_eases]
+								[GFraMe_tweener_lut_size + 1];
+/**
+ * Whether the tables were already built
+ */
+static int _GFraMe_tweener_lut_ready = 0;
+
+/**
+ * Calculate an easing curve (used to build the tables)
+ * @param	ease	The curve
+ * @param	t	Progress, from 0.0 to 1.0
+ * @return	The eased progress
+ */
+static double GFraMe_tweener_calc_ease(GFraMe_tweener_ease ease, double t);
+
+/**
+ * Calculate the bounce out curve
+ * @param	t	Progress, from 0.0 to 1.0
+ * @return	The eased progress
+ */
+static double GFraMe_tweener_calc_bounce(double t);
+
+/**
+ * Add a new tween
+ * @param	*tw	The tweener
+ * @param	*handle	Returns the tween's handle (may be NULL)
+ * @param	*target	What is modified
+ * @param	type	Type of the target
+ * @param	duration	How long the tween lasts, in milliseconds
+ * @param	ease	Easing curve
+ * @param	**item	Returns the tween
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - The tweener is full
+ */
+static GFraMe_ret GFraMe_tweener_new(GFraMe_tweener *tw,
+									 GFraMe_tweener_handle *handle,
+									 void *target, int type, int duration,
+									 GFraMe_tweener_ease ease,
+									 GFraMe_tweener_item **item);
+
+/**
+ * Write a tween's current value to its target
+ * @param	*item	The tween
+ * @return	1 - The tween completed; 0 - Otherwise
+ */
+static int GFraMe_tweener_apply(GFraMe_tweener_item *item);
+
+GFraMe_ret GFraMe_tweener_init(GFraMe_tweener *tw, int max) {
+	GFraMe_ret rv;
+
+	if (!_GFraMe_tweener_lut_ready) {
+		int ease;
+
+		ease = 0;
+		while (ease < GFraMe_tweener_num_eases) {
+			int i = 0;
+			while (i <= GFraMe_tweener_lut_size) {
+				_GFraMe_tweener_lut[ease][i] = (float)GFraMe_tweener_calc_ease(
+							(GFraMe_tweener_ease)ease,
+							(double)i / GFraMe_tweener_lut_size);
+				i++;
+			}
+			ease++;
+		}
+		_GFraMe_tweener_lut_ready = 1;
+	}
+	tw->step = 0;
+	rv = GFraMe_pool_init(&tw->tweens, sizeof(GFraMe_tweener_item), max);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init tweens", _ret);
+_ret:
+	return rv;
+}
+
+void GFraMe_tweener_clear(GFraMe_tweener *tw) {
+	GFraMe_pool_clear(&tw->tweens);
+}
+
+void GFraMe_tweener_reset(GFraMe_tweener *tw) {
+	GFraMe_pool_reset(&tw->tweens);
+}
+
+GFraMe_ret GFraMe_tweener_add(GFraMe_tweener *tw, GFraMe_tweener_handle *handle,
+							  float *target, float from, float to,
+							  int duration, GFraMe_tweener_ease ease) {
+	GFraMe_tweener_item *item;
+	GFraMe_ret rv;
+
+	rv = GFraMe_tweener_new(tw, handle, target, GFraMe_tweener_float_type,
+							duration, ease, &item);
+	if (rv != GFraMe_ret_ok)
+		return rv;
+	item->from[0] = from;
+	item->to[0] = to;
+	return GFraMe_ret_ok;
+}
+
+GFraMe_ret GFraMe_tweener_add_int(GFraMe_tweener *tw,
+								  GFraMe_tweener_handle *handle, int *target,
+								  int from, int to, int duration,
+								  GFraMe_tweener_ease ease) {
+	GFraMe_tweener_item *item;
+	GFraMe_ret rv;
+
+	rv = GFraMe_tweener_new(tw, handle, target, GFraMe_tweener_int_type,
+							duration, ease, &item);
+	if (rv != GFraMe_ret_ok)
+		return rv;
+	item->from[0] = (float)from;
+	item->to[0] = (float)to;
+	return GFraMe_ret_ok;
+}
+
+GFraMe_ret GFraMe_tweener_add_obj(GFraMe_tweener *tw,
+								  GFraMe_tweener_handle *handle,
+								  GFraMe_object *obj, int x, int y,
+								  int duration, GFraMe_tweener_ease ease) {
+	GFraMe_tweener_item *item;
+	GFraMe_ret rv;
+
+	rv = GFraMe_tweener_new(tw, handle, obj, GFraMe_tweener_obj_type,
+							duration, ease, &item);
+	if (rv != GFraMe_ret_ok)
+		return rv;
+	item->to[0] = (float)x;
+	item->to[1] = (float)y;
+	item->flags |= GFraMe_tweener_from_cur;
+	return GFraMe_ret_ok;
+}
+
+void GFraMe_tweener_from_current(GFraMe_tweener *tw,
+								 GFraMe_tweener_handle handle) {
+	GFraMe_tweener_item *item;
+
+	item = (GFraMe_tweener_item*)GFraMe_pool_get(&tw->tweens, handle);
+	if (item)
+		item->flags |= GFraMe_tweener_from_cur;
+}
+
+void GFraMe_tweener_set_delay(GFraMe_tweener *tw, GFraMe_tweener_handle handle,
+							  int delay) {
+	GFraMe_tweener_item *item;
+
+	item = (GFraMe_tweener_item*)GFraMe_pool_get(&tw->tweens, handle);
+	if (item && !(item->flags & GFraMe_tweener_started))
+		item->time = -delay;
+}
+
+GFraMe_ret GFraMe_tweener_chain(GFraMe_tweener *tw, GFraMe_tweener_handle prev,
+								GFraMe_tweener_handle next) {
+	GFraMe_tweener_item *prev_item, *next_item;
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	prev_item = (GFraMe_tweener_item*)GFraMe_pool_get(&tw->tweens, prev);
+	next_item = (GFraMe_tweener_item*)GFraMe_pool_get(&tw->tweens, next);
+	GFraMe_assertRV(prev_item && next_item && prev != next, "Invalid tweens",
+					rv = GFraMe_ret_bad_param, _ret);
+	GFraMe_assertRV(prev_item->next == 0
+					&& !(next_item->flags & GFraMe_tweener_waiting),
+					"Tween already chained", rv = GFraMe_ret_bad_param, _ret);
+	GFraMe_assertRV(!(next_item->flags & GFraMe_tweener_started),
+					"Tween already running", rv = GFraMe_ret_bad_param, _ret);
+	// Chaining back into any tween before it would never let the chain end
+	while (next_item) {
+		GFraMe_assertRV(next_item != prev_item, "Tweens would loop",
+						rv = GFraMe_ret_bad_param, _ret);
+		next_item = (GFraMe_tweener_item*)GFraMe_pool_get(&tw->tweens,
+														  next_item->next);
+	}
+	next_item = (GFraMe_tweener_item*)GFraMe_pool_get(&tw->tweens, next);
+	prev_item->next = next;
+	next_item->flags |= GFraMe_tweener_waiting;
+_ret:
+	return rv;
+}
+
+void GFraMe_tweener_stop(GFraMe_tweener *tw, GFraMe_tweener_handle handle) {
+	GFraMe_tweener_item *item;
+
+	// Released tweens' handles become stale, so the whole chain is released
+	item = (GFraMe_tweener_item*)GFraMe_pool_get(&tw->tweens, handle);
+	while (item) {
+		GFraMe_tweener_handle next;
+
+		next = item->next;
+		GFraMe_pool_release(&tw->tweens, handle);
+		handle = next;
+		item = (GFraMe_tweener_item*)GFraMe_pool_get(&tw->tweens, handle);
+	}
+}
+
+void GFraMe_tweener_update(GFraMe_tweener *tw, int ms) {
+	GFraMe_pool *pool;
+	int i;
+
+	pool = &tw->tweens;
+	tw->step++;
+	i = 0;
+	while (i < pool->len) {
+		GFraMe_tweener_item *item;
+
+		item = (GFraMe_tweener_item*)GFraMe_pool_at(pool, i);
+		if ((item->flags & GFraMe_tweener_waiting)
+			|| item->woken == tw->step) {
+			i++;
+			continue;
+		}
+		item->time += ms;
+		if (!GFraMe_tweener_apply(item)) {
+			i++;
+			continue;
+		}
+		// Start the next tween with whatever time is left
+		if (item->next) {
+			GFraMe_tweener_item *next;
+
+			next = (GFraMe_tweener_item*)GFraMe_pool_get(pool, item->next);
+			if (next) {
+				next->flags &= ~GFraMe_tweener_waiting;
+				next->time += item->time - item->duration;
+				next->woken = tw->step;
+				GFraMe_tweener_apply(next);
+			}
+		}
+		// The last tween is moved here, so don't advance
+		GFraMe_pool_release_at(pool, i);
+	}
+}
+
+int GFraMe_tweener_is_active(GFraMe_tweener *tw, GFraMe_tweener_handle handle) {
+	return GFraMe_pool_get(&tw->tweens, handle) != 0;
+}
+
+float GFraMe_tweener_ease_at(GFraMe_tweener_ease ease, float t) {
+	float *lut, pos;
+	int i;
+
+	if (t <= 0.0f)
+		return 0.0f;
+	else if (t >= 1.0f)
+		return 1.0f;
+	lut = _GFraMe_tweener_lut[ease];
+	pos = t * GFraMe_tweener_lut_size;
+	i = (int)pos;
+	return lut[i] + (lut[i + 1] - lut[i]) * (pos - (float)i);
+}
+
+/**
+ * Calculate an easing curve (used to build the tables)
+ * @param	ease	The curve
+ * @param	t	Progress, from 0.0 to 1.0
+ * @return	The eased progress
+ */
+static double GFraMe_tweener_calc_ease(GFraMe_tweener_ease ease, double t) {
+	// Period of the elastic curves
+	const double c4 = (2.0 * M_PI) / 3.0;
+
+	switch (ease) {
+		case GFraMe_tweener_quad_in: return t * t;
+		case GFraMe_tweener_quad_out: return 1.0 - (1.0 - t) * (1.0 - t);
+		case GFraMe_tweener_quad_inout:
+			if (t < 0.5)
+				return 2.0 * t * t;
+			return 1.0 - pow(-2.0 * t + 2.0, 2.0) / 2.0;
+		case GFraMe_tweener_cubic_in: return t * t * t;
+		case GFraMe_tweener_cubic_out: return 1.0 - pow(1.0 - t, 3.0);
+		case GFraMe_tweener_cubic_inout:
+			if (t < 0.5)
+				return 4.0 * t * t * t;
+			return 1.0 - pow(-2.0 * t + 2.0, 3.0) / 2.0;
+		case GFraMe_tweener_elastic_in:
+			if (t <= 0.0 || t >= 1.0)
+				return t;
+			return -pow(2.0, 10.0 * t - 10.0) * sin((t * 10.0 - 10.75) * c4);
+		case GFraMe_tweener_elastic_out:
+			if (t <= 0.0 || t >= 1.0)
+				return t;
+			return pow(2.0, -10.0 * t) * sin((t * 10.0 - 0.75) * c4) + 1.0;
+		case GFraMe_tweener_bounce_in:
+			return 1.0 - GFraMe_tweener_calc_bounce(1.0 - t);
+		case GFraMe_tweener_bounce_out:
+			return GFraMe_tweener_calc_bounce(t);
+		default: return t;
+	}
+}
+
+/**
+ * Calculate the bounce out curve
+ * @param	t	Progress, from 0.0 to 1.0
+ * @return	The eased progress
+ */
+static double GFraMe_tweener_calc_bounce(double t) {
+	const double n1 = 7.5625;
+	const double d1 = 2.75;
+
+	if (t < 1.0 / d1)
+		return n1 * t * t;
+	else if (t < 2.0 / d1) {
+		t -= 1.5 / d1;
+		return n1 * t * t + 0.75;
+	}
+	else if (t < 2.5 / d1) {
+		t -= 2.25 / d1;
+		return n1 * t * t + 0.9375;
+	}
+	t -= 2.625 / d1;
+	return n1 * t * t + 0.984375;
+}
+
+/**
+ * Add a new tween
+ * @param	*tw	The tweener
+ * @param	*handle	Returns the tween's handle (may be NULL)
+ * @param	*target	What is modified
+ * @param	type	Type of the target
+ * @param	duration	How long the tween lasts, in milliseconds
+ * @param	ease	Easing curve
+ * @param	**item	Returns the tween
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - The tweener is full
+ */
+static GFraMe_ret GFraMe_tweener_new(GFraMe_tweener *tw,
+									 GFraMe_tweener_handle *handle,
+									 void *target, int type, int duration,
+									 GFraMe_tweener_ease ease,
+									 GFraMe_tweener_item **item) {
+	GFraMe_tweener_item *tmp;
+	GFraMe_ret rv;
+	void *mem;
+
+	rv = GFraMe_pool_acquire(&tw->tweens, handle, &mem);
+	if (rv != GFraMe_ret_ok)
+		return rv;
+	tmp = (GFraMe_tweener_item*)mem;
+	tmp->target = target;
+	tmp->from[0] = 0.0f;
+	tmp->from[1] = 0.0f;
+	tmp->to[0] = 0.0f;
+	tmp->to[1] = 0.0f;
+	tmp->time = 0;
+	tmp->duration = duration;
+	tmp->next = 0;
+	tmp->woken = 0;
+	if (ease < 0 || ease >= GFraMe_tweener_num_eases)
+		ease = GFraMe_tweener_linear;
+	tmp->ease = (unsigned char)ease;
+	tmp->type = (unsigned char)type;
+	tmp->flags = 0;
+	*item = tmp;
+	return GFraMe_ret_ok;
+}
+
+/**
+ * Write a tween's current value to its target
+ * @param	*item	The tween
+ * @return	1 - The tween completed; 0 - Otherwise
+ */
+static int GFraMe_tweener_apply(GFraMe_tweener_item *item) {
+	float t;
+	int done;
+
+	// Still delayed
+	if (item->time < 0)
+		return 0;
+	if (!(item->flags & GFraMe_tweener_started)) {
+		item->flags |= GFraMe_tweener_started;
+		if (item->flags & GFraMe_tweener_from_cur) {
+			switch (item->type) {
+				case GFraMe_tweener_float_type:
+					item->from[0] = *(float*)item->target;
+				break;
+				case GFraMe_tweener_int_type:
+					item->from[0] = (float)*(int*)item->target;
+				break;
+				default: {
+					GFraMe_object *obj = (GFraMe_object*)item->target;
+					item->from[0] = (float)obj->x;
+					item->from[1] = (float)obj->y;
+				}
+			}
+		}
+	}
+	done = (item->time >= item->duration);
+	if (done)
+		t = 1.0f;
+	else
+		t = GFraMe_tweener_ease_at((GFraMe_tweener_ease)item->ease,
+								   (float)item->time / item->duration);
+	switch (item->type) {
+		case GFraMe_tweener_float_type:
+			if (done)
+				*(float*)item->target = item->to[0];
+			else
+				*(float*)item->target = item->from[0]
+										+ (item->to[0] - item->from[0]) * t;
+		break;
+		case GFraMe_tweener_int_type:
+			*(int*)item->target = (int)floorf(item->from[0]
+									+ (item->to[0] - item->from[0]) * t + 0.5f);
+		break;
+		default:
+			GFraMe_object_set_pos((GFraMe_object*)item->target,
+								  (int)floorf(item->from[0]
+									+ (item->to[0] - item->from[0]) * t + 0.5f),
+								  (int)floorf(item->from[1]
+									+ (item->to[1] - item->from[1]) * t + 0.5f));
+	}
+	return done;
+}
+
@@ -0,0 +1,171 @@
+/**
+ * @src/gframe_workers.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_workers.h>
+#include <SDL2/SDL_cpuinfo.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+
+static SDL_Thread *threads[GFraMe_workers_max];
+static int num_threads = 0;
+static SDL_mutex *mutex = NULL;
+static SDL_cond *start_cond = NULL;
+static SDL_cond *done_cond = NULL;
+/** Incremented on every new job, so workers know when to run */
+static int generation;
+/** How many workers are still running the current job */
+static int pending;
+static int quit;
+static GFraMe_workers_func job_func;
+static void *job_ctx;
+static int job_count;
+static int job_chunks;
+
+static int GFraMe_workers_thread(void *arg);
+static void GFraMe_workers_run_chunk(int chunk);
+
+GFraMe_ret GFraMe_workers_init(int num) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	GFraMe_assertRV(num_threads == 0, "Workers already initialized",
+					rv = GFraMe_ret_failed, _ret);
+	if (num <= 0)
+		num = SDL_GetCPUCount() - 1;
+	if (num > GFraMe_workers_max)
+		num = GFraMe_workers_max;
+	if (num <= 0)
+		goto _ret;
+
+	mutex = SDL_CreateMutex();
+	GFraMe_SDLassertRV(mutex, "Failed to create mutex",
+					   rv = GFraMe_ret_failed, _ret);
+	start_cond = SDL_CreateCond();
+	GFraMe_SDLassertRV(start_cond, "Failed to create cond",
+					   rv = GFraMe_ret_failed, _ret);
+	done_cond = SDL_CreateCond();
+	GFraMe_SDLassertRV(done_cond, "Failed to create cond",
+					   rv = GFraMe_ret_failed, _ret);
+	generation = 0;
+	pending = 0;
+	quit = 0;
+	while (num_threads < num) {
+		// Each thread receives its chunk's index (0 is the caller's)
+		threads[num_threads] = SDL_CreateThread(GFraMe_workers_thread,
+						"GFraMe_worker", (void*)(long)(num_threads + 1));
+		GFraMe_SDLassertRV(threads[num_threads], "Failed to create thread",
+						   rv = GFraMe_ret_failed, _ret);
+		num_threads++;
+	}
+	GFraMe_new_log("Spawned %i worker threads", num_threads);
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_workers_clear();
+	return rv;
+}
+
+void GFraMe_workers_clear() {
+	int i;
+
+	if (num_threads > 0) {
+		SDL_LockMutex(mutex);
+		quit = 1;
+		SDL_CondBroadcast(start_cond);
+		SDL_UnlockMutex(mutex);
+		i = 0;
+		while (i < num_threads) {
+			SDL_WaitThread(threads[i], NULL);
+			i++;
+		}
+		num_threads = 0;
+	}
+	if (done_cond)
+		SDL_DestroyCond(done_cond);
+	done_cond = NULL;
+	if (start_cond)
+		SDL_DestroyCond(start_cond);
+	start_cond = NULL;
+	if (mutex)
+		SDL_DestroyMutex(mutex);
+	mutex = NULL;
+}
+
+int GFraMe_workers_get_num() {
+	return num_threads + 1;
+}
+
+void GFraMe_workers_run(int count, GFraMe_workers_func func, void *ctx) {
+	int chunks;
+
+	if (count <= 0)
+		return;
+	// Don't bother waking the workers for small jobs
+	chunks = count / GFraMe_workers_min_items;
+	if (chunks > num_threads + 1)
+		chunks = num_threads + 1;
+	if (chunks <= 1) {
+		func(ctx, 0, count, 0);
+		return;
+	}
+
+	SDL_LockMutex(mutex);
+	job_func = func;
+	job_ctx = ctx;
+	job_count = count;
+	job_chunks = chunks;
+	pending = num_threads;
+	generation++;
+	SDL_CondBroadcast(start_cond);
+	SDL_UnlockMutex(mutex);
+
+	GFraMe_workers_run_chunk(0);
+
+	SDL_LockMutex(mutex);
+	while (pending > 0)
+		SDL_CondWait(done_cond, mutex);
+	SDL_UnlockMutex(mutex);
+}
+
+/**
+ * Run a chunk of the current job; the range only depends on the job's size
+ *and the number of chunks, so it's always the same for the same input
+ * @param	chunk	Index of the chunk
+ */
+static void GFraMe_workers_run_chunk(int chunk) {
+	int first, last;
+
+	if (chunk >= job_chunks)
+		return;
+	first = (int)((long long)job_count * chunk / job_chunks);
+	last = (int)((long long)job_count * (chunk + 1) / job_chunks);
+	if (first < last)
+		job_func(job_ctx, first, last, chunk);
+}
+
+static int GFraMe_workers_thread(void *arg) {
+	int chunk, last_gen;
+
+	chunk = (int)(long)arg;
+	last_gen = 0;
+	SDL_LockMutex(mutex);
+	while (1) {
+		// Wait for a new job (or for the pool to be released)
+		while (generation == last_gen && !quit)
+			SDL_CondWait(start_cond, mutex);
+		if (quit)
+			break;
+		last_gen = generation;
+		SDL_UnlockMutex(mutex);
+
+		GFraMe_workers_run_chunk(chunk);
+
+		SDL_LockMutex(mutex);
+		pending--;
+		if (pending == 0)
+			SDL_CondSignal(done_cond);
+	}
+	SDL_UnlockMutex(mutex);
+	return 0;
+}
+
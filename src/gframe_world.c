@@ -0,0 +1,1295 @@
+/**
+ * @src/gframe_world.c
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_raycast.h>
+#include <GFraMe/GFraMe_workers.h>
+#include <GFraMe/GFraMe_world.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Context for jobs split across workers
+ */
+struct stGFraMe_world_job {
+	GFraMe_world *world;
+	/** Offset of the job's first item (i.e., objects on a grid) */
+	int first;
+	/** How long the frame took (when updating) */
+	int ms;
+};
+typedef struct stGFraMe_world_job GFraMe_world_job;
+
+/**
+ * Make sure a buffer has, at least, the requested number of items; it grows
+ *to double the needed size, to avoid reallocating too often
+ * @param	**buf	The buffer (may point to NULL)
+ * @param	*max	How many items the buffer currently holds
+ * @param	needed	How many items are needed
+ * @param	size	Size of each item
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_grow(void **buf, int *max, int needed,
+									int size);
+
+/**
+ * Get the index of a category's first layer
+ * @param	category	Bitfield of layers
+ * @return	The first layer or -1, if it's on none
+ */
+static int GFraMe_world_get_layer(unsigned int category);
+
+/**
+ * Move every sleeping object that was woken (or that started moving) to the
+ *awake objects
+ * @param	*world	The world
+ */
+static void GFraMe_world_wake_objects(GFraMe_world *world);
+
+/**
+ * Swap two objects on the world's list
+ * @param	*world	The world
+ * @param	i	Index of one of the objects
+ * @param	j	Index of the other object
+ */
+static void GFraMe_world_swap(GFraMe_world *world, int i, int j);
+
+/**
+ * Spread a range of objects on a grid
+ * @param	*world	The world
+ * @param	*grid	The grid
+ * @param	first	Index of the first object
+ * @param	last	Index after the last object
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_fill_grid(GFraMe_world *world,
+										 GFraMe_world_grid *grid, int first,
+										 int last);
+
+/**
+ * Add a pair that may overlap, if their layers match and this is the first
+ *cell they share
+ * @param	*world	The world
+ * @param	*chunk	Worker's list of pairs
+ * @param	i	Index of one of the objects
+ * @param	j	Index of the other object
+ * @param	cell	Cell where they were found
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_add_pair(GFraMe_world *world,
+										GFraMe_world_chunk *chunk, int i,
+										int j, int cell);
+
+/**
+ * Update a range of awake objects
+ * @param	*ctx	The job (GFraMe_world_job)
+ * @param	first	First object
+ * @param	last	Object after the last one
+ * @param	chunk	Worker's chunk
+ */
+static void GFraMe_world_update_range(void *ctx, int first, int last,
+									  int chunk);
+
+/**
+ * Calculate the cells occupied by a range of objects
+ * @param	*ctx	The job (GFraMe_world_job)
+ * @param	first	First object (relative to the job's first)
+ * @param	last	Object after the last one
+ * @param	chunk	Worker's chunk
+ */
+static void GFraMe_world_cells_range(void *ctx, int first, int last,
+									 int chunk);
+
+/**
+ * List the pairs of awake objects on a range of cells
+ * @param	*ctx	The job (GFraMe_world_job)
+ * @param	first	First cell
+ * @param	last	Cell after the last one
+ * @param	chunk	Worker's chunk
+ */
+static void GFraMe_world_awake_pairs_range(void *ctx, int first, int last,
+										   int chunk);
+
+/**
+ * Pair a range of awake objects with the sleeping ones on their cells
+ * @param	*ctx	The job (GFraMe_world_job)
+ * @param	first	First awake object
+ * @param	last	Object after the last one
+ * @param	chunk	Worker's chunk
+ */
+static void GFraMe_world_asleep_pairs_range(void *ctx, int first, int last,
+											int chunk);
+
+/**
+ * Append every pair found by the workers, in order, to the world's list
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_merge_pairs(GFraMe_world *world);
+
+/**
+ * Find a pair on a contacts' set
+ * @param	*set	The set
+ * @param	*o1	One of the objects (with the lower address)
+ * @param	*o2	The other object
+ * @return	The pair's entry or an empty one, where it should be inserted
+ */
+static GFraMe_world_contact* GFraMe_world_find_contact(
+		GFraMe_world_contacts *set, GFraMe_object *o1, GFraMe_object *o2);
+
+/**
+ * Update the contacts with the overlaps from this step and report what
+ *changed since the last one
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_update_contacts(GFraMe_world *world);
+
+/**
+ * Rebuild any grid whose objects were moved around since the last step
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_refresh_grids(GFraMe_world *world);
+
+/**
+ * Cast a segment against every object on a grid's cell, keeping the closest
+ *hit
+ * @param	*world	The world
+ * @param	*grid	The grid
+ * @param	cell	The cell
+ * @param	*hit	Closest hit so far
+ * @param	*seg	The segment (x0, y0, x1, y1)
+ * @param	mask	Bitfield of layers that may be hit
+ */
+static void GFraMe_world_raycast_cell(GFraMe_world *world,
+									  GFraMe_world_grid *grid, int cell,
+									  GFraMe_raycast_hit *hit, double *seg,
+									  unsigned int mask);
+
+/**
+ * List every pair that may overlap; sleeping objects are only paired with
+ *awake ones
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_broadphase(GFraMe_world *world);
+
+/**
+ * Collide every pair listed by the broadphase
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_collide(GFraMe_world *world);
+
+/**
+ * Initialize a collision world; by default, every pair of layers only set
+ *the objects' flags (i.e., GFraMe_dont_collide) and objects sleep after
+ *GFraMe_world_default_sleep_time ms at rest
+ * @param	*world	World to be initialized
+ * @param	x	Grid's horizontal position
+ * @param	y	Grid's vertical position
+ * @param	w	Grid's width
+ * @param	h	Grid's height
+ * @param	cell_w	Each cell's width
+ * @param	cell_h	Each cell's height
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_world_init(GFraMe_world *world, int x, int y, int w, int h,
+							 int cell_w, int cell_h) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int num_cells;
+
+	// Init every alloc'ed pointer with NULL
+	world->objs = NULL;
+	world->awake.cell_start = NULL;
+	world->awake.cell_items = NULL;
+	world->asleep.cell_start = NULL;
+	world->asleep.cell_items = NULL;
+	world->obj_cells = NULL;
+	world->pairs = NULL;
+	world->overlaps = NULL;
+	world->chunks = NULL;
+	world->num_chunks = 0;
+	world->contacts[0].entries = NULL;
+	world->contacts[0].len = 0;
+	world->contacts[0].count = 0;
+	world->contacts[1].entries = NULL;
+	world->contacts[1].len = 0;
+	world->contacts[1].count = 0;
+	world->cur_contacts = 0;
+	world->events = NULL;
+	world->num_events = 0;
+	world->max_events = 0;
+	world->num_objs = 0;
+	world->num_awake = 0;
+	world->max_objs = 0;
+	world->awake.max_items = 0;
+	world->asleep.max_items = 0;
+	world->num_pairs = 0;
+	world->max_pairs = 0;
+	world->num_overlaps = 0;
+	world->max_overlaps = 0;
+	world->use_sweep = 0;
+	world->asleep_dirty = 1;
+	world->awake_dirty = 1;
+	world->sleep_time = GFraMe_world_default_sleep_time;
+	GFraMe_assertRV(w > 0 && h > 0 && cell_w > 0 && cell_h > 0,
+					"Invalid world dimensions", rv = GFraMe_ret_bad_param,
+					_ret);
+	// Set the grid's dimensions
+	world->x = x;
+	world->y = y;
+	world->cell_w = cell_w;
+	world->cell_h = cell_h;
+	world->columns = (w + cell_w - 1) / cell_w;
+	world->rows = (h + cell_h - 1) / cell_h;
+	// Alloc the cells (there's an extra one, to mark the last one's end)
+	num_cells = world->columns * world->rows + 1;
+	world->awake.cell_start = (int*)malloc(sizeof(int) * num_cells);
+	GFraMe_assertRV(world->awake.cell_start, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	world->asleep.cell_start = (int*)malloc(sizeof(int) * num_cells);
+	GFraMe_assertRV(world->asleep.cell_start, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	// Every layer only flags overlaps
+	memset(world->responses, GFraMe_dont_collide, sizeof(world->responses));
+_ret:
+	if (rv != GFraMe_ret_ok)
+		GFraMe_world_clear(world);
+	return rv;
+}
+
+/**
+ * Clean up memory allocated by the world; the objects aren't touched
+ * @param	*world	The world
+ */
+void GFraMe_world_clear(GFraMe_world *world) {
+	#define FREE(buf) \
+		do { \
+			if (buf) \
+				free(buf); \
+			buf = NULL; \
+		} while (0)
+	FREE(world->objs);
+	FREE(world->awake.cell_start);
+	FREE(world->awake.cell_items);
+	FREE(world->asleep.cell_start);
+	FREE(world->asleep.cell_items);
+	FREE(world->obj_cells);
+	FREE(world->pairs);
+	FREE(world->overlaps);
+	while (world->num_chunks > 0) {
+		world->num_chunks--;
+		FREE(world->chunks[world->num_chunks].pairs);
+	}
+	FREE(world->chunks);
+	FREE(world->contacts[0].entries);
+	FREE(world->contacts[1].entries);
+	FREE(world->events);
+	#undef FREE
+	world->contacts[0].len = 0;
+	world->contacts[0].count = 0;
+	world->contacts[1].len = 0;
+	world->contacts[1].count = 0;
+	world->num_events = 0;
+	world->max_events = 0;
+	world->num_objs = 0;
+	world->num_awake = 0;
+	world->max_objs = 0;
+	world->awake.max_items = 0;
+	world->asleep.max_items = 0;
+	world->num_pairs = 0;
+	world->max_pairs = 0;
+	world->num_overlaps = 0;
+	world->max_overlaps = 0;
+	world->asleep_dirty = 1;
+	world->awake_dirty = 1;
+}
+
+/**
+ * Add an object to the world; it must be kept alive until removed
+ * @param	*world	The world
+ * @param	*obj	The object
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_world_add(GFraMe_world *world, GFraMe_object *obj) {
+	GFraMe_ret rv;
+	int max;
+
+	// Expand both the objects list and its cells' list
+	max = world->max_objs;
+	rv = GFraMe_world_grow((void**)&world->objs, &world->max_objs,
+						   world->num_objs + 1, sizeof(GFraMe_object*));
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to add object", _ret);
+	if (max != world->max_objs) {
+		int *tmp;
+
+		tmp = (int*)realloc(world->obj_cells,
+							sizeof(int) * 4 * world->max_objs);
+		// Only the objects list fits more objects, so keep the old limit
+		// (otherwise, the next add would write past the cells' list)
+		if (!tmp)
+			world->max_objs = max;
+		GFraMe_assertRV(tmp, "Failed to alloc memory",
+						rv = GFraMe_ret_memory_error, _ret);
+		world->obj_cells = tmp;
+	}
+	// Add it with the sleeping ones; if it's awake, it will be moved on the
+	// next step
+	world->objs[world->num_objs] = obj;
+	world->num_objs++;
+	world->asleep_dirty = 1;
+	rv = GFraMe_ret_ok;
+_ret:
+	return rv;
+}
+
+/**
+ * Remove an object from the world; its contacts are dropped without any
+ *event
+ * @param	*world	The world
+ * @param	*obj	The object
+ * @return	GFraMe_ret_ok - Success; GFraMe_ret_failed - Object not found
+ */
+GFraMe_ret GFraMe_world_remove(GFraMe_world *world, GFraMe_object *obj) {
+	GFraMe_world_contacts *set;
+	int i;
+
+	// Drop its contacts (they are kept on the set, so probing still works)
+	set = world->contacts + world->cur_contacts;
+	i = 0;
+	while (i < set->len) {
+		if (set->entries[i].o1 == obj || set->entries[i].o2 == obj)
+			set->entries[i].seen = -1;
+		i++;
+	}
+	i = 0;
+	while (i < world->num_objs) {
+		if (world->objs[i] == obj) {
+			// Keep both lists packed, moving the last of each into the slot
+			if (i < world->num_awake) {
+				world->num_awake--;
+				GFraMe_world_swap(world, i, world->num_awake);
+				i = world->num_awake;
+			}
+			world->num_objs--;
+			GFraMe_world_swap(world, i, world->num_objs);
+			world->asleep_dirty = 1;
+			world->awake_dirty = 1;
+			return GFraMe_ret_ok;
+		}
+		i++;
+	}
+	return GFraMe_ret_failed;
+}
+
+/**
+ * Set how objects on two layers collide; the response is mirrored for the
+ *inverse pair (e.g., GFraMe_first_fixed becomes GFraMe_second_fixed)
+ * @param	*world	The world
+ * @param	layer1	Index of the first layer (i.e., its bit on the category)
+ * @param	layer2	Index of the second layer
+ * @param	mode	How they should collide
+ */
+void GFraMe_world_set_response(GFraMe_world *world, int layer1, int layer2,
+							   GFraMe_collision_type mode) {
+	GFraMe_collision_type inv;
+
+	if (layer1 < 0 || layer1 >= GFraMe_world_max_layers ||
+		layer2 < 0 || layer2 >= GFraMe_world_max_layers)
+		return;
+	// Get the response as seen from the second layer
+	switch (mode) {
+		case GFraMe_first_fixed:  inv = GFraMe_second_fixed; break;
+		case GFraMe_second_fixed: inv = GFraMe_first_fixed; break;
+		default: inv = mode;
+	}
+	world->responses[layer1*GFraMe_world_max_layers + layer2] = mode;
+	world->responses[layer2*GFraMe_world_max_layers + layer1] = inv;
+}
+
+/**
+ * Set whether the objects should be swept, avoiding tunneling
+ * @param	*world	The world
+ * @param	use_sweep	Whether GFraMe_object_sweep should be used
+ */
+void GFraMe_world_set_sweep(GFraMe_world *world, int use_sweep) {
+	world->use_sweep = use_sweep;
+	// Sleeping objects' cells depend on this
+	world->asleep_dirty = 1;
+}
+
+/**
+ * Set for how long objects must be at rest before sleeping
+ * @param	*world	The world
+ * @param	ms	Time, in milliseconds (0 or less never puts objects to sleep)
+ */
+void GFraMe_world_set_sleep_time(GFraMe_world *world, int ms) {
+	world->sleep_time = ms;
+}
+
+/**
+ * Collide every pair of objects that may overlap; every overlap is stored on
+ *the world's overlaps list. Sleeping objects aren't collided against each
+ *other, but are woken when an awake object overlaps them
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_world_step(GFraMe_world *world) {
+	GFraMe_world_wake_objects(world);
+	return GFraMe_world_collide(world);
+}
+
+/**
+ * Update every awake object, collide them (as GFraMe_world_step) and put to
+ *sleep the ones that have been at rest for long enough
+ * @param	*world	The world
+ * @param	ms	How long this frame took
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+GFraMe_ret GFraMe_world_update(GFraMe_world *world, int ms) {
+	GFraMe_world_job job;
+	GFraMe_ret rv;
+	int i;
+
+	GFraMe_world_wake_objects(world);
+	// Only awake objects are updated
+	job.world = world;
+	job.first = 0;
+	job.ms = ms;
+	GFraMe_workers_run(world->num_awake, GFraMe_world_update_range, &job);
+	rv = GFraMe_world_collide(world);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to collide objects", _ret);
+	if (world->sleep_time <= 0)
+		goto _ret;
+	// Put to sleep every object that has been at rest for long enough (note
+	// that any contact resets the time at rest)
+	i = 0;
+	while (i < world->num_awake) {
+		GFraMe_object *obj = world->objs[i];
+
+		if (GFraMe_object_is_idle(obj)) {
+			obj->idle_time += ms;
+			if (obj->idle_time >= world->sleep_time) {
+				obj->sleeping = 1;
+				world->num_awake--;
+				GFraMe_world_swap(world, i, world->num_awake);
+				world->asleep_dirty = 1;
+				world->awake_dirty = 1;
+				// Check the object that took its place
+				continue;
+			}
+		}
+		else
+			obj->idle_time = 0;
+		i++;
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Cast a segment against every object on the world; objects are looked up
+ *on the cells they occupied on the last step (and only the part of the
+ *segment inside the grid is checked)
+ * @param	*world	The world
+ * @param	*hit	Returns the first object hit
+ * @param	x0	Segment's horizontal start
+ * @param	y0	Segment's vertical start
+ * @param	x1	Segment's horizontal end
+ * @param	y1	Segment's vertical end
+ * @param	mask	Bitfield of layers that may be hit
+ * @return	GFraMe_ret_ok - Hit; GFraMe_ret_no_overlap - Missed; Anything
+ *			else - Failure
+ */
+GFraMe_ret GFraMe_world_raycast(GFraMe_world *world, GFraMe_raycast_hit *hit,
+								double x0, double y0, double x1, double y1,
+								unsigned int mask) {
+	GFraMe_raycast_dda dda;
+	double seg[4];
+	GFraMe_ret rv;
+
+	hit->did_hit = 0;
+	rv = GFraMe_world_refresh_grids(world);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to refresh grids", _ret);
+	rv = GFraMe_raycast_dda_init(&dda, x0 - world->x, y0 - world->y,
+								 x1 - world->x, y1 - world->y, world->cell_w,
+								 world->cell_h, world->columns, world->rows);
+	if (rv != GFraMe_ret_ok)
+		goto _ret;
+	seg[0] = x0;
+	seg[1] = y0;
+	seg[2] = x1;
+	seg[3] = y1;
+	// Visit the cells in order, stopping as soon as no closer hit is possible
+	do {
+		int c;
+
+		if (hit->did_hit && dda.t > hit->t)
+			break;
+		c = dda.cy*world->columns + dda.cx;
+		GFraMe_world_raycast_cell(world, &world->awake, c, hit, seg, mask);
+		GFraMe_world_raycast_cell(world, &world->asleep, c, hit, seg, mask);
+	} while (GFraMe_raycast_dda_next(&dda));
+	if (hit->did_hit)
+		rv = GFraMe_ret_ok;
+	else
+		rv = GFraMe_ret_no_overlap;
+_ret:
+	return rv;
+}
+
+/**
+ * Cast many segments against every object on the world (e.g., a vision cone)
+ * @param	*world	The world
+ * @param	*hits	Returns each segment's hit (did_hit is 0 on misses)
+ * @param	*segs	Segments, as x0, y0, x1, y1 (4 values per segment)
+ * @param	num	How many segments there are
+ * @param	mask	Bitfield of layers that may be hit
+ * @return	How many segments hit an object
+ */
+int GFraMe_world_raycast_batch(GFraMe_world *world, GFraMe_raycast_hit *hits,
+							   double *segs, int num, unsigned int mask) {
+	int i, count;
+
+	count = 0;
+	i = 0;
+	while (i < num) {
+		if (GFraMe_world_raycast(world, hits + i, segs[0], segs[1], segs[2],
+								 segs[3], mask) == GFraMe_ret_ok)
+			count++;
+		segs += 4;
+		i++;
+	}
+	return count;
+}
+
+/**
+ * Cast a segment against every object on a grid's cell, keeping the closest
+ *hit
+ * @param	*world	The world
+ * @param	*grid	The grid
+ * @param	cell	The cell
+ * @param	*hit	Closest hit so far
+ * @param	*seg	The segment (x0, y0, x1, y1)
+ * @param	mask	Bitfield of layers that may be hit
+ */
+static void GFraMe_world_raycast_cell(GFraMe_world *world,
+									  GFraMe_world_grid *grid, int cell,
+									  GFraMe_raycast_hit *hit, double *seg,
+									  unsigned int mask) {
+	int i, end;
+
+	end = grid->cell_start[cell + 1];
+	i = grid->cell_start[cell];
+	while (i < end) {
+		GFraMe_raycast_hit tmp;
+		GFraMe_object *obj;
+		GFraMe_hitbox *hb;
+
+		obj = world->objs[grid->cell_items[i]];
+		hb = GFraMe_object_get_hitbox(obj);
+		if ((obj->category & mask) &&
+			GFraMe_raycast_aabb(&tmp, seg[0], seg[1], seg[2], seg[3],
+								obj->dx + hb->cx - hb->hw,
+								obj->dy + hb->cy - hb->hh,
+								obj->dx + hb->cx + hb->hw,
+								obj->dy + hb->cy + hb->hh) == GFraMe_ret_ok
+			&& (!hit->did_hit || tmp.t < hit->t)) {
+			*hit = tmp;
+			hit->obj = obj;
+			hit->tile_x = -1;
+			hit->tile_y = -1;
+		}
+		i++;
+	}
+}
+
+/**
+ * Rebuild any grid whose objects were moved around since the last step
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_refresh_grids(GFraMe_world *world) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+
+	if (world->asleep_dirty) {
+		rv = GFraMe_world_fill_grid(world, &world->asleep, world->num_awake,
+									world->num_objs);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to fill grid", _ret);
+		world->asleep_dirty = 0;
+	}
+	if (world->awake_dirty) {
+		rv = GFraMe_world_fill_grid(world, &world->awake, 0,
+									world->num_awake);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to fill grid", _ret);
+		world->awake_dirty = 0;
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Move every sleeping object that was woken (or that started moving) to the
+ *awake objects
+ * @param	*world	The world
+ */
+static void GFraMe_world_wake_objects(GFraMe_world *world) {
+	int i;
+
+	// Only flags are checked, so this is way cheaper than updating them
+	i = world->num_awake;
+	while (i < world->num_objs) {
+		GFraMe_object *obj = world->objs[i];
+
+		if (obj->is_static) {
+			// Static objects may only be repositioned
+			if (!obj->sleeping) {
+				obj->sleeping = 1;
+				world->asleep_dirty = 1;
+			}
+		}
+		else if (!obj->sleeping || !GFraMe_object_is_idle(obj)) {
+			GFraMe_object_wake(obj);
+			GFraMe_world_swap(world, i, world->num_awake);
+			world->num_awake++;
+			world->asleep_dirty = 1;
+			world->awake_dirty = 1;
+		}
+		i++;
+	}
+}
+
+/**
+ * Swap two objects on the world's list
+ * @param	*world	The world
+ * @param	i	Index of one of the objects
+ * @param	j	Index of the other object
+ */
+static void GFraMe_world_swap(GFraMe_world *world, int i, int j) {
+	GFraMe_object *tmp;
+
+	tmp = world->objs[i];
+	world->objs[i] = world->objs[j];
+	world->objs[j] = tmp;
+}
+
+/**
+ * Collide every pair listed by the broadphase
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_collide(GFraMe_world *world) {
+	GFraMe_ret rv;
+	int i;
+
+	world->num_overlaps = 0;
+	// Find every pair that may collide
+	rv = GFraMe_world_broadphase(world);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Broadphase failed", _ret);
+	// Make sure every pair fits on the overlaps list
+	rv = GFraMe_world_grow((void**)&world->overlaps, &world->max_overlaps,
+						   world->num_pairs, sizeof(GFraMe_world_pair));
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to alloc overlaps", _ret);
+	// Collide each pair, in the order they were found
+	i = 0;
+	while (i < world->num_pairs) {
+		GFraMe_collision_type mode;
+		GFraMe_object *o1, *o2;
+		int l1, l2;
+
+		o1 = world->objs[world->pairs[i*2]];
+		o2 = world->objs[world->pairs[i*2 + 1]];
+		l1 = GFraMe_world_get_layer(o1->category);
+		l2 = GFraMe_world_get_layer(o2->category);
+		mode = world->responses[l1*GFraMe_world_max_layers + l2];
+
+		if (world->use_sweep)
+			rv = GFraMe_object_sweep(o1, o2, mode);
+		else
+			rv = GFraMe_object_overlap(o1, o2, mode);
+		if (rv == GFraMe_ret_ok) {
+			world->overlaps[world->num_overlaps].o1 = o1;
+			world->overlaps[world->num_overlaps].o2 = o2;
+			world->num_overlaps++;
+		}
+		i++;
+	}
+	// Update the contacts before waking anything, so it's known which
+	// objects were sleeping during this step
+	rv = GFraMe_world_update_contacts(world);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to update contacts", _ret);
+	// Contacts keep objects awake (and wake sleeping ones); resting on a
+	// static object doesn't count, though
+	i = 0;
+	while (i < world->num_overlaps) {
+		GFraMe_object *o1, *o2;
+
+		o1 = world->overlaps[i].o1;
+		o2 = world->overlaps[i].o2;
+		if (!o1->is_static && !o2->is_static) {
+			GFraMe_object_wake(o1);
+			GFraMe_object_wake(o2);
+		}
+		i++;
+	}
+	rv = GFraMe_ret_ok;
+_ret:
+	return rv;
+}
+
+/**
+ * Update the contacts with the overlaps from this step and report what
+ *changed since the last one
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_update_contacts(GFraMe_world *world) {
+	GFraMe_world_contacts *last, *set;
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i, len;
+
+	last = world->contacts + world->cur_contacts;
+	set = world->contacts + (world->cur_contacts ^ 1);
+	world->num_events = 0;
+	// Every overlap and every contact may generate an event...
+	rv = GFraMe_world_grow((void**)&world->events, &world->max_events,
+						   world->num_overlaps + last->count,
+						   sizeof(GFraMe_world_event));
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to alloc events", _ret);
+	// ...and be kept; keep the set, at most, half full
+	len = 16;
+	while (len < (world->num_overlaps + last->count) * 2)
+		len *= 2;
+	if (set->len < len) {
+		GFraMe_world_contact *tmp;
+
+		tmp = (GFraMe_world_contact*)realloc(set->entries,
+											 sizeof(GFraMe_world_contact) * len);
+		GFraMe_assertRV(tmp, "Failed to alloc memory",
+						rv = GFraMe_ret_memory_error, _ret);
+		set->entries = tmp;
+		set->len = len;
+	}
+	memset(set->entries, 0x0, sizeof(GFraMe_world_contact) * set->len);
+	set->count = 0;
+	// Add every overlap, checking whether it already existed
+	i = 0;
+	while (i < world->num_overlaps) {
+		GFraMe_world_contact *entry;
+		GFraMe_world_event *ev;
+		GFraMe_object *o1, *o2;
+
+		// Always store the pair in the same order
+		o1 = world->overlaps[i].o1;
+		o2 = world->overlaps[i].o2;
+		if (o2 < o1) {
+			o1 = world->overlaps[i].o2;
+			o2 = world->overlaps[i].o1;
+		}
+		ev = world->events + world->num_events;
+		ev->o1 = o1;
+		ev->o2 = o2;
+		ev->type = GFraMe_world_contact_enter;
+		if (last->count > 0) {
+			entry = GFraMe_world_find_contact(last, o1, o2);
+			if (entry->o1 && entry->seen == 0) {
+				ev->type = GFraMe_world_contact_stay;
+				entry->seen = 1;
+			}
+		}
+		world->num_events++;
+		entry = GFraMe_world_find_contact(set, o1, o2);
+		entry->o1 = o1;
+		entry->o2 = o2;
+		set->count++;
+		i++;
+	}
+	// Every contact that wasn't found either ended or is between sleeping
+	// objects (which aren't collided)
+	i = 0;
+	while (i < last->len && last->count > 0) {
+		GFraMe_world_contact *entry = last->entries + i;
+
+		if (entry->o1 && entry->seen == 0) {
+			if (entry->o1->sleeping && entry->o2->sleeping) {
+				GFraMe_world_contact *copy;
+
+				copy = GFraMe_world_find_contact(set, entry->o1, entry->o2);
+				copy->o1 = entry->o1;
+				copy->o2 = entry->o2;
+				set->count++;
+			}
+			else {
+				GFraMe_world_event *ev = world->events + world->num_events;
+
+				ev->o1 = entry->o1;
+				ev->o2 = entry->o2;
+				ev->type = GFraMe_world_contact_exit;
+				world->num_events++;
+			}
+		}
+		i++;
+	}
+	world->cur_contacts ^= 1;
+_ret:
+	return rv;
+}
+
+/**
+ * Find a pair on a contacts' set
+ * @param	*set	The set
+ * @param	*o1	One of the objects (with the lower address)
+ * @param	*o2	The other object
+ * @return	The pair's entry or an empty one, where it should be inserted
+ */
+static GFraMe_world_contact* GFraMe_world_find_contact(
+		GFraMe_world_contacts *set, GFraMe_object *o1, GFraMe_object *o2) {
+	size_t hash;
+	int mask;
+
+	// Mix both addresses (ignoring the lower bits, which are mostly 0)
+	hash = ((size_t)o1 >> 3) * 0x9E3779B1u;
+	hash ^= ((size_t)o2 >> 3) + 0x7F4A7C15u + (hash << 6) + (hash >> 2);
+	mask = set->len - 1;
+	hash &= mask;
+	while (set->entries[hash].o1) {
+		if (set->entries[hash].o1 == o1 && set->entries[hash].o2 == o2)
+			break;
+		hash = (hash + 1) & mask;
+	}
+	return set->entries + hash;
+}
+
+/**
+ * List every pair that may overlap; sleeping objects are only paired with
+ *awake ones
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_broadphase(GFraMe_world *world) {
+	GFraMe_world_job job;
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i, num;
+
+	world->num_pairs = 0;
+	// Make sure every worker has its own list of pairs
+	num = GFraMe_workers_get_num();
+	if (world->num_chunks < num) {
+		GFraMe_world_chunk *tmp;
+
+		tmp = (GFraMe_world_chunk*)realloc(world->chunks,
+										   sizeof(GFraMe_world_chunk) * num);
+		GFraMe_assertRV(tmp, "Failed to alloc memory",
+						rv = GFraMe_ret_memory_error, _ret);
+		world->chunks = tmp;
+		while (world->num_chunks < num) {
+			world->chunks[world->num_chunks].pairs = NULL;
+			world->chunks[world->num_chunks].max_pairs = 0;
+			world->num_chunks++;
+		}
+	}
+	// Only rebuild the sleeping objects' grid if it changed
+	if (world->asleep_dirty) {
+		rv = GFraMe_world_fill_grid(world, &world->asleep, world->num_awake,
+									world->num_objs);
+		GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to fill grid", _ret);
+		world->asleep_dirty = 0;
+	}
+	rv = GFraMe_world_fill_grid(world, &world->awake, 0, world->num_awake);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to fill grid", _ret);
+	world->awake_dirty = 0;
+	job.world = world;
+	job.first = 0;
+	// List every pair of awake objects that share a cell, splitting the
+	// cells between the workers...
+	i = 0;
+	while (i < world->num_chunks) {
+		world->chunks[i].num_pairs = 0;
+		world->chunks[i].rv = GFraMe_ret_ok;
+		i++;
+	}
+	GFraMe_workers_run(world->columns * world->rows,
+					   GFraMe_world_awake_pairs_range, &job);
+	// ...and merge them in order, so they are the same as if found serially
+	rv = GFraMe_world_merge_pairs(world);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to list pairs", _ret);
+	// Do the same, pairing every awake object with the sleeping ones
+	i = 0;
+	while (i < world->num_chunks) {
+		world->chunks[i].num_pairs = 0;
+		world->chunks[i].rv = GFraMe_ret_ok;
+		i++;
+	}
+	GFraMe_workers_run(world->num_awake, GFraMe_world_asleep_pairs_range,
+					   &job);
+	rv = GFraMe_world_merge_pairs(world);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to list pairs", _ret);
+_ret:
+	return rv;
+}
+
+/**
+ * Append every pair found by the workers, in order, to the world's list
+ * @param	*world	The world
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_merge_pairs(GFraMe_world *world) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i, num;
+
+	num = world->num_pairs;
+	i = 0;
+	while (i < world->num_chunks) {
+		GFraMe_assertRV(world->chunks[i].rv == GFraMe_ret_ok,
+						"Worker failed", rv = world->chunks[i].rv, _ret);
+		num += world->chunks[i].num_pairs;
+		i++;
+	}
+	rv = GFraMe_world_grow((void**)&world->pairs, &world->max_pairs, num,
+						   sizeof(int)*2);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to alloc pairs", _ret);
+	i = 0;
+	while (i < world->num_chunks) {
+		GFraMe_world_chunk *chunk = world->chunks + i;
+
+		if (chunk->num_pairs > 0)
+			memcpy(world->pairs + world->num_pairs*2, chunk->pairs,
+				   sizeof(int) * 2 * chunk->num_pairs);
+		world->num_pairs += chunk->num_pairs;
+		i++;
+	}
+_ret:
+	return rv;
+}
+
+/**
+ * Update a range of awake objects
+ * @param	*ctx	The job (GFraMe_world_job)
+ * @param	first	First object
+ * @param	last	Object after the last one
+ * @param	chunk	Worker's chunk
+ */
+static void GFraMe_world_update_range(void *ctx, int first, int last,
+									  int chunk) {
+	GFraMe_world_job *job = (GFraMe_world_job*)ctx;
+
+	while (first < last) {
+		GFraMe_object_update(job->world->objs[first], job->ms);
+		first++;
+	}
+}
+
+/**
+ * List the pairs of awake objects on a range of cells
+ * @param	*ctx	The job (GFraMe_world_job)
+ * @param	first	First cell
+ * @param	last	Cell after the last one
+ * @param	chunk	Worker's chunk
+ */
+static void GFraMe_world_awake_pairs_range(void *ctx, int first, int last,
+										   int chunk) {
+	GFraMe_world_chunk *pairs;
+	GFraMe_world_grid *grid;
+	GFraMe_world *world;
+	GFraMe_ret rv;
+
+	world = ((GFraMe_world_job*)ctx)->world;
+	grid = &world->awake;
+	pairs = world->chunks + chunk;
+	while (first < last) {
+		int a, end;
+
+		end = grid->cell_start[first + 1];
+		a = grid->cell_start[first];
+		while (a < end) {
+			int b = a + 1;
+			while (b < end) {
+				rv = GFraMe_world_add_pair(world, pairs, grid->cell_items[a],
+										   grid->cell_items[b], first);
+				GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to add pair",
+								 _ret);
+				b++;
+			}
+			a++;
+		}
+		first++;
+	}
+	rv = GFraMe_ret_ok;
+_ret:
+	pairs->rv = rv;
+}
+
+/**
+ * Pair a range of awake objects with the sleeping ones on their cells
+ * @param	*ctx	The job (GFraMe_world_job)
+ * @param	first	First awake object
+ * @param	last	Object after the last one
+ * @param	chunk	Worker's chunk
+ */
+static void GFraMe_world_asleep_pairs_range(void *ctx, int first, int last,
+											int chunk) {
+	GFraMe_world_chunk *pairs;
+	GFraMe_world_grid *grid;
+	GFraMe_world *world;
+	GFraMe_ret rv;
+
+	world = ((GFraMe_world_job*)ctx)->world;
+	grid = &world->asleep;
+	pairs = world->chunks + chunk;
+	while (first < last) {
+		int *cells, cx, cy;
+
+		cells = world->obj_cells + first*4;
+		cy = cells[1];
+		while (cy <= cells[3]) {
+			cx = cells[0];
+			while (cx <= cells[2]) {
+				int b, c, end;
+
+				c = cy*world->columns + cx;
+				end = grid->cell_start[c + 1];
+				b = grid->cell_start[c];
+				while (b < end) {
+					rv = GFraMe_world_add_pair(world, pairs, first,
+											   grid->cell_items[b], c);
+					GFraMe_assertRet(rv == GFraMe_ret_ok,
+									 "Failed to add pair", _ret);
+					b++;
+				}
+				cx++;
+			}
+			cy++;
+		}
+		first++;
+	}
+	rv = GFraMe_ret_ok;
+_ret:
+	pairs->rv = rv;
+}
+
+/**
+ * Spread a range of objects on a grid
+ * @param	*world	The world
+ * @param	*grid	The grid
+ * @param	first	Index of the first object
+ * @param	last	Index after the last object
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_fill_grid(GFraMe_world *world,
+										 GFraMe_world_grid *grid, int first,
+										 int last) {
+	GFraMe_world_job job;
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int i, num_cells, num_items;
+
+	// Get the cells each object occupies (on the workers)
+	job.world = world;
+	job.first = first;
+	GFraMe_workers_run(last - first, GFraMe_world_cells_range, &job);
+	// Count how many objects are on each cell
+	num_cells = world->columns * world->rows;
+	memset(grid->cell_start, 0x0, sizeof(int) * (num_cells + 1));
+	num_items = 0;
+	i = first;
+	while (i < last) {
+		int *cells;
+		int cx, cy;
+
+		cells = world->obj_cells + i*4;
+		cy = cells[1];
+		while (cy <= cells[3]) {
+			cx = cells[0];
+			while (cx <= cells[2]) {
+				grid->cell_start[cy*world->columns + cx + 1]++;
+				num_items++;
+				cx++;
+			}
+			cy++;
+		}
+		i++;
+	}
+	rv = GFraMe_world_grow((void**)&grid->cell_items, &grid->max_items,
+						   num_items, sizeof(int));
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to alloc cells", _ret);
+	// Turn the count into each cell's first position...
+	i = 0;
+	while (i < num_cells) {
+		grid->cell_start[i + 1] += grid->cell_start[i];
+		i++;
+	}
+	// ...and then fill every cell (temporarily using the start as cursor)
+	i = first;
+	while (i < last) {
+		int *cells;
+		int cx, cy;
+
+		cells = world->obj_cells + i*4;
+		cy = cells[1];
+		while (cy <= cells[3]) {
+			cx = cells[0];
+			while (cx <= cells[2]) {
+				int c = cy*world->columns + cx;
+				grid->cell_items[grid->cell_start[c]] = i;
+				grid->cell_start[c]++;
+				cx++;
+			}
+			cy++;
+		}
+		i++;
+	}
+	// Restore the cells' start (each now points to the next one's start)
+	i = num_cells;
+	while (i > 0) {
+		grid->cell_start[i] = grid->cell_start[i - 1];
+		i--;
+	}
+	grid->cell_start[0] = 0;
+_ret:
+	return rv;
+}
+
+/**
+ * Calculate the cells occupied by a range of objects
+ * @param	*ctx	The job (GFraMe_world_job)
+ * @param	first	First object (relative to the job's first)
+ * @param	last	Object after the last one
+ * @param	chunk	Worker's chunk
+ */
+static void GFraMe_world_cells_range(void *ctx, int first, int last,
+									 int chunk) {
+	GFraMe_world_job *job = (GFraMe_world_job*)ctx;
+	GFraMe_world *world = job->world;
+	int i;
+
+	i = job->first + first;
+	last += job->first;
+	while (i < last) {
+		GFraMe_object *obj;
+		GFraMe_hitbox *hb;
+		double l, t, r, b;
+		int *cells;
+
+		obj = world->objs[i];
+		hb = GFraMe_object_get_hitbox(obj);
+		cells = world->obj_cells + i*4;
+		// Get the object's bounds
+		l = obj->dx + hb->cx - hb->hw;
+		r = obj->dx + hb->cx + hb->hw;
+		t = obj->dy + hb->cy - hb->hh;
+		b = obj->dy + hb->cy + hb->hh;
+		// When sweeping, it must cover its whole movement
+		if (world->use_sweep) {
+			if (obj->ldx < obj->dx)
+				l -= obj->dx - obj->ldx;
+			else
+				r += obj->ldx - obj->dx;
+			if (obj->ldy < obj->dy)
+				t -= obj->dy - obj->ldy;
+			else
+				b += obj->ldy - obj->dy;
+		}
+		// Convert it to cells, clamping to the grid
+		#define CLAMP(val, max) \
+			((val) < 0 ? 0 : ((val) > (max) ? (max) : (val)))
+		cells[0] = CLAMP((int)((l - world->x) / world->cell_w),
+						 world->columns - 1);
+		cells[1] = CLAMP((int)((t - world->y) / world->cell_h),
+						 world->rows - 1);
+		cells[2] = CLAMP((int)((r - world->x) / world->cell_w),
+						 world->columns - 1);
+		cells[3] = CLAMP((int)((b - world->y) / world->cell_h),
+						 world->rows - 1);
+		#undef CLAMP
+		// Objects on no layer are never collided
+		if (obj->category == 0)
+			cells[2] = cells[0] - 1;
+		i++;
+	}
+}
+
+/**
+ * Add a pair that may overlap, if their layers match and this is the first
+ *cell they share
+ * @param	*world	The world
+ * @param	*chunk	Worker's list of pairs
+ * @param	i	Index of one of the objects
+ * @param	j	Index of the other object
+ * @param	cell	Cell where they were found
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_add_pair(GFraMe_world *world,
+										GFraMe_world_chunk *chunk, int i,
+										int j, int cell) {
+	GFraMe_object *o1, *o2;
+	GFraMe_ret rv = GFraMe_ret_ok;
+	int cx, cy, *c1, *c2;
+
+	o1 = world->objs[i];
+	o2 = world->objs[j];
+	c1 = world->obj_cells + i*4;
+	c2 = world->obj_cells + j*4;
+	// Filter pairs whose layers don't match
+	if (!(o1->category & o2->mask) || !(o2->category & o1->mask))
+		goto _ret;
+	// Only list the pair on the first cell they share
+	cx = (c1[0] > c2[0])? c1[0] : c2[0];
+	cy = (c1[1] > c2[1])? c1[1] : c2[1];
+	if (cy*world->columns + cx != cell)
+		goto _ret;
+	rv = GFraMe_world_grow((void**)&chunk->pairs, &chunk->max_pairs,
+						   chunk->num_pairs + 1, sizeof(int)*2);
+	GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to alloc pairs", _ret);
+	chunk->pairs[chunk->num_pairs*2] = i;
+	chunk->pairs[chunk->num_pairs*2 + 1] = j;
+	chunk->num_pairs++;
+_ret:
+	return rv;
+}
+
+/**
+ * Make sure a buffer has, at least, the requested number of items; it grows
+ *to double the needed size, to avoid reallocating too often
+ * @param	**buf	The buffer (may point to NULL)
+ * @param	*max	How many items the buffer currently holds
+ * @param	needed	How many items are needed
+ * @param	size	Size of each item
+ * @return	GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret GFraMe_world_grow(void **buf, int *max, int needed,
+									int size) {
+	GFraMe_ret rv = GFraMe_ret_ok;
+	void *tmp;
+	int len;
+
+	if (needed <= *max)
+		goto _ret;
+	len = needed * 2;
+	if (len < 16)
+		len = 16;
+	tmp = realloc(*buf, len * size);
+	GFraMe_assertRV(tmp, "Failed to alloc memory",
+					rv = GFraMe_ret_memory_error, _ret);
+	*buf = tmp;
+	*max = len;
+_ret:
+	return rv;
+}
+
+/**
+ * Get the index of a category's first layer
+ * @param	category	Bitfield of layers
+ * @return	The first layer or -1, if it's on none
+ */
+static int GFraMe_world_get_layer(unsigned int category) {
+	int i = 0;
+	while (i < GFraMe_world_max_layers) {
+		if (category & (1u << i))
+			return i;
+		i++;
+	}
+	return -1;
+}
+
@@ -15,6 +15,7 @@ static PFNGLDELETEPROGRAMPROC glDeleteProgram;
 static PFNGLBINDBUFFERPROC glBindBuffer;
 static PFNGLUNIFORM1IPROC glUniform1i;
 static PFNGLUNIFORM1FPROC glUniform1f;
+static PFNGLUNIFORM4FPROC glUniform4f;
 static PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
 static PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
 static PFNGLGENBUFFERSPROC glGenBuffers;
@@ -23,6 +23,7 @@ static void glw_loadFunctions() {
 	LOAD_PROC(PFNGLBINDBUFFERPROC, glBindBuffer);
 	LOAD_PROC(PFNGLUNIFORM1IPROC, glUniform1i);
 	LOAD_PROC(PFNGLUNIFORM1FPROC, glUniform1f);
+	LOAD_PROC(PFNGLUNIFORM4FPROC, glUniform4f);
 	LOAD_PROC(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray);
 	LOAD_PROC(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer);
 	LOAD_PROC(PFNGLGENBUFFERSPROC, glGenBuffers);
@@ -10,6 +10,9 @@ static char sprVs[] =
   "uniform vec2 translation;\n"
   "uniform vec2 dimensions;\n"
   "uniform vec2 texOffset;\n"
+  "uniform vec4 anim;\n"
+  "uniform float animColumns;\n"
+  "uniform float time;\n"
   "void main() {\n"
   "  mat2 rot = mat2(rotation.x, -rotation.y,"
   "                  rotation.y, rotation.x);\n"
@@ -28,7 +31,16 @@ static char sprVs[] =
                              "0.5f);\n"
   "  _texCoord *= texDimensions;\n"
   "  _texCoord *= dimensions;\n"
-  "  texCoord = texDimensions*texOffset"
+  // Looping animations (anim = first tile, frames, frames per ms and start
+  // time) pick their current tile from the time
+  "  vec2 offset = texOffset;\n"
+  "  if (anim.y > 0.0f) {\n"
+  "    float tile = anim.x + mod(floor((time - anim.w) * anim.z),"
+  "                              anim.y);\n"
+  "    offset = vec2(mod(tile, animColumns),"
+  "                  floor(tile / animColumns)) * dimensions;\n"
+  "  }\n"
+  "  texCoord = texDimensions*offset"
   "                +_texCoord;\n"
   "}\n";
 
@@ -31,6 +31,10 @@ static GLuint sprDimensions;
 static GLuint sprTexOffset;
 static GLuint sprSampler;
 static GLuint sprAlpha;
+static GLuint sprAnim;
+static GLuint sprAnimColumns;
+static GLuint sprTime;
+static GLfloat animTime;
 
 static GLuint bbVbo;
 static GLuint bbIbo;
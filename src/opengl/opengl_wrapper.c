@@ -80,6 +80,9 @@ GLW_RV glw_compileProgram(int use_scanlines) {
 	sprTexOffset = glGetUniformLocation(sprPrg, "texOffset");
 	sprSampler = glGetUniformLocation(sprPrg, "gSampler");
 	sprAlpha = glGetUniformLocation(sprPrg, "alpha");
+	sprAnim = glGetUniformLocation(sprPrg, "anim");
+	sprAnimColumns = glGetUniformLocation(sprPrg, "animColumns");
+	sprTime = glGetUniformLocation(sprPrg, "time");
 	
 	bbSampler = glGetUniformLocation(bbPrg, "gSampler");
 	bbTexDimensions = glGetUniformLocation(bbPrg, "texDimensions");
@@ -143,6 +146,8 @@ GLW_RV glw_createSprite(int width, int height, char *data) {
 	glUniform2f(sprRotation, 1.0f, 0.0f);
 	glUniform2f(sprScale, 1.0f, 1.0f);
 	glUniform1f(sprAlpha, 1.0f);
+	glUniform4f(sprAnim, 0.0f, 0.0f, 0.0f, 0.0f);
+	glUniform1f(sprAnimColumns, 1.0f);
 	glUseProgram(0);
 	
 	return GLW_SUCCESS;
@@ -244,6 +249,7 @@ void glw_prepareRender() {
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, sprTex);
 	glUniform1i(sprSampler, 0);
+	glUniform1f(sprTime, animTime);
 	
 #if !defined(GFRAME_MOBILE)
 	glBindVertexArray(sprVao);
@@ -267,6 +273,20 @@ void glw_setAlpha(float alpha) {
 	glUniform1f(sprAlpha, alpha);
 }
 
+void glw_setTime(float ms) {
+	animTime = ms;
+}
+
+void glw_setAnimation(int first, int num, float fps, float start,
+                      int columns) {
+	if (num > 0) {
+		glUniform4f(sprAnim, (float)first, (float)num, fps / 1000.0f, start);
+		glUniform1f(sprAnimColumns, (float)columns);
+	}
+	else
+		glUniform4f(sprAnim, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
 void glw_renderSprite(int x, int y, int dx, int dy, int tx, int ty) {
 	glUniform2f(sprTranslation, (float)x, (float)y);
 	glUniform2f(sprDimensions, (float)dx, (float)dy);
@@ -55,6 +55,18 @@ void glw_setRotation(float angle);
 void glw_setScale(float sX, float sY);
 void glw_setAlpha(float alpha);
 
+/**
+ * Set the time used by looping animations (uploaded on glw_prepareRender)
+ */
+void glw_setTime(float ms);
+
+/**
+ * Make the next sprites pick their tile from the time, looping num frames
+ *(starting at tile first) at fps; num 0 disables it
+ */
+void glw_setAnimation(int first, int num, float fps, float start,
+                      int columns);
+
 /**
  * Render the backbuffer to the screen
  */
@@ -0,0 +1,30 @@
+#include <GFraMe/wavtodata/wavtodata.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Convert WAVE files into the framework's audio assets offline, either as raw
+ * samples ('.dat') or encoded as IMA-ADPCM ('.adp'), so they may be shipped
+ * already converted
+ *
+ * usage: wavtodata [-adpcm] <in.wav> <out>
+ */
+int main(int argc, char *argv[]) {
+	int adpcm = 0;
+	int arg = 1;
+
+	if (argc > 1 && strcmp(argv[1], "-adpcm") == 0) {
+		adpcm = 1;
+		arg++;
+	}
+	if (argc - arg != 2) {
+		printf("usage: %s [-adpcm] <in.wav> <out>\n", argv[0]);
+		printf("  -adpcm  Encode it as IMA-ADPCM ('.adp'), instead of raw "
+			"samples ('.dat')\n");
+		return 1;
+	}
+
+	if (adpcm)
+		return wavtoadpcm(argv[arg], argv[arg + 1], 1);
+	return wavtodata(argv[arg], argv[arg + 1], 1);
+}
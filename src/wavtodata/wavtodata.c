@@ -1,3 +1,4 @@
+#include <GFraMe/GFraMe_adpcm.h>
 #include <GFraMe/wavtodata/chunk.h>
 #include <GFraMe/wavtodata/fmt.h>
 #include <GFraMe/wavtodata/wavtodata.h>
@@ -10,15 +11,33 @@ void printSeparator();
 FILE* promptFile(const char *mode, int force);
 FILE* getFile(const char *name, const char *mode, int force);
 int checkFmt(struct fmt *f);
+void writeHeader(FILE *out, struct fmt *f);
+int writeAdpcm(FILE *out, struct fmt *f, Sint16 *pcm, int frames);
+static int convert(char *infile, char *outfile, int force, int adpcm);
 
-//int main(int argc, char *argv[]) {
 int wavtodata(char *infile, char *outfile, int force) {
+	return convert(infile, outfile, force, 0);
+}
+
+int wavtoadpcm(char *infile, char *outfile, int force) {
+	return convert(infile, outfile, force, 1);
+}
+
+/**
+ * Convert a WAVE file either into raw samples or into IMA-ADPCM; the latter
+ * has to be buffered, since its header starts with how many frames there are
+ */
+//int main(int argc, char *argv[]) {
+static int convert(char *infile, char *outfile, int force, int adpcm) {
 	FILE *file;
 	FILE *out = NULL;
 	struct chunk fd;
 	struct chunk c;
 	struct fmt f;
 	char *data;
+	Sint16 *pcm = NULL;
+	int frames = 0;
+	int rv = 0;
 	/*
 	if (argc == 2) {
 		file = getFile(argv[1], "rb", 1);
@@ -84,10 +103,14 @@ int wavtodata(char *infile, char *outfile, int force) {
 			printSeparator();
 			
 			if (!checkFmt(&f)) {
+				if (pcm)
+					free(pcm);
 				fclose(file);
 				fclose(out);
 				return 1;
 			}
+			if (!adpcm)
+				writeHeader(out, &f);
 		}
 		else if (my_strcmp(c.id, "LIST")) {
 			printSeparator();
@@ -101,14 +124,45 @@ int wavtodata(char *infile, char *outfile, int force) {
 			printf("Data found\n");
 			printf("Reading samples...\n");
 			data = (char*)malloc(sizeof(char)*f.bpb);
+			if (adpcm) {
+				Sint16 *tmp;
+				
+				tmp = (Sint16*)realloc(pcm, sizeof(Sint16) * f.nchan
+					* (frames + c.len / f.bpb));
+				if (!tmp) {
+					printf("Failed to alloc memory\n");
+					rv = 1;
+					free(data);
+					break;
+				}
+				pcm = tmp;
+			}
 			while(c.read < c.len) {
-				readChunkBytes(file, &c, data, f.bpb);
-				if (f.nchan == 1) {
-					fwrite(data, sizeof(char), 2, out);
-					fwrite(data, sizeof(char), 2, out);
+				int i = 0;
+				
+				if (readChunkBytes(file, &c, data, f.bpb) < f.bpb)
+					break;
+				while (i < f.nchan) {
+					int s;
+					
+					if (f.bps == 16)
+						s = (Sint16)((data[i*2] & 0xff)
+							| ((data[i*2 + 1] & 0xff) << 8));
+					else
+						// 8 bits samples are unsigned; expand them to 16 bits
+						s = ((data[i] & 0xff) - 128) * 256;
+					if (adpcm)
+						pcm[frames * f.nchan + i] = (Sint16)s;
+					else {
+						char smp[2];
+						
+						smp[0] = (char)(s & 0xff);
+						smp[1] = (char)((s >> 8) & 0xff);
+						fwrite(smp, sizeof(char), 2, out);
+					}
+					i++;
 				}
-				else if (f.nchan == 2)
-					fwrite(data, sizeof(char), 4, out);
+				frames++;
 			}
 			printSeparator();
 			free(data);
@@ -123,9 +177,17 @@ int wavtodata(char *infile, char *outfile, int force) {
 		fd.read += c.len;
 	}
 	
+	if (adpcm && rv == 0) {
+		printf("Encoding %i frames...\n", frames);
+		rv = writeAdpcm(out, &f, pcm, frames);
+	}
+	if (pcm)
+		free(pcm);
 	fclose(file);
-	fclose(out);
-	return 0;
+	// Closing flushes whatever was still buffered, so it may fail as well
+	if (fclose(out) != 0)
+		rv = 1;
+	return rv;
 }
 
 int my_strcmp(char id[4], const char *s) {
@@ -181,17 +243,83 @@ FILE* getFile(const char *name, const char *mode, int force) {
 }
 
 int checkFmt(struct fmt *f) {
-	if (f->smprate != 44100) {
-		printf("Unsuported sample rate (must be 44.1KHz)\n");
+	if (f->fmt != 1) {
+		printf("Unsuported format (must be PCM)\n");
+		return 0;
+	}
+	else if (f->smprate < WAVTODATA_MIN_RATE || f->smprate > WAVTODATA_MAX_RATE) {
+		printf("Unsuported sample rate (must be 11.025KHz to 48KHz)\n");
 		return 0;
 	}
 	else if (f->nchan != 1 && f->nchan != 2) {
 		printf("Unsuported number of channels (either 1 or 2)\n");
 		return 0;
 	}
-	else if (f->bps != 16) {
-		printf("Unsuported bits per sample (must be 16 bits)\n");
+	else if (f->bps != 8 && f->bps != 16) {
+		printf("Unsuported bits per sample (either 8 or 16 bits)\n");
 		return 0;
 	}
 	return 1;
 }
+
+void writeHeader(FILE *out, struct fmt *f) {
+	char hdr[WAVTODATA_HEADER_SIZE];
+	
+	hdr[0] = WAVTODATA_MAGIC[0];
+	hdr[1] = WAVTODATA_MAGIC[1];
+	hdr[2] = WAVTODATA_MAGIC[2];
+	hdr[3] = WAVTODATA_MAGIC[3];
+	hdr[4] = (char)(f->smprate & 0xff);
+	hdr[5] = (char)((f->smprate >> 8) & 0xff);
+	hdr[6] = (char)((f->smprate >> 16) & 0xff);
+	hdr[7] = (char)((f->smprate >> 24) & 0xff);
+	hdr[8] = (char)(f->nchan & 0xff);
+	hdr[9] = 0;
+	hdr[10] = 0;
+	hdr[11] = 0;
+	fwrite(hdr, sizeof(char), WAVTODATA_HEADER_SIZE, out);
+}
+
+/**
+ * Encode the samples and write them, after the header (see WAVTOADPCM_HEADER_SIZE)
+ * @return 0 - Success; 1 - Failure
+ */
+int writeAdpcm(FILE *out, struct fmt *f, Sint16 *pcm, int frames) {
+	char hdr[WAVTOADPCM_HEADER_SIZE];
+	char *enc;
+	int size, rv;
+	
+	if (frames <= 0) {
+		printf("No samples found!\n");
+		return 1;
+	}
+	size = GFraMe_adpcm_get_size(frames, f->nchan == 2);
+	enc = (char*)malloc(size);
+	if (!enc) {
+		printf("Failed to alloc memory\n");
+		return 1;
+	}
+	GFraMe_adpcm_encode(enc, pcm, frames, f->nchan == 2);
+	
+	hdr[0] = (char)(frames & 0xff);
+	hdr[1] = (char)((frames >> 8) & 0xff);
+	hdr[2] = (char)((frames >> 16) & 0xff);
+	hdr[3] = (char)((frames >> 24) & 0xff);
+	hdr[4] = (char)(f->smprate & 0xff);
+	hdr[5] = (char)((f->smprate >> 8) & 0xff);
+	hdr[6] = (char)((f->smprate >> 16) & 0xff);
+	hdr[7] = (char)((f->smprate >> 24) & 0xff);
+	hdr[8] = (char)(f->nchan & 0xff);
+	hdr[9] = 0;
+	hdr[10] = 0;
+	hdr[11] = 0;
+	rv = 0;
+	if (fwrite(hdr, sizeof(char), WAVTOADPCM_HEADER_SIZE, out)
+			!= WAVTOADPCM_HEADER_SIZE
+		|| fwrite(enc, sizeof(char), size, out) != (size_t)size) {
+		printf("Failed to write the encoded audio\n");
+		rv = 1;
+	}
+	free(enc);
+	return rv;
+}
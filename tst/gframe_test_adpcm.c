@@ -0,0 +1,216 @@
+/**
+ * @file gframe_test_adpcm.c
+ *
+ * Check that GFraMe_adpcm keeps encoded audios close to the original and
+ * that decoding in chunks, skipping and seeking give exactly the same samples
+ * as decoding everything at once; runs without a window and returns non-zero
+ * on failure
+ */
+#include <GFraMe/GFraMe_adpcm.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * How many frames are encoded (not a multiple of the block size, so the last
+ * block is partial)
+ */
+#define NUM_FRAMES (GFraMe_adpcm_block_frames * 40 + 123)
+/**
+ * How many random seeks are checked
+ */
+#define NUM_SEEKS 500
+/**
+ * Minimum signal-to-noise ratio accepted, in dB
+ */
+#define MIN_SNR 30.0
+
+/**
+ * Original samples (interleaved, if stereo)
+ */
+static Sint16 pcm[NUM_FRAMES * 2];
+/**
+ * Samples decoded at once
+ */
+static Sint16 full[NUM_FRAMES * 2];
+/**
+ * Samples decoded in chunks
+ */
+static Sint16 part[NUM_FRAMES * 2];
+
+/**
+ * Fill the original samples with a few tones and some noise
+ *
+ * @param stereo Whether there are two channels or only one
+ */
+static void gen_samples(int stereo);
+
+/**
+ * Check an encoded audio
+ *
+ * @param *src The encoded audio
+ * @param stereo Whether there are two channels or only one
+ * @return How many errors were found
+ */
+static int check_audio(const char *src, int stereo);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_ret rv;
+    char *enc;
+    int stereo, errors;
+
+    errors = 0;
+    enc = (char*)malloc(GFraMe_adpcm_get_size(NUM_FRAMES, 1));
+    GFraMe_assertRV(enc, "Couldn't alloc memory",
+        rv = GFraMe_ret_memory_error, __ret);
+
+    srand(1);
+    stereo = 0;
+    while (stereo < 2) {
+        int size;
+
+        gen_samples(stereo);
+        size = GFraMe_adpcm_encode(enc, pcm, NUM_FRAMES, stereo);
+        if (size != GFraMe_adpcm_get_size(NUM_FRAMES, stereo)) {
+            GFraMe_log("Stereo %i: encoded %i bytes, expected %i", stereo,
+                size, GFraMe_adpcm_get_size(NUM_FRAMES, stereo));
+            errors++;
+        }
+        errors += check_audio(enc, stereo);
+        stereo++;
+    }
+
+    rv = GFraMe_ret_ok;
+    if (errors == 0)
+        GFraMe_log("Every decoded sample matched!");
+    else
+        rv = GFraMe_ret_failed;
+__ret:
+    if (enc)
+        free(enc);
+    return rv;
+}
+
+/**
+ * Fill the original samples with a few tones and some noise
+ *
+ * @param stereo Whether there are two channels or only one
+ */
+static void gen_samples(int stereo) {
+    int i, chans;
+
+    chans = stereo ? 2 : 1;
+    i = 0;
+    while (i < NUM_FRAMES * chans) {
+        double t, s;
+
+        t = (double)(i / chans) / 44100.0;
+        s = 9000.0 * sin(2.0 * M_PI * 220.0 * t)
+            + 4000.0 * sin(2.0 * M_PI * (1250.0 + 330.0 * (i % chans)) * t)
+            + (double)(rand() % 1001 - 500);
+        pcm[i] = (Sint16)s;
+        i++;
+    }
+}
+
+/**
+ * Check an encoded audio
+ *
+ * @param *src The encoded audio
+ * @param stereo Whether there are two channels or only one
+ * @return How many errors were found
+ */
+static int check_audio(const char *src, int stereo) {
+    GFraMe_adpcm_state st;
+    double sig, noise, snr;
+    int i, chans, done, errors;
+
+    errors = 0;
+    chans = stereo ? 2 : 1;
+
+    // Decode it all at once and compare it against the original
+    GFraMe_adpcm_init_state(&st);
+    done = GFraMe_adpcm_decode(full, &st, src, NUM_FRAMES + 100, NUM_FRAMES,
+        stereo);
+    if (done != NUM_FRAMES) {
+        GFraMe_log("Stereo %i: decoded %i frames, expected %i", stereo, done,
+            NUM_FRAMES);
+        errors++;
+    }
+    sig = 0.0;
+    noise = 0.0;
+    i = 0;
+    while (i < NUM_FRAMES * chans) {
+        double d = (double)full[i] - (double)pcm[i];
+
+        sig += (double)pcm[i] * (double)pcm[i];
+        noise += d * d;
+        i++;
+    }
+    snr = 10.0 * log10(sig / (noise > 0.0 ? noise : 1.0));
+    if (snr < MIN_SNR) {
+        GFraMe_log("Stereo %i: SNR of %.2f dB, expected at least %.2f dB",
+            stereo, snr, MIN_SNR);
+        errors++;
+    }
+
+    // Decode it again in random chunks, skipping some of them
+    memset(part, 0x0, sizeof(part));
+    GFraMe_adpcm_init_state(&st);
+    done = 0;
+    while (done < NUM_FRAMES) {
+        int num = 1 + rand() % (GFraMe_adpcm_block_frames * 2);
+
+        if (rand() % 4 == 0) {
+            num = GFraMe_adpcm_decode(NULL, &st, src, num, NUM_FRAMES, stereo);
+            memcpy(part + done * chans, full + done * chans,
+                num * chans * sizeof(Sint16));
+        }
+        else
+            num = GFraMe_adpcm_decode(part + done * chans, &st, src, num,
+                NUM_FRAMES, stereo);
+        done += num;
+    }
+    if (memcmp(part, full, NUM_FRAMES * chans * sizeof(Sint16)) != 0) {
+        GFraMe_log("Stereo %i: decoding in chunks didn't match", stereo);
+        errors++;
+    }
+    if (GFraMe_adpcm_decode(part, &st, src, 1, NUM_FRAMES, stereo) != 0) {
+        GFraMe_log("Stereo %i: decoded past the end", stereo);
+        errors++;
+    }
+
+    // Seek to random frames (and to both ends) and decode a few frames
+    i = 0;
+    while (i < NUM_SEEKS) {
+        int frame, num;
+
+        if (i == 0)
+            frame = 0;
+        else if (i == 1)
+            frame = NUM_FRAMES - 1;
+        else
+            frame = rand() % NUM_FRAMES;
+        GFraMe_adpcm_seek(&st, src, frame, stereo);
+        num = GFraMe_adpcm_decode(part, &st, src,
+            1 + rand() % GFraMe_adpcm_block_frames, NUM_FRAMES, stereo);
+        if (memcmp(part, full + frame * chans, num * chans * sizeof(Sint16))
+            != 0 || st.frame != frame + num) {
+            GFraMe_log("Stereo %i: seeking to frame %i didn't match", stereo,
+                frame);
+            errors++;
+        }
+        i++;
+    }
+
+    return errors;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file gframe_test_animsys.c
+ *
+ * Check that the batched animations play just like GFraMe_animation (using
+ * the same animations as gframe_test_animation.c); runs without a window and
+ * returns non-zero on failure
+ */
+#include <GFraMe/GFraMe_animation.h>
+#include <GFraMe/GFraMe_animsys.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <stdlib.h>
+
+/**
+ * How many instances are played
+ */
+#define NUM_INSTANCES 64
+/**
+ * How many updates are run
+ */
+#define NUM_STEPS 2000
+
+/**
+ * Frames for animation 1
+ */
+static int animData1[] = {0, 1};
+/**
+ * Frames for animation 2
+ */
+static int animData2[] = {0};
+/**
+ * Frames for animation 3
+ */
+static int animData3[] = {1};
+/**
+ * Frames for a non-looping animation
+ */
+static int animData4[] = {2, 3, 4, 5};
+/**
+ * Frames for a quick looping animation
+ */
+static int animData5[] = {6, 7, 8};
+
+/**
+ * Reference animations, one per instance
+ */
+static GFraMe_animation ref[NUM_INSTANCES];
+/**
+ * Tile written by the system, for each instance
+ */
+static int tiles[NUM_INSTANCES];
+/**
+ * Clip played by each instance
+ */
+static int cur[NUM_INSTANCES];
+
+/**
+ * Initialize a reference animation from a clip
+ *
+ * @param *anim The animation
+ * @param *clip The clip
+ */
+static void init_reference(GFraMe_animation *anim, GFraMe_anim_clip *clip);
+
+/**
+ * Update a reference animation, splitting the elapsed time so no frame is
+ * ever skipped
+ *
+ * @param *anim The animation
+ * @param ms Time elapsed, in milliseconds
+ */
+static void update_reference(GFraMe_animation *anim, int ms);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_animsys_handle handles[NUM_INSTANCES];
+    GFraMe_anim_clip clips[5];
+    GFraMe_animsys sys;
+    GFraMe_ret rv;
+    int i, step, errors;
+
+    errors = 0;
+    rv = GFraMe_animsys_init(&sys, NUM_INSTANCES);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to init the system", __ret);
+
+    // Init the clips just like the animations on gframe_test_animation.c
+    GFraMe_anim_clip_init(clips + 0, 8, animData1, 2, 1);
+    GFraMe_anim_clip_init(clips + 1, 0, animData2, 1, 0);
+    GFraMe_anim_clip_init(clips + 2, 0, animData3, 1, 0);
+    GFraMe_anim_clip_init(clips + 3, 12, animData4, 4, 0);
+    GFraMe_anim_clip_init(clips + 4, 30, animData5, 3, 1);
+    i = 0;
+    while (i < NUM_INSTANCES) {
+        cur[i] = i % 5;
+        init_reference(ref + i, clips + cur[i]);
+        rv = GFraMe_animsys_add(&sys, handles + i, clips + cur[i], tiles + i);
+        GFraMe_assertRet(rv == GFraMe_ret_ok, "Failed to add instance", __ret);
+        i++;
+    }
+
+    srand(1);
+    step = 0;
+    while (step < NUM_STEPS) {
+        // Mostly regular steps, with a few long ones (that skip frames)
+        int ms = 16 + rand() % 4;
+        if (rand() % 20 == 0)
+            ms = 100 + rand() % 900;
+
+        GFraMe_animsys_update(&sys, ms);
+        i = 0;
+        while (i < NUM_INSTANCES) {
+            int flags, last_tile;
+
+            last_tile = ref[i].tile;
+            update_reference(ref + i, ms);
+            flags = GFraMe_animsys_get_flags(&sys, handles[i]);
+            if (ref[i].tile != tiles[i]
+                || ref[i].tile != GFraMe_animsys_get_tile(&sys, handles[i])) {
+                GFraMe_log("Step %i, instance %i: tile %i, expected %i", step,
+                    i, tiles[i], ref[i].tile);
+                errors++;
+            }
+            if (((flags & GFraMe_animsys_changed) != 0)
+                != (last_tile != ref[i].tile)) {
+                GFraMe_log("Step %i, instance %i: wrong changed flag", step,
+                    i);
+                errors++;
+            }
+            if (((flags & GFraMe_animsys_finished) != 0)
+                != (ref[i].acc <= 0)) {
+                GFraMe_log("Step %i, instance %i: wrong finished flag", step,
+                    i);
+                errors++;
+            }
+            i++;
+        }
+        // Change the clips every now and then (as the original test does)
+        if (step % 300 == 299) {
+            i = 0;
+            while (i < NUM_INSTANCES) {
+                cur[i] = (cur[i] + 1) % 5;
+                GFraMe_animsys_play(&sys, handles[i], clips + cur[i]);
+                init_reference(ref + i, clips + cur[i]);
+                i++;
+            }
+        }
+        step++;
+    }
+
+    if (errors == 0)
+        GFraMe_log("Every animation matched!");
+    else
+        rv = GFraMe_ret_failed;
+__ret:
+    GFraMe_animsys_clear(&sys);
+    return rv;
+}
+
+/**
+ * Initialize a reference animation from a clip
+ *
+ * @param *anim The animation
+ * @param *clip The clip
+ */
+static void init_reference(GFraMe_animation *anim, GFraMe_anim_clip *clip) {
+    GFraMe_animation_init(anim, 0, clip->frames, clip->num_frames,
+        clip->do_loop);
+    anim->frame_duration = clip->frame_duration;
+    anim->acc = clip->frame_duration;
+}
+
+/**
+ * Update a reference animation, splitting the elapsed time so no frame is
+ * ever skipped
+ *
+ * @param *anim The animation
+ * @param ms Time elapsed, in milliseconds
+ */
+static void update_reference(GFraMe_animation *anim, int ms) {
+    // Still animations simply finish
+    if (anim->frame_duration <= 0) {
+        GFraMe_animation_update(anim, ms);
+        return;
+    }
+    while (ms > 0) {
+        int cur = ms;
+
+        if (cur > anim->frame_duration)
+            cur = anim->frame_duration;
+        GFraMe_animation_update(anim, cur);
+        ms -= cur;
+    }
+}
+
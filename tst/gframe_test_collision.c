@@ -11,6 +11,7 @@
 #include <GFraMe/GFraMe_sprite.h>
 #include <GFraMe/GFraMe_spriteset.h>
 #include <GFraMe/GFraMe_texture.h>
+#include <GFraMe/GFraMe_tilemap.h>
 
 /**
  * Window's width
@@ -41,6 +42,15 @@
  */
 #define BPC 4
 
+/**
+ * Width of the tilemap used by the sweep tests, in tiles
+ */
+#define MAP_W 16
+/**
+ * Height of the tilemap used by the sweep tests, in tiles
+ */
+#define MAP_H 4
+
 /**
  * Anonymous enumeration for tests
  */
@@ -170,6 +180,42 @@ static void event_handler();
  */
 static void init_tests();
 
+/**
+ * Check that fast objects don't tunnel through thin objects nor through a
+ * tilemap's boxes (these run without drawing anything)
+ * 
+ * @return How many tests failed
+ */
+static int run_sweep_tests();
+
+/**
+ * Create an object moving from a position to another in a single (1 second)
+ * update
+ * 
+ * @param obj The object
+ * @param x0 Horizontal position before the update
+ * @param y0 Vertical position before the update
+ * @param x1 Horizontal position after the update
+ * @param y1 Vertical position after the update
+ * @param w Object's width
+ * @param h Object's height
+ */
+static void init_moving(GFraMe_object *obj, int x0, int y0, int x1, int y1,
+    int w, int h);
+
+/**
+ * Log a sweep test's result
+ * 
+ * @param obj The moving object
+ * @param dx Expected horizontal position
+ * @param dy Expected vertical position
+ * @param hit Directions the object should have been hit on
+ * @param label The test's description
+ * @return 0 - Success; 1 - Failure
+ */
+static int check_sweep(GFraMe_object *obj, int dx, int dy, int hit,
+    char *label);
+
 /**
  * Easily initialize a test
  * 
@@ -194,6 +240,7 @@ static void init_test(struct test_params *t, int w1, int h1, int w2, int h2,
  */
 int main (int argc, char *argv[]) {
     GFraMe_ret rv;
+    int sweep_errors;
     
     // Mark assets as not needing clean up
     didInitAssets = 0;
@@ -210,6 +257,9 @@ int main (int argc, char *argv[]) {
     // Initialize the tests
     init_tests();
     
+    // Run the tests that don't need to be seen
+    sweep_errors = run_sweep_tests();
+    
     // Init the framework update and draw clock
     GFraMe_event_init(60, 60);
     
@@ -267,6 +317,8 @@ int main (int argc, char *argv[]) {
         test++;
     }
     
+    if (sweep_errors > 0)
+        rv = GFraMe_ret_failed;
 __ret:
     
     // Clean up everything
@@ -577,3 +629,114 @@ static void init_test(struct test_params *t, int w1, int h1, int w2, int h2,
     }
 }
 
+/**
+ * Check that fast objects don't tunnel through thin objects nor through a
+ * tilemap's boxes (these run without drawing anything)
+ * 
+ * @return How many tests failed
+ */
+static int run_sweep_tests() {
+    GFraMe_object obj, wall;
+    GFraMe_tilemap tmap;
+    GFraMe_ret rv;
+    char data[MAP_W * MAP_H];
+    char collideable[] = {1};
+    int i, errors;
+    
+    errors = 0;
+    
+    // A 2 pixels wide wall, which the object would skip over in one step
+    init_moving(&obj, 0, 100, 200, 100, SPR_W, SPR_H);
+    GFraMe_object_clear(&wall);
+    GFraMe_object_set_pos(&wall, 100, 88);
+    GFraMe_hitbox_set(GFraMe_object_get_hitbox(&wall),
+        GFraMe_hitbox_upper_left, 0, 0, 2, 32);
+    rv = GFraMe_object_overlap(&obj, &wall, GFraMe_second_fixed);
+    errors += check_sweep(&obj, 200, 100, GFraMe_direction_none,
+        "8x8 X 2x32 - overlap misses a fast object (tunneling)");
+    rv = GFraMe_object_sweep(&obj, &wall, GFraMe_second_fixed);
+    errors += check_sweep(&obj, 100 - SPR_W, 100,
+        (rv == GFraMe_ret_ok)? GFraMe_direction_right : -1,
+        "8x8 X 2x32 - sweep stops a fast object");
+    
+    // A tilemap with a floor and a wall; the wall's column (down to the
+    // floor) is merged into a single 8x32 box
+    i = 0;
+    while (i < MAP_W * MAP_H) {
+        data[i] = (i / MAP_W == MAP_H - 1 || i % MAP_W == MAP_W / 2);
+        i++;
+    }
+    rv = GFraMe_tilemap_init(&tmap, MAP_W, MAP_H, data, &sset8x8,
+        collideable, 1);
+    if (rv != GFraMe_ret_ok) {
+        GFraMe_log("[FAIL] Couldn't init the tilemap");
+        return errors + 1;
+    }
+    tmap.x = 0;
+    tmap.y = 0;
+    
+    // Straight through the wall, in a single step
+    init_moving(&obj, 0, SPR_H, 300, SPR_H, SPR_W, SPR_H);
+    rv = GFraMe_tilemap_sweep(&tmap, &obj);
+    errors += check_sweep(&obj, MAP_W / 2 * SPR_W - SPR_W, SPR_H,
+        (rv == GFraMe_ret_ok)? GFraMe_direction_right : -1,
+        "8x8 X tilemap - sweep stops on a merged box");
+    
+    // Land on the floor, then slide along it into the wall (this takes a
+    // second sweep)
+    init_moving(&obj, 0, 0, 200, 100, SPR_W, SPR_H);
+    rv = GFraMe_tilemap_sweep(&tmap, &obj);
+    errors += check_sweep(&obj, MAP_W / 2 * SPR_W - SPR_W,
+        (MAP_H - 1) * SPR_H - SPR_H, (rv == GFraMe_ret_ok)?
+            (GFraMe_direction_right | GFraMe_direction_down) : -1,
+        "8x8 X tilemap - graze the floor and slide into the wall");
+    
+    GFraMe_tilemap_clear(&tmap);
+    return errors;
+}
+
+/**
+ * Create an object moving from a position to another in a single (1 second)
+ * update
+ * 
+ * @param obj The object
+ * @param x0 Horizontal position before the update
+ * @param y0 Vertical position before the update
+ * @param x1 Horizontal position after the update
+ * @param y1 Vertical position after the update
+ * @param w Object's width
+ * @param h Object's height
+ */
+static void init_moving(GFraMe_object *obj, int x0, int y0, int x1, int y1,
+    int w, int h) {
+    GFraMe_object_clear(obj);
+    GFraMe_object_set_pos(obj, x0, y0);
+    GFraMe_hitbox_set(GFraMe_object_get_hitbox(obj), GFraMe_hitbox_upper_left,
+        0, 0, w, h);
+    obj->vx = x1 - x0;
+    obj->vy = y1 - y0;
+    GFraMe_object_update(obj, 1000);
+}
+
+/**
+ * Log a sweep test's result
+ * 
+ * @param obj The moving object
+ * @param dx Expected horizontal position
+ * @param dy Expected vertical position
+ * @param hit Directions the object should have been hit on
+ * @param label The test's description
+ * @return 0 - Success; 1 - Failure
+ */
+static int check_sweep(GFraMe_object *obj, int dx, int dy, int hit,
+    char *label) {
+    int fail;
+    
+    fail = (obj->x != dx || obj->y != dy
+        || (obj->hit & GFraMe_direction_now) != hit);
+    GFraMe_log("%s %s", (fail)? ("[FAIL]"):(" [OK] "), label);
+    if (fail)
+        GFraMe_log("       at (%i, %i), hit 0x%x; expected (%i, %i), hit 0x%x",
+            obj->x, obj->y, obj->hit & GFraMe_direction_now, dx, dy, hit);
+    return fail;
+}
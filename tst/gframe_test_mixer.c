@@ -0,0 +1,388 @@
+/**
+ * @file gframe_test_mixer.c
+ *
+ * Check that the mixing kernels (which may run on SSE2 or NEON) give exactly
+ * the same results as plain scalar loops, over random gains, lengths and
+ * (unaligned) offsets, and that resampling in callback-sized parts gives the
+ * same output as a single pass; runs without a window and returns non-zero on
+ * failure
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_mixer.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * How many random runs are checked, for each kernel
+ */
+#define NUM_RUNS 2000
+/**
+ * Longest run, in samples (mono samples, for GFraMe_mixer_add_mono)
+ */
+#define MAX_LEN 300
+/**
+ * Extra samples at the start of every buffer, so runs start unaligned
+ */
+#define MAX_OFFSET 8
+/**
+ * How many frames are resampled, on each pass
+ */
+#define RS_FRAMES 12000
+/**
+ * How many frames the resampled audio has (less than needed, so its end is
+ * padded with silence)
+ */
+#define RS_SRC_FRAMES 10000
+/**
+ * How many frames fit the single pass' source buffer
+ */
+#define RS_BUF_FRAMES (RS_FRAMES * 2 + 4)
+
+/**
+ * Input samples
+ */
+static Sint16 src[MAX_LEN + MAX_OFFSET];
+/**
+ * Accumulator written by the kernels
+ */
+static Sint32 acc[MAX_LEN * 2 + MAX_OFFSET];
+/**
+ * Accumulator written by the reference loops
+ */
+static Sint32 ref[MAX_LEN * 2 + MAX_OFFSET];
+/**
+ * Output of GFraMe_mixer_saturate
+ */
+static Sint16 out[MAX_LEN + MAX_OFFSET];
+/**
+ * Audio that's resampled (interleaved, if stereo)
+ */
+static Sint16 rs_src[RS_SRC_FRAMES * 2];
+/**
+ * Source buffer, where the audio is copied into before being resampled
+ */
+static Sint16 rs_buf[RS_BUF_FRAMES * 2];
+/**
+ * Output of the single pass
+ */
+static Sint16 rs_ref[RS_FRAMES * 2];
+/**
+ * Output of the pass in parts
+ */
+static Sint16 rs_out[RS_FRAMES * 2];
+
+/**
+ * Sample rates (source, then output) that are resampled
+ */
+static int rates[][2] = {{22050, 48000}, {48000, 44100}, {44100, 48000},
+    {11025, 44100}, {44100, 22050}};
+/**
+ * Length (in output frames) of every part; 0 means random lengths
+ */
+static int parts[] = {512, 1024, 441, 1, 0};
+
+/**
+ * Get a random 16 bits value (over its whole range)
+ *
+ * @return The value
+ */
+static Sint16 rand16();
+
+/**
+ * Get a random gain; mostly valid volumes, but also any Q15 value
+ *
+ * @return The gain
+ */
+static Sint16 rand_gain();
+
+/**
+ * Fill the inputs and both accumulators (with the same values)
+ *
+ * @param range How far from 0 the accumulators' values may be
+ */
+static void fill_buffers(Sint32 range);
+
+/**
+ * Resample the whole audio, like the audio player does on every callback
+ *
+ * @param dst The output
+ * @param step Source frames per output frame
+ * @param chans How many channels there are
+ * @param part How many frames are resampled on each call (0 for random ones)
+ * @param max How many frames fit the source buffer
+ */
+static void resample_parts(Sint16 *dst, Uint32 step, int chans, int part,
+    int max);
+
+/**
+ * Check that resampling in parts matches a single pass (and that the single
+ * pass actually interpolates the audio)
+ *
+ * @param src_freq The audio's sample rate
+ * @param dst_freq The output's sample rate
+ * @param chans How many channels there are
+ * @return How many errors were found
+ */
+static int check_resample(int src_freq, int dst_freq, int chans);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_ret rv;
+    int run, errors;
+
+    errors = 0;
+    srand(1);
+    run = 0;
+    while (run < NUM_RUNS) {
+        Sint16 lgain, rgain;
+        int i, num, soff, aoff;
+
+        num = rand() % (MAX_LEN + 1);
+        soff = rand() % MAX_OFFSET;
+        aoff = rand() % MAX_OFFSET;
+        lgain = rand_gain();
+        rgain = rand_gain();
+
+        // Interleaved stereo (keeping the channels' order, so the offset is
+        // always even)
+        fill_buffers(1 << 24);
+        GFraMe_mixer_add(acc + (aoff & ~1), src + soff, num & ~1, lgain,
+            rgain);
+        i = 0;
+        while (i < (num & ~1)) {
+            ref[(aoff & ~1) + i] += ((Sint32)src[soff + i]
+                * ((i & 1) ? rgain : lgain)) >> 15;
+            i++;
+        }
+        if (memcmp(acc, ref, sizeof(acc)) != 0) {
+            GFraMe_log("Run %i: add didn't match (%i samples, gains %i, %i)",
+                run, num & ~1, lgain, rgain);
+            errors++;
+        }
+
+        // Mono, panned into both channels
+        fill_buffers(1 << 24);
+        GFraMe_mixer_add_mono(acc + aoff, src + soff, num / 2, lgain, rgain);
+        i = 0;
+        while (i < num / 2) {
+            ref[aoff + i * 2] += ((Sint32)src[soff + i] * lgain) >> 15;
+            ref[aoff + i * 2 + 1] += ((Sint32)src[soff + i] * rgain) >> 15;
+            i++;
+        }
+        if (memcmp(acc, ref, sizeof(acc)) != 0) {
+            GFraMe_log("Run %i: add_mono didn't match (%i samples, gains %i, "
+                "%i)", run, num / 2, lgain, rgain);
+            errors++;
+        }
+
+        // Saturate values both inside and outside of 16 bits
+        fill_buffers(1 << 17);
+        memset(out, 0x0, sizeof(out));
+        GFraMe_mixer_saturate(out + soff, acc + aoff, num);
+        i = 0;
+        while (i < MAX_LEN + MAX_OFFSET) {
+            Sint32 s = 0;
+
+            if (i >= soff && i < soff + num) {
+                s = ref[aoff + i - soff];
+                if (s > 32767)
+                    s = 32767;
+                else if (s < -32768)
+                    s = -32768;
+            }
+            if (out[i] != (Sint16)s) {
+                GFraMe_log("Run %i: saturate wrote %i at %i, expected %i",
+                    run, out[i], i, s);
+                errors++;
+                break;
+            }
+            i++;
+        }
+        run++;
+    }
+
+    run = 0;
+    while (run < (int)(sizeof(rates) / sizeof(rates[0]))) {
+        errors += check_resample(rates[run][0], rates[run][1], 1);
+        errors += check_resample(rates[run][0], rates[run][1], 2);
+        run++;
+    }
+
+    rv = GFraMe_ret_ok;
+    if (errors == 0)
+        GFraMe_log("Every mixed sample matched!");
+    else
+        rv = GFraMe_ret_failed;
+    return rv;
+}
+
+/**
+ * Get a random 16 bits value (over its whole range)
+ *
+ * @return The value
+ */
+static Sint16 rand16() {
+    return (Sint16)((rand() & 0xff) | ((rand() & 0xff) << 8));
+}
+
+/**
+ * Get a random gain; mostly valid volumes, but also any Q15 value
+ *
+ * @return The gain
+ */
+static Sint16 rand_gain() {
+    switch (rand() % 4) {
+        case 0: return 0;
+        case 1: return GFraMe_mixer_unity;
+        case 2: return rand16();
+        default: return GFraMe_mixer_get_gain((double)rand() / RAND_MAX);
+    }
+}
+
+/**
+ * Fill the inputs and both accumulators (with the same values)
+ *
+ * @param range How far from 0 the accumulators' values may be
+ */
+static void fill_buffers(Sint32 range) {
+    int i;
+
+    i = 0;
+    while (i < MAX_LEN + MAX_OFFSET) {
+        src[i] = rand16();
+        i++;
+    }
+    i = 0;
+    while (i < MAX_LEN * 2 + MAX_OFFSET) {
+        acc[i] = (Sint32)(rand() % (2 * range + 1)) - range;
+        ref[i] = acc[i];
+        i++;
+    }
+}
+
+/**
+ * Resample the whole audio, like the audio player does on every callback
+ *
+ * @param dst The output
+ * @param step Source frames per output frame
+ * @param chans How many channels there are
+ * @param part How many frames are resampled on each call (0 for random ones)
+ * @param max How many frames fit the source buffer
+ */
+static void resample_parts(Sint16 *dst, Uint32 step, int chans, int part,
+    int max) {
+    GFraMe_mixer_resampler rs;
+    int done, read;
+
+    GFraMe_mixer_init_resampler(&rs);
+    done = 0;
+    read = 0;
+    while (done < RS_FRAMES) {
+        int frames;
+
+        frames = part > 0 ? part : rand() % 1500 + 1;
+        if (frames > RS_FRAMES - done)
+            frames = RS_FRAMES - done;
+        // A callback may take more than one call, if the buffer is too short
+        while (frames > 0) {
+            Sint16 *buf;
+            int num, need, got;
+
+            num = frames;
+            need = GFraMe_mixer_resample_begin(&rs, rs_buf, &num, max, step,
+                chans);
+            buf = rs_buf + rs.num_carry * chans;
+            got = RS_SRC_FRAMES - read;
+            if (got > need)
+                got = need;
+            memcpy(buf, rs_src + read * chans, sizeof(Sint16) * got * chans);
+            memset(buf + got * chans, 0x0,
+                sizeof(Sint16) * (need - got) * chans);
+            read += got;
+            GFraMe_mixer_resample(&rs, dst + done * chans, rs_buf, num, step,
+                chans);
+            done += num;
+            frames -= num;
+        }
+    }
+}
+
+/**
+ * Check that resampling in parts matches a single pass (and that the single
+ * pass actually interpolates the audio)
+ *
+ * @param src_freq The audio's sample rate
+ * @param dst_freq The output's sample rate
+ * @param chans How many channels there are
+ * @return How many errors were found
+ */
+static int check_resample(int src_freq, int dst_freq, int chans) {
+    Uint32 step;
+    int i, c, errors;
+
+    errors = 0;
+    i = 0;
+    while (i < RS_SRC_FRAMES * chans) {
+        rs_src[i] = rand16();
+        i++;
+    }
+    step = GFraMe_mixer_get_step(src_freq, dst_freq);
+
+    resample_parts(rs_ref, step, chans, RS_FRAMES, RS_BUF_FRAMES);
+    // The output starts from silence, interpolated into the first frame
+    i = 0;
+    while (i < RS_FRAMES) {
+        Uint64 pos;
+        int p, f;
+
+        pos = (Uint64)i * step;
+        p = (int)(pos >> 16);
+        f = (int)(pos & 0xffff) >> 1;
+        c = 0;
+        while (c < chans) {
+            Sint32 a, b;
+
+            a = (p > 0 && p <= RS_SRC_FRAMES) ? rs_src[(p - 1) * chans + c] : 0;
+            b = (p < RS_SRC_FRAMES) ? rs_src[p * chans + c] : 0;
+            if (rs_ref[i * chans + c] != (Sint16)(a + (((b - a) * f) >> 15))) {
+                GFraMe_log("%i -> %i Hz (%i chans): frame %i wasn't "
+                    "interpolated", src_freq, dst_freq, chans, i);
+                return errors + 1;
+            }
+            c++;
+        }
+        i++;
+    }
+
+    i = 0;
+    while (i < (int)(sizeof(parts) / sizeof(parts[0]))) {
+        int max;
+
+        // Same buffer the player has for such a callback (i.e., 4x as many
+        // frames) and one that's too short
+        max = parts[i] > 0 ? parts[i] * 4 + 2 : RS_BUF_FRAMES;
+        c = 0;
+        while (c < 2) {
+            memset(rs_out, 0x0, sizeof(rs_out));
+            resample_parts(rs_out, step, chans, parts[i], c ? 37 : max);
+            if (memcmp(rs_out, rs_ref, sizeof(Sint16) * RS_FRAMES * chans)
+                != 0) {
+                GFraMe_log("%i -> %i Hz (%i chans): parts of %i frames (and a "
+                    "%i frames buffer) didn't match", src_freq, dst_freq,
+                    chans, parts[i], c ? 37 : max);
+                errors++;
+            }
+            c++;
+        }
+        i++;
+    }
+
+    return errors;
+}
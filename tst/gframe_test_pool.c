@@ -0,0 +1,297 @@
+/**
+ * @file gframe_test_pool.c
+ *
+ * Acquire and release items from a pool in random order, checking that stale
+ * handles are rejected and that the live list stays dense and in sync with
+ * the handles; runs without a window and returns non-zero on failure
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_pool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * How many items fit on the pool
+ */
+#define MAX_ITEMS 64
+/**
+ * How many random operations are checked
+ */
+#define NUM_OPS 5000
+
+/**
+ * Item stored on the pool
+ */
+struct item {
+    /**
+     * Unique value, set when the item was acquired
+     */
+    int id;
+    /**
+     * Some padding, so items are bigger than an int
+     */
+    char data[12];
+};
+
+/**
+ * Handle of every item that's expected to be alive
+ */
+static GFraMe_pool_handle handles[MAX_ITEMS];
+/**
+ * Pointer to every item that's expected to be alive
+ */
+static struct item *items[MAX_ITEMS];
+/**
+ * Value that was stored on every item that's expected to be alive
+ */
+static int ids[MAX_ITEMS];
+/**
+ * How many items are expected to be alive
+ */
+static int num_items;
+/**
+ * Handles that were released (and must be rejected)
+ */
+static GFraMe_pool_handle stale[NUM_OPS];
+/**
+ * How many handles were released
+ */
+static int num_stale;
+
+/**
+ * Check that a released slot, once reacquired, doesn't accept its old handle
+ *
+ * @param pool The pool
+ * @return How many errors were found
+ */
+static int check_reuse(GFraMe_pool *pool);
+
+/**
+ * Check that the live list matches the expected items (i.e., it's dense,
+ * every position maps back to itself and the items didn't move) and that
+ * every released handle is rejected
+ *
+ * @param pool The pool
+ * @param op Index of the last operation
+ * @return How many errors were found
+ */
+static int check_pool(GFraMe_pool *pool, int op);
+
+/**
+ * Release an item, either by its handle or by its position on the live list
+ *
+ * @param pool The pool
+ * @param i Index of the item on the expected items
+ * @param by_pos Whether it should be released by its position
+ * @return How many errors were found
+ */
+static int release_item(GFraMe_pool *pool, int i, int by_pos);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_pool pool;
+    GFraMe_ret rv;
+    int op, errors;
+
+    errors = 0;
+    rv = GFraMe_pool_init(&pool, sizeof(struct item), MAX_ITEMS);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't init the pool", __ret);
+
+    errors += check_reuse(&pool);
+
+    srand(1);
+    op = 0;
+    while (op < NUM_OPS) {
+        int r = rand() % 100;
+
+        if (r < 55) {
+            GFraMe_pool_handle handle;
+            void *item;
+
+            rv = GFraMe_pool_acquire(&pool, &handle, &item);
+            if (num_items == MAX_ITEMS && rv == GFraMe_ret_ok) {
+                GFraMe_log("Op %i: acquired an item from a full pool", op);
+                errors++;
+            }
+            else if (num_items < MAX_ITEMS && rv != GFraMe_ret_ok) {
+                GFraMe_log("Op %i: couldn't acquire an item (%i alive)", op,
+                    num_items);
+                errors++;
+            }
+            else if (rv == GFraMe_ret_ok) {
+                handles[num_items] = handle;
+                items[num_items] = (struct item*)item;
+                items[num_items]->id = op;
+                ids[num_items] = op;
+                num_items++;
+            }
+        }
+        else if (r < 99 && num_items > 0)
+            errors += release_item(&pool, rand() % num_items, r & 1);
+        else if (r == 99) {
+            // Reset the pool, making every handle stale
+            while (num_items > 0) {
+                num_items--;
+                stale[num_stale++] = handles[num_items];
+            }
+            GFraMe_pool_reset(&pool);
+        }
+        errors += check_pool(&pool, op);
+        op++;
+    }
+
+    rv = GFraMe_ret_ok;
+    if (errors == 0)
+        GFraMe_log("Every pool operation matched!");
+    else
+        rv = GFraMe_ret_failed;
+__ret:
+    GFraMe_pool_clear(&pool);
+    return rv;
+}
+
+/**
+ * Check that a released slot, once reacquired, doesn't accept its old handle
+ *
+ * @param pool The pool
+ * @return How many errors were found
+ */
+static int check_reuse(GFraMe_pool *pool) {
+    GFraMe_pool_handle old, cur;
+    void *first, *second;
+    int errors;
+
+    errors = 0;
+    GFraMe_pool_acquire(pool, &old, &first);
+    GFraMe_pool_release(pool, old);
+    // The released slot is the first free one, so it's reused right away
+    GFraMe_pool_acquire(pool, &cur, &second);
+    if (first != second) {
+        GFraMe_log("Reacquiring didn't reuse the released slot");
+        errors++;
+    }
+    if (old == cur) {
+        GFraMe_log("Reacquired slot got the same handle (0x%x)", cur);
+        errors++;
+    }
+    if (GFraMe_pool_get(pool, old) != NULL) {
+        GFraMe_log("Stale handle 0x%x returned an item", old);
+        errors++;
+    }
+    if (GFraMe_pool_release(pool, old) != GFraMe_ret_bad_param) {
+        GFraMe_log("Stale handle 0x%x released an item", old);
+        errors++;
+    }
+    if (pool->len != 1 || GFraMe_pool_get(pool, cur) != second) {
+        GFraMe_log("Releasing a stale handle changed the live item");
+        errors++;
+    }
+    GFraMe_pool_reset(pool);
+
+    return errors;
+}
+
+/**
+ * Check that the live list matches the expected items (i.e., it's dense,
+ * every position maps back to itself and the items didn't move) and that
+ * every released handle is rejected
+ *
+ * @param pool The pool
+ * @param op Index of the last operation
+ * @return How many errors were found
+ */
+static int check_pool(GFraMe_pool *pool, int op) {
+    int i, errors;
+
+    errors = 0;
+    if (pool->len != num_items) {
+        GFraMe_log("Op %i: pool has %i items, expected %i", op, pool->len,
+            num_items);
+        return 1;
+    }
+    i = 0;
+    while (i < num_items) {
+        GFraMe_pool_handle handle;
+        int j;
+
+        // Every position has a live item, found by its handle...
+        handle = GFraMe_pool_handle_at(pool, i);
+        if (GFraMe_pool_get(pool, handle) != GFraMe_pool_at(pool, i)) {
+            GFraMe_log("Op %i: position %i doesn't match its handle", op, i);
+            errors++;
+        }
+        // ...that's one of the expected ones, at the same address
+        j = 0;
+        while (j < num_items && handles[j] != handle)
+            j++;
+        if (j == num_items || items[j] != GFraMe_pool_at(pool, i)
+            || items[j]->id != ids[j]) {
+            GFraMe_log("Op %i: position %i has an unexpected item", op, i);
+            errors++;
+        }
+        i++;
+    }
+    i = 0;
+    while (i < num_stale) {
+        if (GFraMe_pool_get(pool, stale[i]) != NULL) {
+            GFraMe_log("Op %i: stale handle 0x%x returned an item", op,
+                stale[i]);
+            errors++;
+        }
+        i++;
+    }
+
+    return errors;
+}
+
+/**
+ * Release an item, either by its handle or by its position on the live list
+ *
+ * @param pool The pool
+ * @param i Index of the item on the expected items
+ * @param by_pos Whether it should be released by its position
+ * @return How many errors were found
+ */
+static int release_item(GFraMe_pool *pool, int i, int by_pos) {
+    GFraMe_pool_handle last;
+    int pos, errors;
+
+    errors = 0;
+    // Find the item on the live list
+    pos = 0;
+    while (pos < pool->len && GFraMe_pool_handle_at(pool, pos) != handles[i])
+        pos++;
+    if (pos == pool->len) {
+        GFraMe_log("Item 0x%x isn't on the live list", handles[i]);
+        return 1;
+    }
+    last = GFraMe_pool_handle_at(pool, pool->len - 1);
+
+    if (by_pos)
+        GFraMe_pool_release_at(pool, pos);
+    else if (GFraMe_pool_release(pool, handles[i]) != GFraMe_ret_ok) {
+        GFraMe_log("Couldn't release item 0x%x", handles[i]);
+        errors++;
+    }
+    // The last item must have been swapped into the released position
+    if (pos < pool->len && GFraMe_pool_handle_at(pool, pos) != last) {
+        GFraMe_log("Releasing position %i didn't move the last item there",
+            pos);
+        errors++;
+    }
+
+    stale[num_stale++] = handles[i];
+    num_items--;
+    handles[i] = handles[num_items];
+    items[i] = items[num_items];
+    ids[i] = ids[num_items];
+
+    return errors;
+}
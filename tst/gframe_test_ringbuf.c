@@ -0,0 +1,279 @@
+/**
+ * @file gframe_test_ringbuf.c
+ *
+ * Write, read and skip random amounts through a ring (wrapping around its end
+ * and with its counters wrapping around INT_MAX and UINT_MAX), checking every
+ * byte and count against a simple model; runs without a window and returns
+ * non-zero on failure
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_ringbuf.h>
+#include <SDL2/SDL_atomic.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Requested capacity (rounded up to RING_SIZE)
+ */
+#define REQ_SIZE 100
+/**
+ * The ring's actual capacity
+ */
+#define RING_SIZE 128
+/**
+ * How many random operations are checked, for each starting count
+ */
+#define NUM_OPS 20000
+/**
+ * Longest write/read/skip
+ */
+#define MAX_LEN (RING_SIZE + 32)
+/**
+ * How far from INT_MAX/UINT_MAX the counters start (less than the ring's
+ * capacity, so filling it already goes past them)
+ */
+#define START_GAP (RING_SIZE / 2)
+
+/**
+ * Counters the ring starts with; the first ones cross INT_MAX (i.e., become
+ * negative as ints) and the last ones cross UINT_MAX (i.e., back to 0)
+ */
+static unsigned int starts[] = {0, (unsigned int)INT_MAX - START_GAP,
+    UINT_MAX - START_GAP};
+
+/**
+ * Get the byte at some position of the stream
+ *
+ * @param pos Position on the stream
+ * @return The byte
+ */
+static char stream_at(unsigned int pos);
+
+/**
+ * Check the ring's exact cases (partial writes when full, empty reads, etc)
+ *
+ * @param rb The ring
+ * @param start Counter the ring starts with
+ * @return How many errors were found
+ */
+static int check_edges(GFraMe_ringbuf *rb, unsigned int start);
+
+/**
+ * Run random operations through the ring
+ *
+ * @param rb The ring
+ * @param start Counter the ring starts with
+ * @return How many errors were found
+ */
+static int check_random(GFraMe_ringbuf *rb, unsigned int start);
+
+/**
+ * Discard everything on the ring and set both of its counters
+ *
+ * @param rb The ring
+ * @param start Value of both counters
+ */
+static void set_counters(GFraMe_ringbuf *rb, unsigned int start);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_ringbuf rb;
+    GFraMe_ret rv;
+    int i, errors;
+
+    errors = 0;
+    rv = GFraMe_ringbuf_init(&rb, REQ_SIZE);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't init the ring", __ret);
+    if (rb.size != RING_SIZE) {
+        GFraMe_log("Ring has %i bytes, expected %i", rb.size, RING_SIZE);
+        errors++;
+    }
+
+    srand(1);
+    i = 0;
+    while (i < (int)(sizeof(starts) / sizeof(starts[0]))) {
+        errors += check_edges(&rb, starts[i]);
+        errors += check_random(&rb, starts[i]);
+        i++;
+    }
+
+    if (errors == 0)
+        GFraMe_log("Every ring operation matched!");
+    else
+        rv = GFraMe_ret_failed;
+__ret:
+    GFraMe_ringbuf_clear(&rb);
+    return rv;
+}
+
+/**
+ * Get the byte at some position of the stream
+ *
+ * @param pos Position on the stream
+ * @return The byte
+ */
+static char stream_at(unsigned int pos) {
+    return (char)((pos * 131 + (pos >> 8) + 7) & 0xff);
+}
+
+/**
+ * Check the ring's exact cases (partial writes when full, empty reads, etc)
+ *
+ * @param rb The ring
+ * @param start Counter the ring starts with
+ * @return How many errors were found
+ */
+static int check_edges(GFraMe_ringbuf *rb, unsigned int start) {
+    char in[MAX_LEN], out[MAX_LEN];
+    int i, len, errors;
+
+    errors = 0;
+    set_counters(rb, start);
+    i = 0;
+    while (i < MAX_LEN) {
+        in[i] = stream_at((unsigned int)i);
+        i++;
+    }
+
+    // Nothing to read nor skip on an empty ring
+    if (GFraMe_ringbuf_read(rb, out, 1) != 0
+        || GFraMe_ringbuf_skip(rb, 1) != 0) {
+        GFraMe_log("0x%x: consumed from an empty ring", start);
+        errors++;
+    }
+    // Only part of a write fits into a nearly full ring...
+    len = GFraMe_ringbuf_write(rb, in, RING_SIZE - 3);
+    len += GFraMe_ringbuf_write(rb, in + len, 10);
+    if (len != RING_SIZE || GFraMe_ringbuf_get_free(rb) != 0) {
+        GFraMe_log("0x%x: wrote %i bytes, expected %i", start, len,
+            RING_SIZE);
+        errors++;
+    }
+    // ...and nothing fits into a full one
+    if (GFraMe_ringbuf_write(rb, in, 1) != 0) {
+        GFraMe_log("0x%x: wrote into a full ring", start);
+        errors++;
+    }
+    // Skipping more than there is only skips what's there
+    if (GFraMe_ringbuf_skip(rb, 5) != 5
+        || GFraMe_ringbuf_read(rb, out, MAX_LEN) != RING_SIZE - 5
+        || memcmp(out, in + 5, RING_SIZE - 5) != 0) {
+        GFraMe_log("0x%x: read wrong data after a skip", start);
+        errors++;
+    }
+    if (GFraMe_ringbuf_write(rb, in, 7) != 7
+        || GFraMe_ringbuf_skip(rb, MAX_LEN) != 7
+        || GFraMe_ringbuf_get_used(rb) != 0) {
+        GFraMe_log("0x%x: skipped the wrong amount", start);
+        errors++;
+    }
+
+    return errors;
+}
+
+/**
+ * Run random operations through the ring
+ *
+ * @param rb The ring
+ * @param start Counter the ring starts with
+ * @return How many errors were found
+ */
+static int check_random(GFraMe_ringbuf *rb, unsigned int start) {
+    char buf[MAX_LEN];
+    unsigned int written, consumed;
+    int op, errors;
+
+    errors = 0;
+    set_counters(rb, start);
+    written = start;
+    consumed = start;
+    op = 0;
+    while (op < NUM_OPS) {
+        int i, len, exp, got;
+
+        len = rand() % (MAX_LEN + 1);
+        switch (rand() % 3) {
+            case 0: {
+                // Write the next part of the stream
+                exp = RING_SIZE - (int)(written - consumed);
+                if (exp > len)
+                    exp = len;
+                i = 0;
+                while (i < len) {
+                    buf[i] = stream_at(written + (unsigned int)i);
+                    i++;
+                }
+                got = GFraMe_ringbuf_write(rb, buf, len);
+                written += (unsigned int)(got > 0 ? got : 0);
+            } break;
+            case 1: {
+                // Read and check it
+                exp = (int)(written - consumed);
+                if (exp > len)
+                    exp = len;
+                got = GFraMe_ringbuf_read(rb, buf, len);
+                i = 0;
+                while (got == exp && i < got) {
+                    if (buf[i] != stream_at(consumed + (unsigned int)i)) {
+                        GFraMe_log("0x%x: op %i read a wrong byte at %i",
+                            start, op, i);
+                        errors++;
+                        break;
+                    }
+                    i++;
+                }
+                consumed += (unsigned int)(got > 0 ? got : 0);
+            } break;
+            default: {
+                exp = (int)(written - consumed);
+                if (exp > len)
+                    exp = len;
+                got = GFraMe_ringbuf_skip(rb, len);
+                consumed += (unsigned int)(got > 0 ? got : 0);
+            }
+        }
+        if (got != exp) {
+            GFraMe_log("0x%x: op %i moved %i bytes, expected %i", start, op,
+                got, exp);
+            return errors + 1;
+        }
+        if (GFraMe_ringbuf_get_used(rb) != (int)(written - consumed)
+            || GFraMe_ringbuf_get_free(rb) != RING_SIZE
+                - (int)(written - consumed)) {
+            GFraMe_log("0x%x: op %i has %i bytes used, expected %i", start,
+                op, GFraMe_ringbuf_get_used(rb), (int)(written - consumed));
+            return errors + 1;
+        }
+        op++;
+    }
+    // Make sure the counters actually went past INT_MAX/UINT_MAX
+    if (start != 0 && written - start <= START_GAP) {
+        GFraMe_log("0x%x: counters stopped at 0x%x", start,
+            written);
+        errors++;
+    }
+
+    return errors;
+}
+
+/**
+ * Discard everything on the ring and set both of its counters
+ *
+ * @param rb The ring
+ * @param start Value of both counters
+ */
+static void set_counters(GFraMe_ringbuf *rb, unsigned int start) {
+    GFraMe_ringbuf_reset(rb);
+    // Counters only ever increase, so skipping ahead is the same as having
+    // gone through that many bytes
+    SDL_AtomicSet(&rb->head, (int)start);
+    SDL_AtomicSet(&rb->tail, (int)start);
+}
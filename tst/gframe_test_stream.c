@@ -0,0 +1,408 @@
+/**
+ * @file gframe_test_stream.c
+ *
+ * Restart a streamed audio while its I/O thread is still filling the ring and
+ * check that it always plays again from its start (instead of going silent).
+ * The I/O thread is held inside a file read, so the restart always happens
+ * mid fill; writes its audio into assets/, runs without a window and returns
+ * non-zero on failure
+ */
+#include <GFraMe/GFraMe_audio_stream.h>
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_ringbuf.h>
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_rwops.h>
+#include <SDL2/SDL_timer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#if defined(_WIN32)
+#  include <direct.h>
+#endif
+
+/**
+ * Audio's name (as passed to GFraMe_audio_stream_init)
+ */
+#define AUDIO_NAME "gframe_test_stream"
+/**
+ * Where the audio is written (i.e., where the assets' functions look for it)
+ */
+#define AUDIO_FILE "assets/" AUDIO_NAME ".dat"
+/**
+ * How many (mono) samples there are; a few times the ring's size
+ */
+#define NUM_SAMPLES (GFraMe_audio_stream_ring_size * 2)
+/**
+ * How many times the stream is restarted
+ */
+#define NUM_RESTARTS 20
+/**
+ * How many bytes are consumed before each restart (so the I/O thread has
+ * plenty to refill)
+ */
+#define READ_LEN (GFraMe_audio_stream_ring_size / 2)
+/**
+ * How many samples are checked after each restart
+ */
+#define CHECK_LEN 2048
+/**
+ * For how long (in milliseconds) the I/O thread may take to refill the ring
+ */
+#define TIMEOUT_MS 1000
+
+/**
+ * Where the stream is read into
+ */
+static Sint16 buf[READ_LEN / 2];
+/**
+ * Whether the next read from the file should wait for the test
+ */
+static SDL_atomic_t hold;
+/**
+ * Posted by the I/O thread, once it's waiting inside a read
+ */
+static SDL_sem *held;
+/**
+ * Posted by the test, to let the I/O thread read
+ */
+static SDL_sem *resume;
+
+/**
+ * Get the value of a sample on the audio
+ *
+ * @param i Index of the sample
+ * @return Its value
+ */
+static Sint16 sample_at(int i);
+
+/**
+ * Write the audio into the assets' directory
+ *
+ * @return GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret write_audio();
+
+/**
+ * Wrap the stream's file, so its reads may be held
+ *
+ * @param st The stream
+ * @return GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret wrap_file(GFraMe_audio_stream *st);
+
+/**
+ * Get the wrapped file's size
+ *
+ * @param ctx The wrapper
+ * @return The size
+ */
+static Sint64 SDLCALL file_size(SDL_RWops *ctx);
+
+/**
+ * Seek the wrapped file
+ *
+ * @param ctx The wrapper
+ * @param offset Where to seek to
+ * @param whence From where the offset is counted
+ * @return The new position
+ */
+static Sint64 SDLCALL file_seek(SDL_RWops *ctx, Sint64 offset, int whence);
+
+/**
+ * Read the wrapped file, waiting for the test if it's holding reads
+ *
+ * @param ctx The wrapper
+ * @param ptr Where it should be read into
+ * @param size Size of each object
+ * @param num How many objects should be read
+ * @return How many objects were read
+ */
+static size_t SDLCALL file_read(SDL_RWops *ctx, void *ptr, size_t size,
+    size_t num);
+
+/**
+ * Writing isn't supported
+ *
+ * @param ctx The wrapper
+ * @param ptr What should be written
+ * @param size Size of each object
+ * @param num How many objects should be written
+ * @return Always 0
+ */
+static size_t SDLCALL file_write(SDL_RWops *ctx, const void *ptr, size_t size,
+    size_t num);
+
+/**
+ * Close the wrapped file and release the wrapper
+ *
+ * @param ctx The wrapper
+ * @return 0 - Success; Anything else - Failure
+ */
+static int SDLCALL file_close(SDL_RWops *ctx);
+
+/**
+ * Restart the stream while it's being filled and check that it goes back to
+ * its first sample
+ *
+ * @param st The stream
+ * @param num Index of the restart
+ * @return How many errors were found
+ */
+static int check_restart(GFraMe_audio_stream *st, int num);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_audio_stream st;
+    GFraMe_ret rv;
+    int i, errors, did_init;
+
+    errors = 0;
+    did_init = 0;
+    SDL_AtomicSet(&hold, 0);
+    held = SDL_CreateSemaphore(0);
+    resume = SDL_CreateSemaphore(0);
+    GFraMe_assertRV(held && resume, "Couldn't create the semaphores",
+        rv = GFraMe_ret_failed, __ret);
+    rv = write_audio();
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't write the audio", __ret);
+    rv = GFraMe_audio_stream_init(&st, AUDIO_NAME, 1, 0, 0);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't open the stream", __ret);
+    did_init = 1;
+    // The stream was just filled and nothing was read, so its I/O thread
+    // won't touch it until the first read
+    rv = wrap_file(&st);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't wrap the file", __ret);
+
+    // Stop on the first error, since a silent stream stays silent
+    i = 0;
+    while (i < NUM_RESTARTS && errors == 0) {
+        errors += check_restart(&st, i);
+        i++;
+    }
+
+    if (errors == 0)
+        GFraMe_log("Every restart played from the start!");
+    else
+        rv = GFraMe_ret_failed;
+__ret:
+    if (did_init)
+        GFraMe_audio_stream_clear(&st);
+    if (held)
+        SDL_DestroySemaphore(held);
+    if (resume)
+        SDL_DestroySemaphore(resume);
+    remove(AUDIO_FILE);
+    return rv;
+}
+
+/**
+ * Get the value of a sample on the audio
+ *
+ * @param i Index of the sample
+ * @return Its value
+ */
+static Sint16 sample_at(int i) {
+    // Never 0, so silence is told apart from actual samples
+    return (Sint16)(i % 30000 + 1);
+}
+
+/**
+ * Write the audio into the assets' directory
+ *
+ * @return GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret write_audio() {
+    GFraMe_ret rv;
+    SDL_RWops *fp;
+    int i;
+
+    // Ignore the error, as it usually already exists
+#if defined(_WIN32)
+    _mkdir("assets");
+#else
+    mkdir("assets", 0755);
+#endif
+    // Raw 44100 Hz samples (i.e., without a header)
+    fp = SDL_RWFromFile(AUDIO_FILE, "wb");
+    GFraMe_assertRV(fp, "Couldn't create " AUDIO_FILE,
+        rv = GFraMe_ret_failed, __ret);
+    i = 0;
+    while (i < NUM_SAMPLES) {
+        Sint16 s = sample_at(i);
+
+        // Samples are little endian on the file
+        GFraMe_assertRV(SDL_WriteLE16(fp, (Uint16)s) == 1,
+            "Couldn't write the audio", rv = GFraMe_ret_failed, __ret);
+        i++;
+    }
+    rv = GFraMe_ret_ok;
+__ret:
+    if (fp && SDL_RWclose(fp) != 0)
+        rv = GFraMe_ret_failed;
+    return rv;
+}
+
+/**
+ * Restart the stream while it's being filled and check that it goes back to
+ * its first sample
+ *
+ * @param st The stream
+ * @param num Index of the restart
+ * @return How many errors were found
+ */
+static int check_restart(GFraMe_audio_stream *st, int num) {
+    Uint32 time;
+    int i, len;
+
+    // Consume a lot, holding the I/O thread as soon as it starts refilling...
+    SDL_AtomicSet(&hold, 1);
+    time = SDL_GetTicks();
+    len = 0;
+    while (len < READ_LEN && SDL_GetTicks() - time < TIMEOUT_MS)
+        len += GFraMe_audio_stream_read(st, (char*)buf + len, READ_LEN - len);
+    if (len < READ_LEN) {
+        GFraMe_log("Restart %i: only read %i bytes", num, len);
+        return 1;
+    }
+    if (SDL_SemWaitTimeout(held, TIMEOUT_MS) != 0) {
+        GFraMe_log("Restart %i: the ring was never refilled", num);
+        // Don't leave the I/O thread stuck, if it only got there now
+        if (!SDL_AtomicCAS(&hold, 1, 0)) {
+            SDL_SemWait(held);
+            SDL_SemPost(resume);
+        }
+        return 1;
+    }
+    // ...so the stream is restarted while the old samples are still being
+    // written (and they fill the ring before the rewind is handled)
+    GFraMe_audio_stream_restart(st);
+    SDL_SemPost(resume);
+
+    // Nothing may be read until the rewind is handled, but it must not take
+    // long (nor ever go silent)
+    time = SDL_GetTicks();
+    len = 0;
+    while (len < CHECK_LEN * 2 && SDL_GetTicks() - time < TIMEOUT_MS) {
+        i = GFraMe_audio_stream_read(st, (char*)buf + len,
+            CHECK_LEN * 2 - len);
+        if (i == 0)
+            SDL_Delay(1);
+        len += i;
+    }
+    if (len < CHECK_LEN * 2) {
+        GFraMe_log("Restart %i: stream went silent", num);
+        return 1;
+    }
+    i = 0;
+    while (i < CHECK_LEN) {
+        if (buf[i] != sample_at(i)) {
+            GFraMe_log("Restart %i: sample %i is %i, expected %i", num, i,
+                buf[i], sample_at(i));
+            return 1;
+        }
+        i++;
+    }
+
+    return 0;
+}
+
+/**
+ * Wrap the stream's file, so its reads may be held
+ *
+ * @param st The stream
+ * @return GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret wrap_file(GFraMe_audio_stream *st) {
+    GFraMe_ret rv;
+    SDL_RWops *rw;
+
+    rw = SDL_AllocRW();
+    GFraMe_assertRV(rw, "Couldn't alloc the wrapper",
+        rv = GFraMe_ret_memory_error, __ret);
+    rw->size = file_size;
+    rw->seek = file_seek;
+    rw->read = file_read;
+    rw->write = file_write;
+    rw->close = file_close;
+    rw->hidden.unknown.data1 = st->fp;
+    st->fp = rw;
+    rv = GFraMe_ret_ok;
+__ret:
+    return rv;
+}
+
+/**
+ * Get the wrapped file's size
+ *
+ * @param ctx The wrapper
+ * @return The size
+ */
+static Sint64 SDLCALL file_size(SDL_RWops *ctx) {
+    return SDL_RWsize((SDL_RWops*)ctx->hidden.unknown.data1);
+}
+
+/**
+ * Seek the wrapped file
+ *
+ * @param ctx The wrapper
+ * @param offset Where to seek to
+ * @param whence From where the offset is counted
+ * @return The new position
+ */
+static Sint64 SDLCALL file_seek(SDL_RWops *ctx, Sint64 offset, int whence) {
+    return SDL_RWseek((SDL_RWops*)ctx->hidden.unknown.data1, offset, whence);
+}
+
+/**
+ * Read the wrapped file, waiting for the test if it's holding reads
+ *
+ * @param ctx The wrapper
+ * @param ptr Where it should be read into
+ * @param size Size of each object
+ * @param num How many objects should be read
+ * @return How many objects were read
+ */
+static size_t SDLCALL file_read(SDL_RWops *ctx, void *ptr, size_t size,
+    size_t num) {
+    if (SDL_AtomicCAS(&hold, 1, 0)) {
+        SDL_SemPost(held);
+        SDL_SemWait(resume);
+    }
+    return SDL_RWread((SDL_RWops*)ctx->hidden.unknown.data1, ptr, size, num);
+}
+
+/**
+ * Writing isn't supported
+ *
+ * @param ctx The wrapper
+ * @param ptr What should be written
+ * @param size Size of each object
+ * @param num How many objects should be written
+ * @return Always 0
+ */
+static size_t SDLCALL file_write(SDL_RWops *ctx, const void *ptr, size_t size,
+    size_t num) {
+    return 0;
+}
+
+/**
+ * Close the wrapped file and release the wrapper
+ *
+ * @param ctx The wrapper
+ * @return 0 - Success; Anything else - Failure
+ */
+static int SDLCALL file_close(SDL_RWops *ctx) {
+    int rv;
+
+    rv = SDL_RWclose((SDL_RWops*)ctx->hidden.unknown.data1);
+    SDL_FreeRW(ctx);
+    return rv;
+}
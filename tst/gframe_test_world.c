@@ -0,0 +1,363 @@
+/**
+ * @file gframe_test_world.c
+ *
+ * Step the same crowd scene on a single thread and split across workers, and
+ * check that every step gives bit-identical objects and contact events; runs
+ * without a window and returns non-zero on failure
+ */
+#include <GFraMe/GFraMe_error.h>
+#include <GFraMe/GFraMe_hitbox.h>
+#include <GFraMe/GFraMe_log.h>
+#include <GFraMe/GFraMe_object.h>
+#include <GFraMe/GFraMe_workers.h>
+#include <GFraMe/GFraMe_world.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * How many objects are moving around (enough for every job to be split)
+ */
+#define NUM_CROWD 1200
+/**
+ * How many walls surround the crowd
+ */
+#define NUM_WALLS 4
+/**
+ * Every object on the scene
+ */
+#define NUM_OBJS (NUM_CROWD + NUM_WALLS)
+/**
+ * How many steps are compared
+ */
+#define NUM_STEPS 180
+/**
+ * How long each step takes, in milliseconds
+ */
+#define STEP_MS 16
+/**
+ * How many threads are spawned for the second run
+ */
+#define NUM_WORKERS 3
+/**
+ * World's (and the walls' inner area) dimensions
+ */
+#define WORLD_W 320
+#define WORLD_H 240
+/**
+ * Walls' thickness
+ */
+#define WALL_W 16
+/**
+ * Cells' dimensions (small enough that the cells are split between workers)
+ */
+#define CELL_W 8
+/**
+ * Layers (i.e., bits on the objects' categories)
+ */
+#define LAYER_WALL 0
+#define LAYER_CROWD 1
+
+/**
+ * Every object; both runs use the same buffer, so the events' pointers match
+ */
+static GFraMe_object objs[NUM_OBJS];
+/**
+ * Positions and velocities (dx, dy, vx, vy) of every object, on every step
+ */
+static double *states;
+/**
+ * Collided directions of every object, on every step
+ */
+static GFraMe_direction *hits;
+/**
+ * Contact events reported on every step, one step after the other
+ */
+static GFraMe_world_event *events;
+/**
+ * Index of each step's first event (with an extra entry at the end)
+ */
+static int events_start[NUM_STEPS + 1];
+/**
+ * How many events fit on the events' buffer
+ */
+static int max_events;
+
+/**
+ * Build the scene and step it through every step
+ *
+ * @param record Whether the results should be stored (otherwise, they are
+ *               compared against the stored ones)
+ * @param errors How many mismatches were found
+ * @return GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret run_scene(int record, int *errors);
+
+/**
+ * Place the walls and the crowd (always at the same positions)
+ */
+static void init_objs();
+
+/**
+ * Store a step's results
+ *
+ * @param world The world
+ * @param step Index of the step
+ * @return GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret store_step(GFraMe_world *world, int step);
+
+/**
+ * Compare a step's results against the stored ones
+ *
+ * @param world The world
+ * @param step Index of the step
+ * @return How many errors were found
+ */
+static int check_step(GFraMe_world *world, int step);
+
+/**
+ * Main function.
+ *
+ * @param argc Number of arguments
+ * @param argv The actual arguments
+ * @return Error code
+ */
+int main (int argc, char *argv[]) {
+    GFraMe_ret rv;
+    int errors;
+
+    errors = 0;
+    states = (double*)malloc(sizeof(double) * NUM_STEPS * NUM_OBJS * 4);
+    GFraMe_assertRV(states, "Couldn't alloc memory",
+        rv = GFraMe_ret_memory_error, __ret);
+    hits = (GFraMe_direction*)malloc(sizeof(GFraMe_direction) * NUM_STEPS
+        * NUM_OBJS);
+    GFraMe_assertRV(hits, "Couldn't alloc memory",
+        rv = GFraMe_ret_memory_error, __ret);
+
+    // Run it on the calling thread only
+    rv = run_scene(1, &errors);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Single threaded run failed",
+        __ret);
+
+    // Run it again, split across the workers
+    rv = GFraMe_workers_init(NUM_WORKERS);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't spawn the workers",
+        __ret);
+    rv = run_scene(0, &errors);
+    GFraMe_workers_clear();
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Multi threaded run failed",
+        __ret);
+
+    if (errors == 0)
+        GFraMe_log("Every step matched (%i events)!",
+            events_start[NUM_STEPS]);
+    else
+        rv = GFraMe_ret_failed;
+__ret:
+    if (states)
+        free(states);
+    if (hits)
+        free(hits);
+    if (events)
+        free(events);
+    return rv;
+}
+
+/**
+ * Build the scene and step it through every step
+ *
+ * @param record Whether the results should be stored (otherwise, they are
+ *               compared against the stored ones)
+ * @param errors How many mismatches were found
+ * @return GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret run_scene(int record, int *errors) {
+    GFraMe_ret rv;
+    GFraMe_world world;
+    int i, step;
+
+    memset(&world, 0x0, sizeof(GFraMe_world));
+    init_objs();
+    rv = GFraMe_world_init(&world, -WALL_W, -WALL_W, WORLD_W + 2 * WALL_W,
+        WORLD_H + 2 * WALL_W, CELL_W, CELL_W);
+    GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't init the world", __ret);
+    GFraMe_world_set_response(&world, LAYER_CROWD, LAYER_CROWD,
+        GFraMe_collision_full);
+    GFraMe_world_set_response(&world, LAYER_CROWD, LAYER_WALL,
+        GFraMe_second_fixed);
+    i = 0;
+    while (i < NUM_OBJS) {
+        rv = GFraMe_world_add(&world, &objs[i]);
+        GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't add an object",
+            __ret);
+        i++;
+    }
+
+    step = 0;
+    while (step < NUM_STEPS) {
+        rv = GFraMe_world_update(&world, STEP_MS);
+        GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't update the world",
+            __ret);
+        if (record) {
+            rv = store_step(&world, step);
+            GFraMe_assertRet(rv == GFraMe_ret_ok, "Couldn't store the step",
+                __ret);
+        }
+        else
+            *errors += check_step(&world, step);
+        step++;
+    }
+
+    rv = GFraMe_ret_ok;
+__ret:
+    GFraMe_world_clear(&world);
+    return rv;
+}
+
+/**
+ * Place the walls and the crowd (always at the same positions)
+ */
+static void init_objs() {
+    int i;
+
+    // Top, bottom, left and right walls
+    i = 0;
+    while (i < NUM_WALLS) {
+        GFraMe_object *wall;
+        int x, y, w, h;
+
+        wall = &objs[NUM_CROWD + i];
+        x = (i == 3)? WORLD_W : -WALL_W;
+        y = (i == 1)? WORLD_H : -WALL_W;
+        w = (i < 2)? WORLD_W + 2 * WALL_W : WALL_W;
+        h = (i < 2)? WALL_W : WORLD_H + 2 * WALL_W;
+        GFraMe_object_clear(wall);
+        GFraMe_object_set_pos(wall, x, y);
+        GFraMe_hitbox_set(GFraMe_object_get_hitbox(wall),
+            GFraMe_hitbox_upper_left, 0, 0, w, h);
+        GFraMe_object_set_layer(wall, 1 << LAYER_WALL, 1 << LAYER_CROWD);
+        GFraMe_object_set_static(wall, 1);
+        i++;
+    }
+
+    // A dense crowd, running in every direction
+    srand(1);
+    i = 0;
+    while (i < NUM_CROWD) {
+        GFraMe_object *obj;
+
+        obj = &objs[i];
+        GFraMe_object_clear(obj);
+        GFraMe_object_set_pos(obj, rand() % (WORLD_W - 4),
+            rand() % (WORLD_H - 4));
+        GFraMe_hitbox_set(GFraMe_object_get_hitbox(obj),
+            GFraMe_hitbox_upper_left, 0, 0, 4, 4);
+        GFraMe_object_set_layer(obj, 1 << LAYER_CROWD,
+            (1 << LAYER_CROWD) | (1 << LAYER_WALL));
+        obj->vx = (double)(rand() % 121 - 60);
+        obj->vy = (double)(rand() % 121 - 60);
+        i++;
+    }
+}
+
+/**
+ * Store a step's results
+ *
+ * @param world The world
+ * @param step Index of the step
+ * @return GFraMe_ret_ok - Success; Anything else - Failure
+ */
+static GFraMe_ret store_step(GFraMe_world *world, int step) {
+    GFraMe_ret rv;
+    double *state;
+    int i;
+
+    state = states + step * NUM_OBJS * 4;
+    i = 0;
+    while (i < NUM_OBJS) {
+        state[i * 4] = objs[i].dx;
+        state[i * 4 + 1] = objs[i].dy;
+        state[i * 4 + 2] = objs[i].vx;
+        state[i * 4 + 3] = objs[i].vy;
+        hits[step * NUM_OBJS + i] = objs[i].hit;
+        i++;
+    }
+
+    // Expand the events' buffer, if needed
+    if (events_start[step] + world->num_events > max_events) {
+        GFraMe_world_event *tmp;
+        int len;
+
+        len = max_events * 2;
+        if (len < events_start[step] + world->num_events)
+            len = events_start[step] + world->num_events;
+        tmp = (GFraMe_world_event*)realloc(events,
+            sizeof(GFraMe_world_event) * len);
+        GFraMe_assertRV(tmp, "Couldn't alloc memory",
+            rv = GFraMe_ret_memory_error, __ret);
+        events = tmp;
+        max_events = len;
+    }
+    i = 0;
+    while (i < world->num_events) {
+        events[events_start[step] + i] = world->events[i];
+        i++;
+    }
+    events_start[step + 1] = events_start[step] + world->num_events;
+
+    rv = GFraMe_ret_ok;
+__ret:
+    return rv;
+}
+
+/**
+ * Compare a step's results against the stored ones
+ *
+ * @param world The world
+ * @param step Index of the step
+ * @return How many errors were found
+ */
+static int check_step(GFraMe_world *world, int step) {
+    GFraMe_world_event *ev;
+    double *state;
+    int i, num, errors;
+
+    errors = 0;
+    state = states + step * NUM_OBJS * 4;
+    i = 0;
+    while (i < NUM_OBJS) {
+        // Compare the actual bits (so even -0.0 and 0.0 differ)
+        if (memcmp(&state[i * 4], &objs[i].dx, sizeof(double)) != 0
+            || memcmp(&state[i * 4 + 1], &objs[i].dy, sizeof(double)) != 0
+            || memcmp(&state[i * 4 + 2], &objs[i].vx, sizeof(double)) != 0
+            || memcmp(&state[i * 4 + 3], &objs[i].vy, sizeof(double)) != 0
+            || memcmp(&hits[step * NUM_OBJS + i], &objs[i].hit,
+                sizeof(GFraMe_direction)) != 0) {
+            GFraMe_log("Step %i: object %i didn't match", step, i);
+            errors++;
+        }
+        i++;
+    }
+
+    num = events_start[step + 1] - events_start[step];
+    if (world->num_events != num) {
+        GFraMe_log("Step %i: got %i events, expected %i", step,
+            world->num_events, num);
+        return errors + 1;
+    }
+    // Events are compared field by field, since their padding isn't set
+    ev = events + events_start[step];
+    i = 0;
+    while (i < num) {
+        if (memcmp(&ev[i].o1, &world->events[i].o1, sizeof(void*)) != 0
+            || memcmp(&ev[i].o2, &world->events[i].o2, sizeof(void*)) != 0
+            || ev[i].type != world->events[i].type) {
+            GFraMe_log("Step %i: event %i didn't match", step, i);
+            errors++;
+        }
+        i++;
+    }
+
+    return errors;
+}